@@ -71,6 +71,7 @@ uint8_t max30105_fifo_init(void (*fifo_receive_callback)(uint8_t type))
     uint8_t res;
     uint8_t threshold;
     max30105_bool_t enable;
+    max30105_config_t config;
     
     /* link interface function */
     DRIVER_MAX30105_LINK_INIT(&gs_handle, max30105_handle_t);
@@ -78,6 +79,7 @@ uint8_t max30105_fifo_init(void (*fifo_receive_callback)(uint8_t type))
     DRIVER_MAX30105_LINK_IIC_DEINIT(&gs_handle, max30105_interface_iic_deinit);
     DRIVER_MAX30105_LINK_IIC_READ(&gs_handle, max30105_interface_iic_read);
     DRIVER_MAX30105_LINK_IIC_WRITE(&gs_handle, max30105_interface_iic_write);
+    DRIVER_MAX30105_LINK_IIC_TRANSFER(&gs_handle, max30105_interface_iic_transfer);
     DRIVER_MAX30105_LINK_DELAY_MS(&gs_handle, max30105_interface_delay_ms);
     DRIVER_MAX30105_LINK_DEBUG_PRINT(&gs_handle, max30105_interface_debug_print);
     DRIVER_MAX30105_LINK_RECEIVE_CALLBACK(&gs_handle, fifo_receive_callback);
@@ -91,126 +93,6 @@ uint8_t max30105_fifo_init(void (*fifo_receive_callback)(uint8_t type))
         return 1;
     }
     
-    /* enable shutdown */
-    res = max30105_set_shutdown(&gs_handle, MAX30105_BOOL_TRUE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set shutdown failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set fifo sample averaging */
-    res = max30105_set_fifo_sample_averaging(&gs_handle, MAX30105_FIFO_DEFAULT_SAMPLE_AVERAGING);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set fifo sample averaging failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set fifo roll */
-    res = max30105_set_fifo_roll(&gs_handle, MAX30105_FIFO_DEFAULT_FIFO_ROLL);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set fifo almost full */
-    res = max30105_set_fifo_almost_full(&gs_handle, MAX30105_FIFO_DEFAULT_FIFO_ALMOST_FULL);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set fifo almost full failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set mode */
-    res = max30105_set_mode(&gs_handle, MAX30105_FIFO_DEFAULT_MODE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set mode failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set particle sensing adc range */
-    res = max30105_set_particle_sensing_adc_range(&gs_handle, MAX30105_FIFO_DEFAULT_PARTICLE_SENSING_ADC_RANGE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set particle sensing adc range failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set particle sensing sample rate */
-    res = max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_FIFO_DEFAULT_PARTICLE_SENSING_SAMPLE_RATE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set particle sensing sample rate failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set adc resolution */
-    res = max30105_set_adc_resolution(&gs_handle, MAX30105_FIFO_DEFAULT_ADC_RESOLUTION);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set adc resolution failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set led red pulse amplitude */
-    res = max30105_set_led_red_pulse_amplitude(&gs_handle, MAX30105_FIFO_DEFAULT_LED_RED_PULSE_AMPLITUDE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set led red pulse amplitude failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set led ir pulse amplitude */
-    res = max30105_set_led_ir_pulse_amplitude(&gs_handle, MAX30105_FIFO_DEFAULT_LED_IR_PULSE_AMPLITUDE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set led ir pulse amplitude failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set led green pulse amplitude */
-    res = max30105_set_led_green_pulse_amplitude(&gs_handle, MAX30105_FIFO_DEFAULT_LED_GREEN_PULSE_AMPLITUDE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set led green pulse amplitude failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set led proximity pulse amplitude */
-    res = max30105_set_led_proximity_pulse_amplitude(&gs_handle, MAX30105_FIFO_DEFAULT_LED_PROXIMITY_PULSE_AMPLITUDE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set led proximity pulse amplitude failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
     /* convert the adc */
     res = max30105_proximity_threshold_convert_to_register(&gs_handle, MAX30105_FIFO_DEFAULT_PROXIMITY_THRESHOLD, (uint8_t *)&threshold);
     if (res != 0)
@@ -221,51 +103,35 @@ uint8_t max30105_fifo_init(void (*fifo_receive_callback)(uint8_t type))
         return 1;
     }
     
-    /* set proximity interrupt threshold */
-    res = max30105_set_proximity_interrupt_threshold(&gs_handle, threshold);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set proximity interrupt threshold failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set slot */
-    res = max30105_set_slot(&gs_handle, MAX30105_SLOT_1, MAX30105_FIFO_DEFAULT_SLOT1);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set slot failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
+    /* set the config */
+    config.interrupt_fifo_full = MAX30105_BOOL_TRUE;
+    config.interrupt_data_rdy = MAX30105_FIFO_DEFAULT_INTERRUPT_DATA_RDY_EN;
+    config.interrupt_alc_ovf = MAX30105_FIFO_DEFAULT_INTERRUPT_ALC_OVF_EN;
+    config.interrupt_prox_int = MAX30105_BOOL_TRUE;
+    config.interrupt_die_temp_rdy = MAX30105_FIFO_DEFAULT_INTERRUPT_DIE_TEMP_RDY_EN;
+    config.sample_averaging = MAX30105_FIFO_DEFAULT_SAMPLE_AVERAGING;
+    config.fifo_roll = MAX30105_FIFO_DEFAULT_FIFO_ROLL;
+    config.fifo_almost_full = MAX30105_FIFO_DEFAULT_FIFO_ALMOST_FULL;
+    config.shutdown = MAX30105_BOOL_FALSE;
+    config.mode = MAX30105_FIFO_DEFAULT_MODE;
+    config.adc_range = MAX30105_FIFO_DEFAULT_PARTICLE_SENSING_ADC_RANGE;
+    config.sample_rate = MAX30105_FIFO_DEFAULT_PARTICLE_SENSING_SAMPLE_RATE;
+    config.adc_resolution = MAX30105_FIFO_DEFAULT_ADC_RESOLUTION;
+    config.led_red_pulse_amplitude = MAX30105_FIFO_DEFAULT_LED_RED_PULSE_AMPLITUDE;
+    config.led_ir_pulse_amplitude = MAX30105_FIFO_DEFAULT_LED_IR_PULSE_AMPLITUDE;
+    config.led_green_pulse_amplitude = MAX30105_FIFO_DEFAULT_LED_GREEN_PULSE_AMPLITUDE;
+    config.led_proximity_pulse_amplitude = MAX30105_FIFO_DEFAULT_LED_PROXIMITY_PULSE_AMPLITUDE;
+    config.slot[0] = MAX30105_FIFO_DEFAULT_SLOT1;
+    config.slot[1] = MAX30105_FIFO_DEFAULT_SLOT2;
+    config.slot[2] = MAX30105_FIFO_DEFAULT_SLOT3;
+    config.slot[3] = MAX30105_FIFO_DEFAULT_SLOT4;
+    config.proximity_threshold = threshold;
     
-    /* set slot */
-    res = max30105_set_slot(&gs_handle, MAX30105_SLOT_2, MAX30105_FIFO_DEFAULT_SLOT2);
+    /* apply the config */
+    res = max30105_apply_config(&gs_handle, &config);
     if (res != 0)
     {
-        max30105_interface_debug_print("max30105: set slot failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set slot */
-    res = max30105_set_slot(&gs_handle, MAX30105_SLOT_3, MAX30105_FIFO_DEFAULT_SLOT3);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set slot failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set slot */
-    res = max30105_set_slot(&gs_handle, MAX30105_SLOT_4, MAX30105_FIFO_DEFAULT_SLOT4);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set slot failed.\n");
+        max30105_interface_debug_print("max30105: apply config failed.\n");
         (void)max30105_deinit(&gs_handle);
        
         return 1;
@@ -281,61 +147,11 @@ uint8_t max30105_fifo_init(void (*fifo_receive_callback)(uint8_t type))
         return 1;
     }
     
-    /* set interrupt */
-    res = max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_FIFO_FULL_EN, MAX30105_BOOL_TRUE);
+    /* set watermark control */
+    res = max30105_set_watermark_control(&gs_handle, MAX30105_FIFO_DEFAULT_WATERMARK_CONTROL, MAX30105_FIFO_DEFAULT_WATERMARK_MARGIN);
     if (res != 0)
     {
-        max30105_interface_debug_print("max30105: set interrupt failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set interrupt */
-    res = max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_DATA_RDY_EN, MAX30105_FIFO_DEFAULT_INTERRUPT_DATA_RDY_EN);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set interrupt failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set interrupt */
-    res = max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_ALC_OVF_EN, MAX30105_FIFO_DEFAULT_INTERRUPT_ALC_OVF_EN);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set interrupt failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set interrupt */
-    res = max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_PROX_INT_EN, MAX30105_BOOL_TRUE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set interrupt failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* set interrupt */
-    res = max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_DIE_TEMP_RDY_EN, MAX30105_FIFO_DEFAULT_INTERRUPT_DIE_TEMP_RDY_EN);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set interrupt failed.\n");
-        (void)max30105_deinit(&gs_handle);
-       
-        return 1;
-    }
-    
-    /* disable shutdown */
-    res = max30105_set_shutdown(&gs_handle, MAX30105_BOOL_FALSE);
-    if (res != 0)
-    {
-        max30105_interface_debug_print("max30105: set shutdown failed.\n");
+        max30105_interface_debug_print("max30105: set watermark control failed.\n");
         (void)max30105_deinit(&gs_handle);
        
         return 1;
@@ -401,3 +217,73 @@ uint8_t max30105_fifo_read(uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_gr
         return 0;
     }
 }
+
+/**
+ * @brief         read the samples
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ * @note          a fifo overrun is not an error, the gap is flagged in the samples
+ */
+uint8_t max30105_fifo_read_samples(max30105_sample_t *sample, uint8_t *len)
+{
+    uint8_t res;
+    
+    res = max30105_read_samples(&gs_handle, sample, len);
+    if ((res != 0) && (res != 4))
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+/**
+ * @brief     set the time of the interrupt edge
+ * @param[in] ns edge time in ns from a monotonic clock
+ * @return    status code
+ *            - 0 success
+ *            - 1 set failed
+ * @note      call it before max30105_fifo_irq_handler
+ */
+uint8_t max30105_fifo_set_edge_timestamp(uint64_t ns)
+{
+    if (max30105_set_edge_timestamp(&gs_handle, ns) != 0)
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+/**
+ * @brief         poll the fifo without the interrupt line
+ * @param[in]     now current time in ns from a monotonic clock
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *deadline pointer to a deadline buffer in ns
+ * @return        status code
+ *                - 0 success
+ *                - 1 poll failed
+ * @note          sleep until the deadline and call it again, a fifo overrun is not an error
+ */
+uint8_t max30105_fifo_poll(uint64_t now, max30105_sample_t *sample, uint8_t *len, uint64_t *deadline)
+{
+    uint8_t res;
+    
+    res = max30105_poll(&gs_handle, now, sample, len, deadline);
+    if ((res != 0) && (res != 4))
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
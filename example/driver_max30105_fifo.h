@@ -56,6 +56,8 @@ extern "C"{
 #define MAX30105_FIFO_DEFAULT_SAMPLE_AVERAGING               MAX30105_SAMPLE_AVERAGING_8                         /**< sample 8 */
 #define MAX30105_FIFO_DEFAULT_FIFO_ROLL                      MAX30105_BOOL_TRUE                                  /**< enable */
 #define MAX30105_FIFO_DEFAULT_FIFO_ALMOST_FULL               0xF                                                 /**< 0xF */
+#define MAX30105_FIFO_DEFAULT_WATERMARK_CONTROL              MAX30105_BOOL_FALSE                                 /**< disable */
+#define MAX30105_FIFO_DEFAULT_WATERMARK_MARGIN               2                                                   /**< 2 samples */
 #define MAX30105_FIFO_DEFAULT_MODE                           MAX30105_MODE_GREEN_RED_IR                          /**< green red ir mode */
 #define MAX30105_FIFO_DEFAULT_PARTICLE_SENSING_ADC_RANGE     MAX30105_PARTICLE_SENSING_ADC_RANGE_4096            /**< adc range 4096 */
 #define MAX30105_FIFO_DEFAULT_PARTICLE_SENSING_SAMPLE_RATE   MAX30105_PARTICLE_SENSING_SAMPLE_RATE_100_HZ        /**< 100 Hz */
@@ -115,6 +117,40 @@ uint8_t max30105_fifo_deinit(void);
  */
 uint8_t max30105_fifo_read(uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green, uint8_t *len);
 
+/**
+ * @brief         read the samples
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ * @note          a fifo overrun is not an error, the gap is flagged in the samples
+ */
+uint8_t max30105_fifo_read_samples(max30105_sample_t *sample, uint8_t *len);
+
+/**
+ * @brief     set the time of the interrupt edge
+ * @param[in] ns edge time in ns from a monotonic clock
+ * @return    status code
+ *            - 0 success
+ *            - 1 set failed
+ * @note      call it before max30105_fifo_irq_handler
+ */
+uint8_t max30105_fifo_set_edge_timestamp(uint64_t ns);
+
+/**
+ * @brief         poll the fifo without the interrupt line
+ * @param[in]     now current time in ns from a monotonic clock
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *deadline pointer to a deadline buffer in ns
+ * @return        status code
+ *                - 0 success
+ *                - 1 poll failed
+ * @note          sleep until the deadline and call it again, a fifo overrun is not an error
+ */
+uint8_t max30105_fifo_poll(uint64_t now, max30105_sample_t *sample, uint8_t *len, uint64_t *deadline);
+
 /**
  * @}
  */
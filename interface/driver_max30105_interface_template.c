@@ -92,6 +92,22 @@ uint8_t max30105_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, ui
     return 0;
 }
 
+/**
+ * @brief         interface iic bus batch transfer
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          optional, all transfers run in one bus transaction with repeated starts,
+ *                a bus without repeated start chaining may run them one after another
+ */
+uint8_t max30105_interface_iic_transfer(uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    return 0;
+}
+
 /**
  * @brief     interface delay ms
  * @param[in] ms time
@@ -165,3 +181,102 @@ void max30105_interface_receive_callback(uint8_t type)
         }
     }
 }
+
+/**
+ * @brief     interface iic bus init with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_init_ctx(void *user)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface iic bus deinit with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_deinit_ctx(void *user)
+{
+    return 0;
+}
+
+/**
+ * @brief      interface iic bus read with a user context
+ * @param[in]  *user pointer to the bus context of the port
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t max30105_interface_iic_read_ctx(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface iic bus write with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_write_ctx(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    return 0;
+}
+
+/**
+ * @brief         interface iic bus batch transfer with a user context
+ * @param[in]     *user pointer to the bus context of the port
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          optional, all transfers run in one bus transaction with repeated starts,
+ *                a bus without repeated start chaining may run them one after another
+ */
+uint8_t max30105_interface_iic_transfer_ctx(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface delay ms with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] ms time
+ * @note      none
+ */
+void max30105_interface_delay_ms_ctx(void *user, uint32_t ms)
+{
+    
+}
+
+/**
+ * @brief     interface receive callback with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] type irq type
+ * @note      none
+ */
+void max30105_interface_receive_callback_ctx(void *user, uint8_t type)
+{
+    
+}
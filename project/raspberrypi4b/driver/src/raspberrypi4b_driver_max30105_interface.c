@@ -48,6 +48,37 @@
  */
 static int gs_fd;                           /**< iic handle */
 
+/**
+ * @brief     run driver transfers as one iic batch
+ * @param[in] fd iic handle
+ * @param[in] addr iic device write address
+ * @param[in] *transfer pointer to an iic transfer array
+ * @param[in] num number of transfers
+ * @return    status code
+ *            - 0 success
+ *            - 1 transfer failed
+ * @note      none
+ */
+static uint8_t a_iic_transfer_batch(int fd, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    uint8_t i;
+    iic_transfer_t batch[IIC_TRANSFER_MAX_MSGS];
+    
+    if (num > IIC_TRANSFER_MAX_MSGS)
+    {
+        return 1;
+    }
+    for (i = 0; i < num; i++)
+    {
+        batch[i].reg = transfer[i].reg;
+        batch[i].read = transfer[i].read;
+        batch[i].buf = transfer[i].buf;
+        batch[i].len = transfer[i].len;
+    }
+    
+    return iic_transfer_batch(fd, addr, batch, num);
+}
+
 /**
  * @brief  interface iic bus init
  * @return status code
@@ -104,6 +135,21 @@ uint8_t max30105_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, ui
     return iic_write(gs_fd, addr, reg, buf, len);
 }
 
+/**
+ * @brief         interface iic bus batch transfer
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          optional, all transfers run in one bus transaction with repeated starts
+ */
+uint8_t max30105_interface_iic_transfer(uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    return a_iic_transfer_batch(gs_fd, addr, transfer, num);
+}
+
 /**
  * @brief     interface delay ms
  * @param[in] ms time
@@ -185,3 +231,115 @@ void max30105_interface_receive_callback(uint8_t type)
         }
     }
 }
+
+/**
+ * @brief     interface iic bus init with a user context
+ * @param[in] *user pointer to an iic bus structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_init_ctx(void *user)
+{
+    iic_bus_t *bus = (iic_bus_t *)user;
+    
+    return iic_init(bus->name, &bus->fd);
+}
+
+/**
+ * @brief     interface iic bus deinit with a user context
+ * @param[in] *user pointer to an iic bus structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_deinit_ctx(void *user)
+{
+    iic_bus_t *bus = (iic_bus_t *)user;
+    
+    return iic_deinit(bus->fd);
+}
+
+/**
+ * @brief      interface iic bus read with a user context
+ * @param[in]  *user pointer to an iic bus structure
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t max30105_interface_iic_read_ctx(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    iic_bus_t *bus = (iic_bus_t *)user;
+    
+    return iic_read(bus->fd, addr, reg, buf, len);
+}
+
+/**
+ * @brief     interface iic bus write with a user context
+ * @param[in] *user pointer to an iic bus structure
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_write_ctx(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    iic_bus_t *bus = (iic_bus_t *)user;
+    
+    return iic_write(bus->fd, addr, reg, buf, len);
+}
+
+/**
+ * @brief         interface iic bus batch transfer with a user context
+ * @param[in]     *user pointer to an iic bus structure
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          optional, all transfers run in one bus transaction with repeated starts
+ */
+uint8_t max30105_interface_iic_transfer_ctx(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    iic_bus_t *bus = (iic_bus_t *)user;
+    
+    return a_iic_transfer_batch(bus->fd, addr, transfer, num);
+}
+
+/**
+ * @brief     interface delay ms with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] ms time
+ * @note      none
+ */
+void max30105_interface_delay_ms_ctx(void *user, uint32_t ms)
+{
+    (void)user;
+    
+    usleep(1000 * ms);
+}
+
+/**
+ * @brief     interface receive callback with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] type irq type
+ * @note      none
+ */
+void max30105_interface_receive_callback_ctx(void *user, uint8_t type)
+{
+    (void)user;
+    
+    max30105_interface_receive_callback(type);
+}
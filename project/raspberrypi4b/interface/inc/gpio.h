@@ -37,6 +37,7 @@
 #ifndef GPIO_H
 #define GPIO_H
 
+#include "latency.h"
 #include <unistd.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -45,12 +46,49 @@
  extern "C" {
 #endif
 
+/**
+ * @brief gpiod structure declaration
+ */
+struct gpiod_chip;
+struct gpiod_line;
+
 /**
  * @defgroup gpio gpio function
  * @brief    gpio function modules
  * @{
  */
 
+/**
+ * @brief gpio event structure definition
+ */
+typedef struct gpio_event_s
+{
+    struct gpiod_chip *chip;        /**< gpio chip handle */
+    struct gpiod_line *line;        /**< gpio line handle */
+    int fd;                         /**< pollable event fd */
+    uint64_t timestamp;             /**< kernel time of the last falling edge in ns */
+} gpio_event_t;
+
+/**
+ * @brief gpio realtime structure definition
+ */
+typedef struct gpio_realtime_s
+{
+    int priority;        /**< SCHED_FIFO priority from 1 to 99, 0 keeps the default scheduling */
+    int cpu;             /**< cpu the pthread is pinned to, -1 for no pinning */
+    uint8_t lock;        /**< lock all current and future pages in memory when not 0 */
+} gpio_realtime_t;
+
+/**
+ * @brief     set the realtime controls of the gpio interrupt pthread
+ * @param[in] *realtime pointer to a gpio realtime structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 set failed
+ * @note      call it before gpio_interrupt_init, SCHED_FIFO and mlockall need CAP_SYS_NICE and CAP_IPC_LOCK
+ */
+uint8_t gpio_interrupt_set_realtime(const gpio_realtime_t *realtime);
+
 /**
  * @brief  gpio interrupt init
  * @return status code
@@ -69,6 +107,60 @@ uint8_t gpio_interrupt_init(void);
  */
 uint8_t gpio_interrupt_deinit(void);
 
+/**
+ * @brief  get the gpio interrupt timestamp
+ * @return kernel time of the last falling edge in ns
+ * @note   call it from g_gpio_irq, which runs on the gpio interrupt pthread
+ */
+uint64_t gpio_interrupt_get_timestamp(void);
+
+/**
+ * @brief  mark the data of the last falling edge as delivered
+ * @note   call it from g_gpio_irq once the samples reach the consumer,
+ *         the time since the edge goes to the data ready histogram
+ */
+void gpio_interrupt_mark_data_ready(void);
+
+/**
+ * @brief      get the gpio interrupt latency histograms
+ * @param[out] *callback pointer to an edge to callback histogram buffer
+ * @param[out] *data pointer to an edge to data ready histogram buffer
+ * @note       the histograms are cleared by gpio_interrupt_init
+ */
+void gpio_interrupt_get_latency(latency_histogram_t *callback, latency_histogram_t *data);
+
+/**
+ * @brief      gpio event init
+ * @param[out] *event pointer to a gpio event structure
+ * @param[in]  *name pointer to a gpio device name buffer
+ * @param[in]  line gpio device line
+ * @return     status code
+ *             - 0 success
+ *             - 1 init failed
+ * @note       no pthread is created, poll event->fd and call gpio_event_read when it is readable
+ */
+uint8_t gpio_event_init(gpio_event_t *event, char *name, uint32_t line);
+
+/**
+ * @brief      gpio event read
+ * @param[in]  *event pointer to a gpio event structure
+ * @param[out] *falling pointer to a falling edge count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       reads all pending events without blocking
+ */
+uint8_t gpio_event_read(gpio_event_t *event, uint32_t *falling);
+
+/**
+ * @brief     gpio event deinit
+ * @param[in] *event pointer to a gpio event structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t gpio_event_deinit(gpio_event_t *event);
+
 /**
  * @}
  */
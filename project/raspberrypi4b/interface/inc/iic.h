@@ -53,6 +53,37 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief iic transfer definition
+ */
+#define IIC_TRANSFER_MAX_MSGS 42        /**< max i2c messages in one I2C_RDWR ioctl */
+
+/**
+ * @brief iic write definition
+ */
+#define IIC_WRITE_STAGE_SIZE 64         /**< max write bytes staged on the stack, longer writes use the heap */
+#define IIC_FD_MAX           64         /**< max fd whose adapter capabilities are cached */
+
+/**
+ * @brief iic transfer structure definition
+ */
+typedef struct iic_transfer_s
+{
+    uint8_t reg;          /**< iic register address */
+    uint8_t read;         /**< 1 to read from the register, 0 to write to it */
+    uint8_t *buf;         /**< pointer to a data buffer */
+    uint16_t len;         /**< length of the data buffer */
+} iic_transfer_t;
+
+/**
+ * @brief iic bus structure definition
+ */
+typedef struct iic_bus_s
+{
+    char *name;        /**< iic device name */
+    int fd;            /**< iic device handle */
+} iic_bus_t;
+
 /**
  * @brief      iic bus init
  * @param[in]  *name pointer to an iic device name buffer
@@ -74,6 +105,16 @@ uint8_t iic_init(char *name, int *fd);
  */
 uint8_t iic_deinit(int fd);
 
+/**
+ * @brief     iic bus get the scatter gather write capability
+ * @param[in] fd iic handle
+ * @return    status code
+ *            - 0 writes are staged in a bounded buffer
+ *            - 1 writes send the caller's buffer with I2C_M_NOSTART
+ * @note      none
+ */
+uint8_t iic_get_nostart(int fd);
+
 /**
  * @brief      iic bus read command
  * @param[in]  fd iic handle
@@ -138,7 +179,7 @@ uint8_t iic_write_cmd(int fd, uint8_t addr, uint8_t *buf, uint16_t len);
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      addr = device_address_7bits << 1
+ * @note      addr = device_address_7bits << 1, the payload is not copied when the adapter supports I2C_M_NOSTART
  */
 uint8_t iic_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
 
@@ -152,10 +193,25 @@ uint8_t iic_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      addr = device_address_7bits << 1
+ * @note      addr = device_address_7bits << 1, the payload is not copied when the adapter supports I2C_M_NOSTART
  */
 uint8_t iic_write_address16(int fd, uint8_t addr, uint16_t reg, uint8_t *buf, uint16_t len);
 
+/**
+ * @brief      iic bus batch transfer
+ * @param[in]  fd iic handle
+ * @param[in]  addr iic device write address
+ * @param[in]  *transfer pointer to an iic transfer array
+ * @param[in]  num number of transfers
+ * @return     status code
+ *             - 0 success
+ *             - 1 transfer failed
+ * @note       addr = device_address_7bits << 1, all transfers run in one I2C_RDWR ioctl with repeated starts,
+ *             a read takes 2 messages and a write 1, or 2 when the adapter supports I2C_M_NOSTART,
+ *             at most IIC_TRANSFER_MAX_MSGS messages in total
+ */
+uint8_t iic_transfer_batch(int fd, uint8_t addr, iic_transfer_t *transfer, uint16_t num);
+
 /**
  * @}
  */
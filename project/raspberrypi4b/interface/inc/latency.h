@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      latency.h
+ * @brief     latency header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <unistd.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup latency latency function
+ * @brief    latency function modules
+ * @{
+ */
+
+/**
+ * @brief latency histogram size definition
+ */
+#define LATENCY_HISTOGRAM_BINS 32        /**< bin 0 is below 1us, bin i is [2^(i-1), 2^i) us */
+
+/**
+ * @brief latency histogram structure definition
+ */
+typedef struct latency_histogram_s
+{
+    uint32_t bin[LATENCY_HISTOGRAM_BINS];        /**< sample count of each bin */
+    uint64_t count;                              /**< total sample count */
+    uint64_t sum;                                /**< sum of all latencies in ns */
+    uint64_t max;                                /**< max latency in ns */
+} latency_histogram_t;
+
+/**
+ * @brief     clear a latency histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @note      none
+ */
+void latency_histogram_clear(latency_histogram_t *histogram);
+
+/**
+ * @brief     add a latency to a histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @param[in] ns latency in ns
+ * @note      constant time, safe to call on the acquisition path
+ */
+void latency_histogram_add(latency_histogram_t *histogram, uint64_t ns);
+
+/**
+ * @brief     get a percentile of a latency histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @param[in] percent percentile from 0 to 100
+ * @return    upper bound of the bin holding the percentile in ns
+ * @note      0 when the histogram is empty
+ */
+uint64_t latency_histogram_percentile(latency_histogram_t *histogram, float percent);
+
+/**
+ * @brief     print a latency histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @param[in] *name pointer to a name buffer
+ * @note      only the bins with samples are printed
+ */
+void latency_histogram_print(latency_histogram_t *histogram, const char *name);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
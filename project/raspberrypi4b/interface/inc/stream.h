@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      stream.h
+ * @brief     stream header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "driver_max30105.h"
+#include <unistd.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup stream stream function
+ * @brief    stream function modules
+ * @{
+ */
+
+/**
+ * @brief stream size definition
+ */
+#define MAX30105_STREAM_SIZE 256        /**< ring size in samples, must be a power of 2 */
+
+/**
+ * @brief stream structure definition
+ */
+typedef struct max30105_stream_s
+{
+    max30105_sample_t sample[MAX30105_STREAM_SIZE];        /**< sample ring */
+    uint32_t head;                                         /**< write index, only stored by the producer */
+    uint64_t dropped;                                      /**< dropped samples, only stored by the producer */
+    uint8_t pad[64];                                       /**< keep the producer and consumer indexes apart */
+    uint32_t tail;                                         /**< read index, only stored by the consumer */
+    int fd;                                                /**< eventfd signalled by the producer */
+} max30105_stream_t;
+
+/**
+ * @brief      stream init
+ * @param[in]  *stream pointer to a stream structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 init failed
+ * @note       none
+ */
+uint8_t max30105_stream_init(max30105_stream_t *stream);
+
+/**
+ * @brief     stream deinit
+ * @param[in] *stream pointer to a stream structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ * @note      none
+ */
+uint8_t max30105_stream_deinit(max30105_stream_t *stream);
+
+/**
+ * @brief     push samples into the stream
+ * @param[in] *stream pointer to a stream structure
+ * @param[in] *sample pointer to a sample buffer
+ * @param[in] len number of samples
+ * @return    number of pushed samples
+ * @note      producer side, never blocks, samples that don't fit are counted as dropped
+ */
+uint32_t max30105_stream_push(max30105_stream_t *stream, const max30105_sample_t *sample, uint32_t len);
+
+/**
+ * @brief         pop a batch of samples from the stream
+ * @param[in]     *stream pointer to a stream structure
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *dropped pointer to a dropped samples buffer
+ * @param[in]     timeout_ms timeout in ms, -1 waits forever
+ * @return        status code
+ *                - 0 success
+ *                - 1 pop failed
+ *                - 4 timeout
+ * @note          consumer side, blocks on the eventfd while the stream is empty,
+ *                dropped is the total count since init and may be NULL
+ */
+uint8_t max30105_stream_pop(max30105_stream_t *stream, max30105_sample_t *sample, uint32_t *len,
+                            uint64_t *dropped, int timeout_ms);
+
+/**
+ * @brief     get the stream event fd
+ * @param[in] *stream pointer to a stream structure
+ * @return    eventfd that is readable while samples may be pending
+ * @note      for consumers that run their own poll or epoll loop
+ */
+int max30105_stream_get_fd(max30105_stream_t *stream);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -34,9 +34,16 @@
  * </table>
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include "gpio.h"
+#include "deadline.h"
 #include <gpiod.h>
 #include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <string.h>
 
 /**
  * @brief gpio device name definition
@@ -54,6 +61,15 @@
 static struct gpiod_chip *gs_chip;        /**< gpio chip handle */
 static struct gpiod_line *gs_line;        /**< gpio line handle */
 static pthread_t gs_pid;                  /**< gpio pthread pid */
+static uint64_t gs_timestamp;             /**< last falling edge time in ns */
+static gpio_realtime_t gs_realtime =
+{
+    .priority = 0,
+    .cpu = -1,
+    .lock = 0,
+};                                        /**< realtime controls */
+static latency_histogram_t gs_callback;   /**< edge to callback latency */
+static latency_histogram_t gs_data;       /**< edge to data ready latency */
 extern uint8_t (*g_gpio_irq)(void);       /**< gpio irq */
 
 /**
@@ -89,6 +105,12 @@ static void *a_gpio_interrupt_pthread(void *p)
             /* if the falling edge */
             if (event.event_type == GPIOD_LINE_EVENT_FALLING_EDGE)
             {
+                /* save the kernel timestamp */
+                gs_timestamp = (uint64_t)event.ts.tv_sec * 1000000000ULL + (uint64_t)event.ts.tv_nsec;
+
+                /* the kernel timestamp is from the monotonic clock */
+                latency_histogram_add(&gs_callback, deadline_now() - gs_timestamp);
+
                 /* check the g_gpio_irq */
                 if (g_gpio_irq != NULL)
                 {
@@ -110,6 +132,24 @@ static void *a_gpio_interrupt_pthread(void *p)
 uint8_t gpio_interrupt_init(void)
 {
     uint8_t res;
+    pthread_attr_t attr;
+    struct sched_param param;
+    cpu_set_t cpus;
+    
+    /* clear the latency histograms */
+    latency_histogram_clear(&gs_callback);
+    latency_histogram_clear(&gs_data);
+    
+    /* keep the pages in memory, page faults cost more than any bus transfer */
+    if (gs_realtime.lock != 0)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            perror("gpio: lock memory failed.\n");
+
+            return 1;
+        }
+    }
     
     /* open the gpio group */
     gs_chip = gpiod_chip_open(GPIO_DEVICE_NAME);
@@ -139,12 +179,34 @@ uint8_t gpio_interrupt_init(void)
         return 1;
     }
 
+    /* set the scheduling of the pthread */
+    (void)pthread_attr_init(&attr);
+    if (gs_realtime.priority > 0)
+    {
+        memset(&param, 0, sizeof(struct sched_param));
+        param.sched_priority = gs_realtime.priority;
+        (void)pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        (void)pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        (void)pthread_attr_setschedparam(&attr, &param);
+    }
+    if (gs_realtime.cpu >= 0)
+    {
+        CPU_ZERO(&cpus);
+        CPU_SET(gs_realtime.cpu, &cpus);
+        (void)pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus);
+    }
+
     /* creat a gpio interrupt pthread */
-    res = pthread_create(&gs_pid, NULL, a_gpio_interrupt_pthread, NULL);
+    res = pthread_create(&gs_pid, &attr, a_gpio_interrupt_pthread, NULL);
+    (void)pthread_attr_destroy(&attr);
     if (res != 0)
     {
         perror("gpio: creat pthread failed.\n");
         gpiod_chip_close(gs_chip);
+        if (gs_realtime.lock != 0)
+        {
+            (void)munlockall();
+        }
 
         return 1;
     }
@@ -175,5 +237,195 @@ uint8_t gpio_interrupt_deinit(void)
     /* close the gpio */
     gpiod_chip_close(gs_chip);
     
+    /* unlock the memory */
+    if (gs_realtime.lock != 0)
+    {
+        (void)munlockall();
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     set the realtime controls of the gpio interrupt pthread
+ * @param[in] *realtime pointer to a gpio realtime structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 set failed
+ * @note      call it before gpio_interrupt_init, SCHED_FIFO and mlockall need CAP_SYS_NICE and CAP_IPC_LOCK
+ */
+uint8_t gpio_interrupt_set_realtime(const gpio_realtime_t *realtime)
+{
+    /* check the priority */
+    if ((realtime->priority < 0) || (realtime->priority > sched_get_priority_max(SCHED_FIFO)))
+    {
+        fprintf(stderr, "gpio: priority is invalid.\n");
+
+        return 1;
+    }
+
+    /* check the cpu */
+    if ((realtime->cpu >= CPU_SETSIZE) || (realtime->cpu < -1))
+    {
+        fprintf(stderr, "gpio: cpu is invalid.\n");
+
+        return 1;
+    }
+    gs_realtime = *realtime;
+
+    return 0;
+}
+
+/**
+ * @brief  get the gpio interrupt timestamp
+ * @return kernel time of the last falling edge in ns
+ * @note   call it from g_gpio_irq, which runs on the gpio interrupt pthread
+ */
+uint64_t gpio_interrupt_get_timestamp(void)
+{
+    return gs_timestamp;
+}
+
+/**
+ * @brief  mark the data of the last falling edge as delivered
+ * @note   call it from g_gpio_irq once the samples reach the consumer,
+ *         the time since the edge goes to the data ready histogram
+ */
+void gpio_interrupt_mark_data_ready(void)
+{
+    latency_histogram_add(&gs_data, deadline_now() - gs_timestamp);
+}
+
+/**
+ * @brief      get the gpio interrupt latency histograms
+ * @param[out] *callback pointer to an edge to callback histogram buffer
+ * @param[out] *data pointer to an edge to data ready histogram buffer
+ * @note       the histograms are cleared by gpio_interrupt_init
+ */
+void gpio_interrupt_get_latency(latency_histogram_t *callback, latency_histogram_t *data)
+{
+    *callback = gs_callback;
+    *data = gs_data;
+}
+
+/**
+ * @brief      gpio event init
+ * @param[out] *event pointer to a gpio event structure
+ * @param[in]  *name pointer to a gpio device name buffer
+ * @param[in]  line gpio device line
+ * @return     status code
+ *             - 0 success
+ *             - 1 init failed
+ * @note       no pthread is created, poll event->fd and call gpio_event_read when it is readable
+ */
+uint8_t gpio_event_init(gpio_event_t *event, char *name, uint32_t line)
+{
+    /* open the gpio group */
+    event->chip = gpiod_chip_open(name);
+    if (event->chip == NULL)
+    {
+        perror("gpio: open failed.\n");
+
+        return 1;
+    }
+
+    /* get the gpio line */
+    event->line = gpiod_chip_get_line(event->chip, line);
+    if (event->line == NULL)
+    {
+        perror("gpio: get line failed.\n");
+        gpiod_chip_close(event->chip);
+
+        return 1;
+    }
+
+    /* catch the falling edge */
+    if (gpiod_line_request_falling_edge_events(event->line, "gpiointerrupt") < 0)
+    {
+        perror("gpio: set edge events failed.\n");
+        gpiod_chip_close(event->chip);
+
+        return 1;
+    }
+
+    /* get the event fd */
+    event->fd = gpiod_line_event_get_fd(event->line);
+    if (event->fd < 0)
+    {
+        perror("gpio: get event fd failed.\n");
+        gpiod_chip_close(event->chip);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      gpio event read
+ * @param[in]  *event pointer to a gpio event structure
+ * @param[out] *falling pointer to a falling edge count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       reads all pending events without blocking
+ */
+uint8_t gpio_event_read(gpio_event_t *event, uint32_t *falling)
+{
+    int res;
+    struct timespec timeout;
+    struct gpiod_line_event line_event;
+
+    /* don't wait */
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 0;
+
+    /* read all pending events */
+    *falling = 0;
+    while (1)
+    {
+        res = gpiod_line_event_wait(event->line, &timeout);
+        if (res < 0)
+        {
+            perror("gpio: wait event failed.\n");
+
+            return 1;
+        }
+        if (res == 0)
+        {
+            break;
+        }
+        if (gpiod_line_event_read(event->line, &line_event) != 0)
+        {
+            perror("gpio: read event failed.\n");
+
+            return 1;
+        }
+
+        /* if the falling edge */
+        if (line_event.event_type == GPIOD_LINE_EVENT_FALLING_EDGE)
+        {
+            event->timestamp = (uint64_t)line_event.ts.tv_sec * 1000000000ULL + (uint64_t)line_event.ts.tv_nsec;
+            (*falling)++;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief     gpio event deinit
+ * @param[in] *event pointer to a gpio event structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t gpio_event_deinit(gpio_event_t *event)
+{
+    /* release the line and close the gpio */
+    gpiod_line_release(event->line);
+    gpiod_chip_close(event->chip);
+    event->fd = -1;
+
     return 0;
 }
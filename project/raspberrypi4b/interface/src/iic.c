@@ -40,6 +40,85 @@
 #include <sys/ioctl.h>
 #include <fcntl.h>
 
+/**
+ * @brief adapter I2C_M_NOSTART support indexed by fd
+ */
+static uint8_t gs_nostart[IIC_FD_MAX];
+
+/**
+ * @brief     iic write a register address followed by a payload
+ * @param[in] fd iic handle
+ * @param[in] addr iic device write address
+ * @param[in] *head pointer to the register address bytes
+ * @param[in] head_len length of the register address bytes
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the payload goes out as an I2C_M_NOSTART message when the adapter supports it,
+ *            otherwise it is staged after the head without clearing the stage first
+ */
+static uint8_t a_iic_write_segments(int fd, uint8_t addr, uint8_t *head, uint16_t head_len, uint8_t *buf, uint16_t len)
+{
+    struct i2c_rdwr_ioctl_data i2c_rdwr_data;
+    struct i2c_msg msgs[2];
+    uint8_t stage[IIC_WRITE_STAGE_SIZE];
+    uint8_t *buf_send;
+    uint8_t res;
+    
+    /* set the ioctl data */
+    i2c_rdwr_data.msgs = msgs;
+    msgs[0].addr = addr >> 1;
+    msgs[0].flags = 0;
+    buf_send = NULL;
+    if ((len != 0) && (iic_get_nostart(fd) != 0))
+    {
+        /* send the caller's buffer without a new start condition */
+        msgs[0].buf = head;
+        msgs[0].len = head_len;
+        msgs[1].addr = addr >> 1;
+        msgs[1].flags = I2C_M_NOSTART;
+        msgs[1].buf = buf;
+        msgs[1].len = len;
+        i2c_rdwr_data.nmsgs = 2;
+    }
+    else
+    {
+        /* stage short writes on the stack */
+        if ((uint32_t)head_len + len <= IIC_WRITE_STAGE_SIZE)
+        {
+            msgs[0].buf = stage;
+        }
+        else
+        {
+            buf_send = (uint8_t *)malloc((uint32_t)head_len + len);
+            if (buf_send == NULL)
+            {
+                perror("iic: malloc failed.\n");
+                
+                return 1;
+            }
+            msgs[0].buf = buf_send;
+        }
+        memcpy(msgs[0].buf, head, head_len);
+        memcpy(msgs[0].buf + head_len, buf, len);
+        msgs[0].len = head_len + len;
+        i2c_rdwr_data.nmsgs = 1;
+    }
+    
+    /* transmit */
+    res = 0;
+    if (ioctl(fd, I2C_RDWR, &i2c_rdwr_data) < 0)
+    {
+        perror("iic: write failed.\n");
+        res = 1;
+    }
+    free(buf_send);
+    
+    return res;
+}
+
 /**
  * @brief      iic bus init
  * @param[in]  *name pointer to an iic device name buffer
@@ -61,10 +140,20 @@ uint8_t iic_init(char *name, int *fd)
      
         return 1;
     }
-    else
+    
+    /* cache the scatter gather write capability */
+    if ((*fd) < IIC_FD_MAX)
     {
-        return 0;
+        unsigned long funcs;
+        
+        if (ioctl(*fd, I2C_FUNCS, &funcs) < 0)
+        {
+            funcs = 0;
+        }
+        gs_nostart[*fd] = ((funcs & I2C_FUNC_NOSTART) != 0) ? 1 : 0;
     }
+    
+    return 0;
 }
 
 /**
@@ -77,6 +166,12 @@ uint8_t iic_init(char *name, int *fd)
  */
 uint8_t iic_deinit(int fd)
 {
+    /* forget the capability */
+    if ((fd >= 0) && (fd < IIC_FD_MAX))
+    {
+        gs_nostart[fd] = 0;
+    }
+    
     /* close the device */
     if (close(fd) < 0)
     {
@@ -90,6 +185,24 @@ uint8_t iic_deinit(int fd)
     }
 }
 
+/**
+ * @brief     iic bus get the scatter gather write capability
+ * @param[in] fd iic handle
+ * @return    status code
+ *            - 0 writes are staged in a bounded buffer
+ *            - 1 writes send the caller's buffer with I2C_M_NOSTART
+ * @note      none
+ */
+uint8_t iic_get_nostart(int fd)
+{
+    if ((fd < 0) || (fd >= IIC_FD_MAX))
+    {
+        return 0;
+    }
+    
+    return gs_nostart[fd];
+}
+
 /**
  * @brief      iic bus read command
  * @param[in]  fd iic handle
@@ -277,42 +390,11 @@ uint8_t iic_write_cmd(int fd, uint8_t addr, uint8_t *buf, uint16_t len)
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      addr = device_address_7bits << 1
+ * @note      addr = device_address_7bits << 1, the payload is not copied when the adapter supports I2C_M_NOSTART
  */
 uint8_t iic_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
 {
-    struct i2c_rdwr_ioctl_data i2c_rdwr_data;
-    struct i2c_msg msgs[1];
-    uint8_t buf_send[len + 1];
-    
-    /* clear ioctl data */
-    memset(&i2c_rdwr_data, 0, sizeof(struct i2c_rdwr_ioctl_data));
-    
-    /* clear msgs data */
-    memset(msgs, 0, sizeof(struct i2c_msg) * 1);
-    
-    /* clear sent buf */
-    memset(buf_send, 0, sizeof(uint8_t) * (len + 1));
-    
-    /* set the param */
-    msgs[0].addr = addr >> 1;
-    msgs[0].flags = 0;
-    buf_send[0] = reg;
-    memcpy(&buf_send[1], buf, len);
-    msgs[0].buf = buf_send;
-    msgs[0].len = len + 1;
-    i2c_rdwr_data.msgs = msgs;
-    i2c_rdwr_data.nmsgs = 1;
-    
-    /* transmit */
-    if (ioctl(fd, I2C_RDWR, &i2c_rdwr_data) < 0)
-    {
-        perror("iic: write failed.\n");
-        
-        return 1;
-    }
-     
-    return 0;
+    return a_iic_write_segments(fd, addr, &reg, 1, buf, len);
 }
 
 /**
@@ -325,41 +407,132 @@ uint8_t iic_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      addr = device_address_7bits << 1
+ * @note      addr = device_address_7bits << 1, the payload is not copied when the adapter supports I2C_M_NOSTART
  */
 uint8_t iic_write_address16(int fd, uint8_t addr, uint16_t reg, uint8_t *buf, uint16_t len)
 {
-    struct i2c_rdwr_ioctl_data i2c_rdwr_data;
-    struct i2c_msg msgs[1];
-    uint8_t buf_send[len + 2];
+    uint8_t head[2];
     
-    /* clear ioctl data */
-    memset(&i2c_rdwr_data, 0, sizeof(struct i2c_rdwr_ioctl_data));
+    /* set the register address */
+    head[0] = (reg >> 8) & 0xFF;
+    head[1] = (reg >> 0) & 0xFF;
     
-    /* clear msgs data */
-    memset(msgs, 0, sizeof(struct i2c_msg) * 1);
+    return a_iic_write_segments(fd, addr, head, 2, buf, len);
+}
+
+/**
+ * @brief      iic bus batch transfer
+ * @param[in]  fd iic handle
+ * @param[in]  addr iic device write address
+ * @param[in]  *transfer pointer to an iic transfer array
+ * @param[in]  num number of transfers
+ * @return     status code
+ *             - 0 success
+ *             - 1 transfer failed
+ * @note       addr = device_address_7bits << 1, all transfers run in one I2C_RDWR ioctl with repeated starts,
+ *             a read takes 2 messages and a write 1, or 2 when the adapter supports I2C_M_NOSTART,
+ *             at most IIC_TRANSFER_MAX_MSGS messages in total
+ */
+uint8_t iic_transfer_batch(int fd, uint8_t addr, iic_transfer_t *transfer, uint16_t num)
+{
+    struct i2c_rdwr_ioctl_data i2c_rdwr_data;
+    struct i2c_msg msgs[IIC_TRANSFER_MAX_MSGS];
+    uint8_t stage[IIC_WRITE_STAGE_SIZE];
+    uint8_t *buf_send;
+    uint8_t nostart;
+    uint8_t res;
+    uint32_t total;
+    uint32_t offset;
+    uint16_t nmsgs;
+    uint16_t i;
     
-    /* clear sent buf */
-    memset(buf_send, 0, sizeof(uint8_t) * (len + 2));
+    /* count the messages and the staged write bytes */
+    nostart = iic_get_nostart(fd);
+    nmsgs = 0;
+    total = 0;
+    for (i = 0; i < num; i++)
+    {
+        if ((transfer[i].read != 0) || ((nostart != 0) && (transfer[i].len != 0)))
+        {
+            nmsgs += 2;
+        }
+        else
+        {
+            nmsgs += 1;
+            total += transfer[i].len + 1;
+        }
+    }
+    if ((nmsgs == 0) || (nmsgs > IIC_TRANSFER_MAX_MSGS))
+    {
+        fprintf(stderr, "iic: too many messages.\n");
+        
+        return 1;
+    }
+    
+    /* stage short writes on the stack */
+    buf_send = stage;
+    if (total > IIC_WRITE_STAGE_SIZE)
+    {
+        buf_send = (uint8_t *)malloc(total);
+        if (buf_send == NULL)
+        {
+            perror("iic: malloc failed.\n");
+            
+            return 1;
+        }
+    }
     
     /* set the param */
-    msgs[0].addr = addr >> 1;
-    msgs[0].flags = 0;
-    buf_send[0] = (reg >> 8) & 0xFF;
-    buf_send[1] = (reg >> 0) & 0xFF;
-    memcpy(&buf_send[2], buf, len);
-    msgs[0].buf = buf_send;
-    msgs[0].len = len + 2;
+    nmsgs = 0;
+    offset = 0;
+    for (i = 0; i < num; i++)
+    {
+        msgs[nmsgs].addr = addr >> 1;
+        msgs[nmsgs].flags = 0;
+        if (transfer[i].read != 0)
+        {
+            msgs[nmsgs].buf = &transfer[i].reg;
+            msgs[nmsgs].len = 1;
+            msgs[nmsgs + 1].addr = addr >> 1;
+            msgs[nmsgs + 1].flags = I2C_M_RD;
+            msgs[nmsgs + 1].buf = transfer[i].buf;
+            msgs[nmsgs + 1].len = transfer[i].len;
+            nmsgs += 2;
+        }
+        else if ((nostart != 0) && (transfer[i].len != 0))
+        {
+            msgs[nmsgs].buf = &transfer[i].reg;
+            msgs[nmsgs].len = 1;
+            msgs[nmsgs + 1].addr = addr >> 1;
+            msgs[nmsgs + 1].flags = I2C_M_NOSTART;
+            msgs[nmsgs + 1].buf = transfer[i].buf;
+            msgs[nmsgs + 1].len = transfer[i].len;
+            nmsgs += 2;
+        }
+        else
+        {
+            buf_send[offset] = transfer[i].reg;
+            memcpy(&buf_send[offset + 1], transfer[i].buf, transfer[i].len);
+            msgs[nmsgs].buf = &buf_send[offset];
+            msgs[nmsgs].len = transfer[i].len + 1;
+            offset += transfer[i].len + 1;
+            nmsgs += 1;
+        }
+    }
     i2c_rdwr_data.msgs = msgs;
-    i2c_rdwr_data.nmsgs = 1;
+    i2c_rdwr_data.nmsgs = nmsgs;
     
     /* transmit */
+    res = 0;
     if (ioctl(fd, I2C_RDWR, &i2c_rdwr_data) < 0)
     {
-        perror("iic: write failed.\n");
-        
-        return 1;
+        perror("iic: transfer failed.\n");
+        res = 1;
     }
-     
-    return 0;
+    if (buf_send != stage)
+    {
+        free(buf_send);
+    }
+    
+    return res;
 }
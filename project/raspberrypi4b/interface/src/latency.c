@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      latency.c
+ * @brief     latency source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "latency.h"
+#include <string.h>
+
+/**
+ * @brief     clear a latency histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @note      none
+ */
+void latency_histogram_clear(latency_histogram_t *histogram)
+{
+    memset(histogram, 0, sizeof(latency_histogram_t));
+}
+
+/**
+ * @brief     add a latency to a histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @param[in] ns latency in ns
+ * @note      constant time, safe to call on the acquisition path
+ */
+void latency_histogram_add(latency_histogram_t *histogram, uint64_t ns)
+{
+    uint64_t us;
+    uint32_t i;
+    
+    /* log2 of the latency in us */
+    us = ns / 1000;
+    i = (us == 0) ? 0 : (uint32_t)(64 - __builtin_clzll(us));
+    if (i >= LATENCY_HISTOGRAM_BINS)
+    {
+        i = LATENCY_HISTOGRAM_BINS - 1;
+    }
+    
+    /* update the statistics */
+    histogram->bin[i]++;
+    histogram->count++;
+    histogram->sum += ns;
+    if (ns > histogram->max)
+    {
+        histogram->max = ns;
+    }
+}
+
+/**
+ * @brief     get a percentile of a latency histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @param[in] percent percentile from 0 to 100
+ * @return    upper bound of the bin holding the percentile in ns
+ * @note      0 when the histogram is empty
+ */
+uint64_t latency_histogram_percentile(latency_histogram_t *histogram, float percent)
+{
+    uint32_t i;
+    uint64_t need;
+    uint64_t seen;
+    
+    if (histogram->count == 0)
+    {
+        return 0;
+    }
+    
+    /* walk the bins until the percentile is covered */
+    need = (uint64_t)((double)histogram->count * (double)percent / 100.0 + 0.5);
+    need = (need == 0) ? 1 : need;
+    seen = 0;
+    for (i = 0; i < LATENCY_HISTOGRAM_BINS; i++)
+    {
+        seen += histogram->bin[i];
+        if (seen >= need)
+        {
+            break;
+        }
+    }
+    if (i >= LATENCY_HISTOGRAM_BINS - 1)
+    {
+        return histogram->max;
+    }
+    
+    return (1000ULL << i);
+}
+
+/**
+ * @brief     print a latency histogram
+ * @param[in] *histogram pointer to a latency histogram structure
+ * @param[in] *name pointer to a name buffer
+ * @note      only the bins with samples are printed
+ */
+void latency_histogram_print(latency_histogram_t *histogram, const char *name)
+{
+    uint32_t i;
+    
+    printf("latency: %s %llu samples, mean %lluus, p99 < %lluus, max %lluus.\n", name,
+           (unsigned long long)histogram->count,
+           (unsigned long long)((histogram->count != 0) ? (histogram->sum / histogram->count / 1000) : 0),
+           (unsigned long long)(latency_histogram_percentile(histogram, 99.0f) / 1000),
+           (unsigned long long)(histogram->max / 1000));
+    for (i = 0; i < LATENCY_HISTOGRAM_BINS; i++)
+    {
+        if (histogram->bin[i] == 0)
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            printf("latency:   [0, 1) us: %u.\n", histogram->bin[i]);
+        }
+        else
+        {
+            printf("latency:   [%llu, %llu) us: %u.\n", 1ULL << (i - 1), 1ULL << i, histogram->bin[i]);
+        }
+    }
+}
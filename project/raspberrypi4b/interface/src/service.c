@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      service.c
+ * @brief     service source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "service.h"
+
+/**
+ * @brief     service a sensor from an event loop
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *event pointer to a gpio event structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 service failed
+ * @note      call it when event->fd is readable, edges that arrived together run the irq handler once
+ */
+uint8_t max30105_service(max30105_handle_t *handle, gpio_event_t *event)
+{
+    uint32_t falling;
+
+    /* read the pending edges */
+    if (gpio_event_read(event, &falling) != 0)
+    {
+        return 1;
+    }
+
+    /* the irq handler reads all pending status bits at once */
+    if (falling != 0)
+    {
+        (void)max30105_set_edge_timestamp(handle, event->timestamp);
+        if (max30105_irq_handler(handle) != 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
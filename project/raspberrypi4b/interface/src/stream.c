@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      stream.c
+ * @brief     stream source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "stream.h"
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+
+/**
+ * @brief     stream init
+ * @param[in] *stream pointer to a stream structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      none
+ */
+uint8_t max30105_stream_init(max30105_stream_t *stream)
+{
+    /* clear the ring */
+    memset(stream, 0, sizeof(max30105_stream_t));
+    
+    /* open the eventfd */
+    stream->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stream->fd < 0)
+    {
+        perror("stream: open eventfd failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     stream deinit
+ * @param[in] *stream pointer to a stream structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ * @note      none
+ */
+uint8_t max30105_stream_deinit(max30105_stream_t *stream)
+{
+    /* close the eventfd */
+    if (close(stream->fd) < 0)
+    {
+        perror("stream: close eventfd failed.\n");
+        
+        return 1;
+    }
+    stream->fd = -1;
+    
+    return 0;
+}
+
+/**
+ * @brief     push samples into the stream
+ * @param[in] *stream pointer to a stream structure
+ * @param[in] *sample pointer to a sample buffer
+ * @param[in] len number of samples
+ * @return    number of pushed samples
+ * @note      producer side, never blocks, samples that don't fit are counted as dropped
+ */
+uint32_t max30105_stream_push(max30105_stream_t *stream, const max30105_sample_t *sample, uint32_t len)
+{
+    uint32_t i;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t n;
+    uint64_t one;
+    
+    /* get the free space */
+    head = stream->head;
+    tail = __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE);
+    n = MAX30105_STREAM_SIZE - (head - tail);
+    if (n > len)
+    {
+        n = len;
+    }
+    
+    /* copy the samples */
+    for (i = 0; i < n; i++)
+    {
+        stream->sample[(head + i) & (MAX30105_STREAM_SIZE - 1)] = sample[i];
+    }
+    
+    /* count the dropped samples */
+    if (n != len)
+    {
+        __atomic_store_n(&stream->dropped, stream->dropped + (len - n), __ATOMIC_RELAXED);
+    }
+    
+    /* publish and wake the consumer */
+    if (n != 0)
+    {
+        __atomic_store_n(&stream->head, head + n, __ATOMIC_RELEASE);
+        one = 1;
+        if (write(stream->fd, &one, sizeof(one)) < 0)
+        {
+            /* the counter is already signalled */
+        }
+    }
+    
+    return n;
+}
+
+/**
+ * @brief         pop a batch of samples from the stream
+ * @param[in]     *stream pointer to a stream structure
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *dropped pointer to a dropped samples buffer
+ * @param[in]     timeout_ms timeout in ms, -1 waits forever
+ * @return        status code
+ *                - 0 success
+ *                - 1 pop failed
+ *                - 4 timeout
+ * @note          consumer side, blocks on the eventfd while the stream is empty,
+ *                dropped is the total count since init and may be NULL
+ */
+uint8_t max30105_stream_pop(max30105_stream_t *stream, max30105_sample_t *sample, uint32_t *len,
+                            uint64_t *dropped, int timeout_ms)
+{
+    uint32_t i;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t n;
+    uint64_t count;
+    struct pollfd pfd;
+    
+    tail = stream->tail;
+    while (1)
+    {
+        /* check the pending samples */
+        head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+        if (head != tail)
+        {
+            break;
+        }
+        
+        /* wait for the producer */
+        pfd.fd = stream->fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, timeout_ms) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("stream: poll failed.\n");
+            
+            return 1;
+        }
+        if ((pfd.revents & POLLIN) == 0)
+        {
+            *len = 0;
+            
+            return 4;
+        }
+        
+        /* consume the wakeup */
+        if (read(stream->fd, &count, sizeof(count)) < 0)
+        {
+            /* a racing read already consumed it */
+        }
+    }
+    
+    /* copy a batch */
+    n = head - tail;
+    if (n > *len)
+    {
+        n = *len;
+    }
+    for (i = 0; i < n; i++)
+    {
+        sample[i] = stream->sample[(tail + i) & (MAX30105_STREAM_SIZE - 1)];
+    }
+    __atomic_store_n(&stream->tail, tail + n, __ATOMIC_RELEASE);
+    *len = n;
+    
+    /* get the dropped samples */
+    if (dropped != NULL)
+    {
+        *dropped = __atomic_load_n(&stream->dropped, __ATOMIC_RELAXED);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     get the stream event fd
+ * @param[in] *stream pointer to a stream structure
+ * @return    eventfd that is readable while samples may be pending
+ * @note      for consumers that run their own poll or epoll loop
+ */
+int max30105_stream_get_fd(max30105_stream_t *stream)
+{
+    return stream->fd;
+}
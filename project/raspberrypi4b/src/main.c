@@ -37,19 +37,40 @@
 #include "driver_max30105_fifo.h"
 #include "driver_max30105_register_test.h"
 #include "driver_max30105_fifo_test.h"
+#include "driver_max30105_read_test.h"
+#include "driver_max30105_sim_test.h"
+#include "driver_max30105_trace_test.h"
+#include "driver_max30105_synth_test.h"
+#include "driver_max30105_bench.h"
 #include "gpio.h"
+#include "stream.h"
+#include "deadline.h"
+#include "iic.h"
 #include <getopt.h>
 #include <stdlib.h>
 
 /**
  * @brief global var definition
  */
-static volatile uint8_t gs_flag;           /**< flag */
-static uint32_t gs_raw_red[32];            /**< raw rad buffer */
-static uint32_t gs_raw_ir[32];             /**< raw ir buffer */
-static uint32_t gs_raw_green[32];          /**< raw green buffer */
+static max30105_stream_t gs_stream;        /**< sample stream */
+static max30105_sample_t gs_sample[32];    /**< sample buffer */
 uint8_t (*g_gpio_irq)(void) = NULL;        /**< irq function address */
 
+/**
+ * @brief  fifo irq with the edge time
+ * @return status code
+ *         - 0 success
+ *         - 1 run failed
+ * @note   none
+ */
+static uint8_t a_fifo_irq_handler(void)
+{
+    /* hand the kernel edge time to the driver */
+    (void)max30105_fifo_set_edge_timestamp(gpio_interrupt_get_timestamp());
+    
+    return max30105_fifo_irq_handler();
+}
+
 /**
  * @brief     interface receive callback
  * @param[in] type irq type
@@ -66,13 +87,15 @@ void max30105_receive_callback(uint8_t type)
             
             /* read data */
             len = 32;
-            res = max30105_fifo_read((uint32_t *)gs_raw_red, (uint32_t *)gs_raw_ir, (uint32_t *)gs_raw_green, (uint8_t *)&len);
+            res = max30105_fifo_read_samples((max30105_sample_t *)gs_sample, (uint8_t *)&len);
             if (res != 0)
             {
                 max30105_interface_debug_print("max30105: read failed.\n");
             }
-            max30105_interface_debug_print("max30105: irq fifo full with %d.\n", len);
-            gs_flag = 1;
+            
+            /* hand the samples to the consumer */
+            (void)max30105_stream_push(&gs_stream, (max30105_sample_t *)gs_sample, len);
+            gpio_interrupt_mark_data_ready();
             
             break;
         }
@@ -113,6 +136,69 @@ void max30105_receive_callback(uint8_t type)
     }
 }
 
+/**
+ * @brief     burst config write benchmark
+ * @param[in] times write calls per burst
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      each run of writable registers is read back first and rewritten with the same values,
+ *            the runs skip the fifo registers 0x04 - 0x07 and the reserved registers 0x0B and 0x0F
+ */
+static uint8_t a_iic_bench(uint32_t times)
+{
+    const uint8_t burst_reg[5] = {0x08, 0x02, 0x08, 0x0C, 0x10};
+    const uint8_t burst_len[5] = {1, 2, 3, 3, 3};
+    uint8_t reg[3];
+    uint8_t res;
+    uint8_t i;
+    uint32_t j;
+    uint64_t start;
+    uint64_t elapsed;
+    int fd;
+    
+    /* open the bus */
+    res = iic_init("/dev/i2c-1", &fd);
+    if (res != 0)
+    {
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: write path is %s.\n",
+                                   (iic_get_nostart(fd) != 0) ? "scatter gather" : "bounded stage");
+    
+    /* time each burst */
+    for (i = 0; i < 5; i++)
+    {
+        /* read the current values of the run */
+        res = iic_read(fd, 0xAE, burst_reg[i], reg, burst_len[i]);
+        if (res != 0)
+        {
+            (void)iic_deinit(fd);
+            
+            return 1;
+        }
+        start = deadline_now();
+        for (j = 0; j < times; j++)
+        {
+            res = iic_write(fd, 0xAE, burst_reg[i], reg, burst_len[i]);
+            if (res != 0)
+            {
+                (void)iic_deinit(fd);
+                
+                return 1;
+            }
+        }
+        elapsed = deadline_now() - start;
+        max30105_interface_debug_print("max30105: 0x%02X %d byte burst %llu ns per call.\n", burst_reg[i], burst_len[i],
+                                       (unsigned long long)((times != 0) ? (elapsed / times) : 0));
+    }
+    
+    /* close the bus */
+    (void)iic_deinit(fd);
+    
+    return 0;
+}
+
 /**
  * @brief     max30105 full function
  * @param[in] argc arg numbers
@@ -127,19 +213,24 @@ uint8_t max30105(uint8_t argc, char **argv)
 {
     int c;
     int longindex = 0;
-    const char short_options[] = "hipe:t:";
+    const char short_options[] = "hipb:e:t:";
     const struct option long_options[] =
     {
+        {"bench", required_argument, NULL, 'b'},
         {"help", no_argument, NULL, 'h'},
         {"information", no_argument, NULL, 'i'},
         {"port", no_argument, NULL, 'p'},
         {"example", required_argument, NULL, 'e'},
         {"test", required_argument, NULL, 't'},
         {"times", required_argument, NULL, 1},
+        {"priority", required_argument, NULL, 2},
+        {"cpu", required_argument, NULL, 3},
+        {"mlock", no_argument, NULL, 4},
         {NULL, 0, NULL, 0},
     };
     char type[33] = "unknown";
     uint32_t times = 3;
+    gpio_realtime_t realtime = {0, -1, 0};
     
     /* if no params */
     if (argc == 1)
@@ -190,6 +281,16 @@ uint8_t max30105(uint8_t argc, char **argv)
                 break;
             }
             
+            /* bench */
+            case 'b' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "b_%s", optarg);
+                
+                break;
+            }
+            
             /* example */
             case 'e' :
             {
@@ -219,6 +320,33 @@ uint8_t max30105(uint8_t argc, char **argv)
                 break;
             } 
             
+            /* realtime priority */
+            case 2 :
+            {
+                /* set the priority */
+                realtime.priority = atoi(optarg);
+                
+                break;
+            }
+            
+            /* cpu affinity */
+            case 3 :
+            {
+                /* set the cpu */
+                realtime.cpu = atoi(optarg);
+                
+                break;
+            }
+            
+            /* memory lock */
+            case 4 :
+            {
+                /* set the lock */
+                realtime.lock = 1;
+                
+                break;
+            }
+            
             /* the end */
             case -1 :
             {
@@ -249,6 +377,66 @@ uint8_t max30105(uint8_t argc, char **argv)
             return 0;
         }
     }
+    else if (strcmp("t_read", type) == 0)
+    {
+        uint8_t res;
+        
+        /* run read test */
+        res = max30105_read_test();
+        if (res != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_sim", type) == 0)
+    {
+        uint8_t res;
+        
+        /* run sim test */
+        res = max30105_sim_test();
+        if (res != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_trace", type) == 0)
+    {
+        uint8_t res;
+        
+        /* run trace test */
+        res = max30105_trace_test();
+        if (res != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_synth", type) == 0)
+    {
+        uint8_t res;
+        
+        /* run synth test */
+        res = max30105_synth_test(deadline_now);
+        if (res != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
     else if (strcmp("t_fifo", type) == 0)
     {
         uint8_t res;
@@ -284,20 +472,42 @@ uint8_t max30105(uint8_t argc, char **argv)
     else if (strcmp("e_fifo", type) == 0)
     {
         uint8_t res;
-        uint32_t timeout;
+        uint32_t i;
+        uint32_t len;
         uint32_t cnt;
+        uint64_t dropped;
+        max30105_sample_t sample[32];
+        latency_histogram_t callback;
+        latency_histogram_t data;
         
         /* get times */
         cnt = times;
         
+        /* stream init */
+        res = max30105_stream_init(&gs_stream);
+        if (res != 0)
+        {
+            return 1;
+        }
+        
+        /* set the realtime controls */
+        res = gpio_interrupt_set_realtime(&realtime);
+        if (res != 0)
+        {
+            (void)max30105_stream_deinit(&gs_stream);
+            
+            return 1;
+        }
+        
         /* set gpio irq */
-        g_gpio_irq = max30105_fifo_irq_handler;
+        g_gpio_irq = a_fifo_irq_handler;
         
         /* gpio init */
         res = gpio_interrupt_init();
         if (res != 0)
         {
             g_gpio_irq = NULL;
+            (void)max30105_stream_deinit(&gs_stream);
             
             return 1;
         }
@@ -308,55 +518,143 @@ uint8_t max30105(uint8_t argc, char **argv)
         {
             (void)gpio_interrupt_deinit();
             g_gpio_irq = NULL;
+            (void)max30105_stream_deinit(&gs_stream);
             
             return 1;
         }
         
-        /* timeout init */
-        gs_flag = 0;
-        timeout = 5000;
-        
         /* loop */
-        while (timeout != 0)
+        while (times != 0)
         {
-            /* check the flag */
-            if (gs_flag != 0)
+            /* wait for a batch */
+            len = 32;
+            res = max30105_stream_pop(&gs_stream, sample, &len, &dropped, 5000);
+            if (res != 0)
             {
-                max30105_interface_debug_print("max30105: %d/%d.\n", cnt - times + 1, cnt);
+                max30105_interface_debug_print("max30105: read timeout failed.\n");
+                (void)max30105_fifo_deinit();
+                (void)gpio_interrupt_deinit();
+                g_gpio_irq = NULL;
+                (void)max30105_stream_deinit(&gs_stream);
                 
-                /* clear config */
-                gs_flag = 0;
-                timeout = 5000;
-                times--;
-                if (times == 0)
+                return 1;
+            }
+            max30105_interface_debug_print("max30105: %d/%d.\n", cnt - times + 1, cnt);
+            max30105_interface_debug_print("max30105: %d samples from sequence %llu at %llu ns with %llu dropped.\n",
+                                           len, (unsigned long long)sample[0].sequence,
+                                           (unsigned long long)sample[0].timestamp, (unsigned long long)dropped);
+            for (i = 0; i < len; i++)
+            {
+                /* report the gap records */
+                if ((sample[i].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0)
                 {
-                    break;
+                    max30105_interface_debug_print("max30105: %d samples lost before sequence %llu.\n",
+                                                   sample[i].lost, (unsigned long long)sample[i].sequence);
                 }
             }
-            
-            /* delay 1ms */
-            max30105_interface_delay_ms(1);
-            timeout--;
+            times--;
+        }
+        
+        /* deinit */
+        (void)max30105_fifo_deinit();
+        (void)gpio_interrupt_deinit();
+        g_gpio_irq = NULL;
+        (void)max30105_stream_deinit(&gs_stream);
+        
+        /* report the latency */
+        gpio_interrupt_get_latency(&callback, &data);
+        latency_histogram_print(&callback, "edge to callback");
+        latency_histogram_print(&data, "edge to data ready");
+        
+        return 0;
+    }
+    else if (strcmp("e_poll", type) == 0)
+    {
+        uint8_t res;
+        uint8_t len;
+        uint32_t cnt;
+        uint64_t deadline;
+        max30105_sample_t sample[32];
+        
+        /* get times */
+        cnt = times;
+        
+        /* fifo init without the interrupt line */
+        res = max30105_fifo_init(max30105_receive_callback);
+        if (res != 0)
+        {
+            return 1;
         }
         
-        /* check timeout */
-        if (timeout == 0)
+        /* loop */
+        deadline = deadline_now();
+        while (times != 0)
         {
-            max30105_interface_debug_print("max30105: read timeout failed.\n");
-            (void)max30105_fifo_deinit();
-            (void)gpio_interrupt_deinit();
-            g_gpio_irq = NULL;
+            /* sleep until the batch is in the fifo */
+            res = deadline_sleep_until(deadline);
+            if (res != 0)
+            {
+                (void)max30105_fifo_deinit();
+                
+                return 1;
+            }
             
-            return 1;
+            /* read the batch and get the next deadline */
+            len = 32;
+            res = max30105_fifo_poll(deadline_now(), sample, &len, &deadline);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: poll failed.\n");
+                (void)max30105_fifo_deinit();
+                
+                return 1;
+            }
+            if (len == 0)
+            {
+                continue;
+            }
+            max30105_interface_debug_print("max30105: %d/%d.\n", cnt - times + 1, cnt);
+            max30105_interface_debug_print("max30105: %d samples from sequence %llu at %llu ns.\n",
+                                           len, (unsigned long long)sample[0].sequence,
+                                           (unsigned long long)sample[0].timestamp);
+            times--;
         }
         
         /* deinit */
         (void)max30105_fifo_deinit();
-        (void)gpio_interrupt_deinit();
-        g_gpio_irq = NULL;
         
         return 0;
     }
+    else if (strcmp("b_iic", type) == 0)
+    {
+        uint8_t res;
+        
+        /* run iic bench */
+        res = a_iic_bench(times);
+        if (res != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("b_read", type) == 0)
+    {
+        uint8_t res;
+        
+        /* run read path bench */
+        res = max30105_bench(times, deadline_now);
+        if (res != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
     else if (strcmp("h", type) == 0)
     {
         help:
@@ -366,15 +664,28 @@ uint8_t max30105(uint8_t argc, char **argv)
         max30105_interface_debug_print("  max30105 (-p | --port)\n");
         max30105_interface_debug_print("  max30105 (-t reg | --test=reg)\n");
         max30105_interface_debug_print("  max30105 (-t fifo | --test=fifo) [--times=<num>]\n");
-        max30105_interface_debug_print("  max30105 (-e fifo | --example=fifo) [--times=<num>]\n");
+        max30105_interface_debug_print("  max30105 (-t read | --test=read)\n");
+        max30105_interface_debug_print("  max30105 (-t sim | --test=sim)\n");
+        max30105_interface_debug_print("  max30105 (-t trace | --test=trace)\n");
+        max30105_interface_debug_print("  max30105 (-t synth | --test=synth)\n");
+        max30105_interface_debug_print("  max30105 (-e fifo | --example=fifo) [--times=<num>] [--priority=<num>] [--cpu=<num>] [--mlock]\n");
+        max30105_interface_debug_print("  max30105 (-e poll | --example=poll) [--times=<num>]\n");
+        max30105_interface_debug_print("  max30105 (-b iic | --bench=iic) [--times=<num>]\n");
+        max30105_interface_debug_print("  max30105 (-b read | --bench=read) [--times=<num>]\n");
         max30105_interface_debug_print("\n");
         max30105_interface_debug_print("Options:\n");
-        max30105_interface_debug_print("  -e <fifo>, --example=<fifo>    Run the driver example.\n");
+        max30105_interface_debug_print("  -b <iic | read>, --bench=<iic | read>\n");
+        max30105_interface_debug_print("                                 Run the benchmark.\n");
+        max30105_interface_debug_print("  -e <fifo | poll>, --example=<fifo | poll>\n");
+        max30105_interface_debug_print("                                 Run the driver example.\n");
         max30105_interface_debug_print("  -h, --help                     Show the help.\n");
         max30105_interface_debug_print("  -i, --information              Show the chip information.\n");
         max30105_interface_debug_print("  -p, --port                     Display the pin connections of the current board.\n");
-        max30105_interface_debug_print("  -t <reg | fifo>, --test=<reg | fifo>\n");
+        max30105_interface_debug_print("  -t <reg | fifo | read | sim | trace | synth>, --test=<reg | fifo | read | sim | trace | synth>\n");
         max30105_interface_debug_print("                                 Run the driver test.\n");
+        max30105_interface_debug_print("      --cpu=<num>                Pin the acquisition thread to a cpu.\n");
+        max30105_interface_debug_print("      --mlock                    Lock all pages in memory.\n");
+        max30105_interface_debug_print("      --priority=<num>           Run the acquisition thread with SCHED_FIFO priority 1 - 99.\n");
         max30105_interface_debug_print("      --times=<num>              Set the running times.([default: 3])\n");
         
         return 0;
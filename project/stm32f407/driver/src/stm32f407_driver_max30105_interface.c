@@ -96,6 +96,41 @@ uint8_t max30105_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, ui
     return iic_write(addr, reg, buf, len);
 }
 
+/**
+ * @brief         interface iic bus batch transfer
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          the soft iic has no repeated start chaining, so the transfers run one after another
+ */
+uint8_t max30105_interface_iic_transfer(uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    uint8_t i;
+    
+    for (i = 0; i < num; i++)
+    {
+        if (transfer[i].read != 0)
+        {
+            if (iic_read(addr, transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            if (iic_write(addr, transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)
+            {
+                return 1;
+            }
+        }
+    }
+    
+    return 0;
+}
+
 /**
  * @brief     interface delay ms
  * @param[in] ms time
@@ -179,3 +214,115 @@ void max30105_interface_receive_callback(uint8_t type)
         }
     }
 }
+
+/**
+ * @brief     interface iic bus init with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_init_ctx(void *user)
+{
+    (void)user;
+    
+    return max30105_interface_iic_init();
+}
+
+/**
+ * @brief     interface iic bus deinit with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_deinit_ctx(void *user)
+{
+    (void)user;
+    
+    return max30105_interface_iic_deinit();
+}
+
+/**
+ * @brief      interface iic bus read with a user context
+ * @param[in]  *user pointer to the bus context of the port
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t max30105_interface_iic_read_ctx(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    (void)user;
+    
+    return max30105_interface_iic_read(addr, reg, buf, len);
+}
+
+/**
+ * @brief     interface iic bus write with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t max30105_interface_iic_write_ctx(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    (void)user;
+    
+    return max30105_interface_iic_write(addr, reg, buf, len);
+}
+
+/**
+ * @brief         interface iic bus batch transfer with a user context
+ * @param[in]     *user pointer to the bus context of the port
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          none
+ */
+uint8_t max30105_interface_iic_transfer_ctx(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    (void)user;
+    
+    return max30105_interface_iic_transfer(addr, transfer, num);
+}
+
+/**
+ * @brief     interface delay ms with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] ms time
+ * @note      none
+ */
+void max30105_interface_delay_ms_ctx(void *user, uint32_t ms)
+{
+    (void)user;
+    
+    max30105_interface_delay_ms(ms);
+}
+
+/**
+ * @brief     interface receive callback with a user context
+ * @param[in] *user pointer to the bus context of the port
+ * @param[in] type irq type
+ * @note      none
+ */
+void max30105_interface_receive_callback_ctx(void *user, uint8_t type)
+{
+    (void)user;
+    
+    max30105_interface_receive_callback(type);
+}
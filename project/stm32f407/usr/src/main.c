@@ -37,6 +37,7 @@
 #include "driver_max30105_fifo.h"
 #include "driver_max30105_register_test.h"
 #include "driver_max30105_fifo_test.h"
+#include "driver_max30105_read_test.h"
 #include "shell.h"
 #include "clock.h"
 #include "delay.h"
@@ -282,6 +283,21 @@ uint8_t max30105(uint8_t argc, char **argv)
             return 0;
         }
     }
+    else if (strcmp("t_read", type) == 0)
+    {
+        uint8_t res;
+        
+        /* run read test */
+        res = max30105_read_test();
+        if (res != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
     else if (strcmp("t_fifo", type) == 0)
     {
         uint8_t res;
@@ -399,6 +415,7 @@ uint8_t max30105(uint8_t argc, char **argv)
         max30105_interface_debug_print("  max30105 (-p | --port)\n");
         max30105_interface_debug_print("  max30105 (-t reg | --test=reg)\n");
         max30105_interface_debug_print("  max30105 (-t fifo | --test=fifo) [--times=<num>]\n");
+        max30105_interface_debug_print("  max30105 (-t read | --test=read)\n");
         max30105_interface_debug_print("  max30105 (-e fifo | --example=fifo) [--times=<num>]\n");
         max30105_interface_debug_print("\n");
         max30105_interface_debug_print("Options:\n");
@@ -406,7 +423,7 @@ uint8_t max30105(uint8_t argc, char **argv)
         max30105_interface_debug_print("  -h, --help                     Show the help.\n");
         max30105_interface_debug_print("  -i, --information              Show the chip information.\n");
         max30105_interface_debug_print("  -p, --port                     Display the pin connections of the current board.\n");
-        max30105_interface_debug_print("  -t <reg | fifo>, --test=<reg | fifo>\n");
+        max30105_interface_debug_print("  -t <reg | fifo | read>, --test=<reg | fifo | read>\n");
         max30105_interface_debug_print("                                 Run the driver test.\n");
         max30105_interface_debug_print("      --times=<num>              Set the running times.([default: 3])\n");
         
@@ -81,484 +81,2426 @@
 #define MAX30105_REG_PART_ID                     0xFF        /**< part id register */
 
 /**
- * @brief     initialize the chip
+ * @brief shadow register definition
+ */
+#define MAX30105_SHADOW_ALL                      0x7FFF      /**< all shadow registers valid */
+
+/**
+ * @brief     add to a statistics counter
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FIELD counter name
+ * @param[in] N added value
+ */
+#if (MAX30105_STATS != 0)
+#define MAX30105_STATS_ADD(HANDLE, FIELD, N)    ((HANDLE)->stats.FIELD += (N))
+#else
+#define MAX30105_STATS_ADD(HANDLE, FIELD, N)
+#endif
+
+/**
+ * @brief     enter and exit a timed api, used in pairs after the handle checks
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] API timed api
+ * @param[in] RES status code of the call
+ * @note      MAX30105_STATS_EXIT evaluates to RES, every return after the enter goes through it
+ */
+#if (MAX30105_STATS != 0)
+#define MAX30105_STATS_ENTER(HANDLE)             a_max30105_stats_enter(HANDLE)
+#define MAX30105_STATS_EXIT(HANDLE, API, RES)    a_max30105_stats_exit(HANDLE, API, RES)
+#else
+#define MAX30105_STATS_ENTER(HANDLE)
+#define MAX30105_STATS_EXIT(HANDLE, API, RES)    (RES)
+#endif
+
+/**
+ * @brief     run the linked iic_init function
  * @param[in] *handle pointer to a max30105 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 iic initialization failed
- *            - 2 handle is NULL
- *            - 3 linked functions is NULL
- *            - 4 id is invalid
- *            - 5 reset failed
- *            - 6 reset fifo failed
- * @note      none
+ *            - 1 iic init failed
+ * @note      the ctx function is preferred when both are linked
  */
-uint8_t max30105_init(max30105_handle_t *handle)
+static uint8_t a_max30105_iic_init(max30105_handle_t *handle)
+{
+    if (handle->iic_init_ctx != NULL)                                                   /* check ctx function */
+    {
+        return handle->iic_init_ctx(handle->user);                                      /* init with the user context */
+    }
+    
+    return handle->iic_init();                                                          /* init */
+}
+
+/**
+ * @brief     run the linked iic_deinit function
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      the ctx function is preferred when both are linked
+ */
+static uint8_t a_max30105_iic_deinit(max30105_handle_t *handle)
+{
+    if (handle->iic_deinit_ctx != NULL)                                                 /* check ctx function */
+    {
+        return handle->iic_deinit_ctx(handle->user);                                    /* deinit with the user context */
+    }
+    
+    return handle->iic_deinit();                                                        /* deinit */
+}
+
+/**
+ * @brief      run the linked iic_read function
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the ctx function is preferred when both are linked
+ */
+static uint8_t a_max30105_iic_read(max30105_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
 {
     uint8_t res;
-    uint8_t prev;
-    uint8_t part_id;
     
-    if (handle == NULL)                                                                                     /* check handle */
+    if (handle->iic_read_ctx != NULL)                                              /* check ctx function */
     {
-        return 2;                                                                                           /* return error */
+        res = handle->iic_read_ctx(handle->user, MAX30105_ADDRESS, reg, buf, len); /* read with the user context */
     }
-    if (handle->debug_print == NULL)                                                                        /* check debug_print */
+    else
     {
-        return 3;                                                                                           /* return error */
+        res = handle->iic_read(MAX30105_ADDRESS, reg, buf, len);                   /* read */
+    }
+    MAX30105_STATS_ADD(handle, iic_read, 1);                                       /* count the call */
+    MAX30105_STATS_ADD(handle, read_bytes, (res == 0) ? len : 0);                  /* count the payload */
+    MAX30105_STATS_ADD(handle, iic_failed, (res != 0) ? 1 : 0);                    /* count the failure */
+    
+    return res;                                                                    /* return the result */
+}
+
+/**
+ * @brief     run the linked iic_write function
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the ctx function is preferred when both are linked
+ */
+static uint8_t a_max30105_iic_write(max30105_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint8_t res;
+    
+    if (handle->iic_write_ctx != NULL)                                              /* check ctx function */
+    {
+        res = handle->iic_write_ctx(handle->user, MAX30105_ADDRESS, reg, buf, len); /* write with the user context */
     }
-    if (handle->iic_init == NULL)                                                                           /* check iic_init */
+    else
     {
-        handle->debug_print("max30105: iic_init is null.\n");                                               /* iic_init is null */
+        res = handle->iic_write(MAX30105_ADDRESS, reg, buf, len);                   /* write */
+    }
+    MAX30105_STATS_ADD(handle, iic_write, 1);                                       /* count the call */
+    MAX30105_STATS_ADD(handle, write_bytes, (res == 0) ? len : 0);                  /* count the payload */
+    MAX30105_STATS_ADD(handle, iic_failed, (res != 0) ? 1 : 0);                     /* count the failure */
+    
+    return res;                                                                     /* return the result */
+}
+
+/**
+ * @brief         run several register accesses in one bus transaction
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          without a linked iic_transfer function each access runs on its own,
+ *                a port may run the accesses one after another too
+ */
+static uint8_t a_max30105_iic_transfer(max30105_handle_t *handle, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    uint8_t i;
+    uint8_t res;
+    
+    if ((handle->iic_transfer_ctx != NULL) || (handle->iic_transfer != NULL))                               /* check transfer function */
+    {
+        if (handle->iic_transfer_ctx != NULL)                                                               /* check ctx function */
+        {
+            res = handle->iic_transfer_ctx(handle->user, MAX30105_ADDRESS, transfer, num);                  /* transfer with the user context */
+        }
+        else
+        {
+            res = handle->iic_transfer(MAX30105_ADDRESS, transfer, num);                                    /* transfer */
+        }
+        MAX30105_STATS_ADD(handle, iic_transfer, 1);                                                        /* count the call */
+        MAX30105_STATS_ADD(handle, iic_failed, (res != 0) ? 1 : 0);                                         /* count the failure */
+#if (MAX30105_STATS != 0)
+        for (i = 0; (res == 0) && (i < num); i++)                                                           /* count the payload of each access */
+        {
+            if (transfer[i].read != 0)                                                                      /* check read */
+            {
+                handle->stats.read_bytes += transfer[i].len;                                                /* read payload */
+            }
+            else
+            {
+                handle->stats.write_bytes += transfer[i].len;                                               /* write payload */
+            }
+        }
+#endif
         
-        return 3;                                                                                           /* return error */
+        return res;                                                                                         /* return the result */
     }
-    if (handle->iic_deinit == NULL)                                                                         /* check iic_deinit */
+    for (i = 0; i < num; i++)                                                                               /* one access after another */
     {
-        handle->debug_print("max30105: iic_deinit is null.\n");                                             /* iic_deinit is null */
+        if (transfer[i].read != 0)                                                                          /* check read */
+        {
+            if (a_max30105_iic_read(handle, transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)        /* read */
+            {
+                return 1;                                                                                   /* return error */
+            }
+        }
+        else
+        {
+            if (a_max30105_iic_write(handle, transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)       /* write */
+            {
+                return 1;                                                                                   /* return error */
+            }
+        }
+    }
+    
+    return 0;                                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     run the linked delay_ms function
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] ms time
+ * @note      the ctx function is preferred when both are linked
+ */
+static void a_max30105_delay_ms(max30105_handle_t *handle, uint32_t ms)
+{
+    if (handle->delay_ms_ctx != NULL)                                                   /* check ctx function */
+    {
+        handle->delay_ms_ctx(handle->user, ms);                                         /* delay with the user context */
         
-        return 3;                                                                                           /* return error */
+        return;                                                                         /* return */
+    }
+    handle->delay_ms(ms);                                                               /* delay */
+}
+
+/**
+ * @brief     run the linked receive_callback function
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] type irq type
+ * @note      the ctx function is preferred when both are linked
+ */
+static void a_max30105_receive_callback(max30105_handle_t *handle, uint8_t type)
+{
+#if (MAX30105_STATS != 0)
+    if (type < 8)                                                                       /* check type */
+    {
+        handle->stats.irq[type]++;                                                      /* count the irq */
     }
-    if (handle->iic_read == NULL)                                                                           /* check iic_read */
+#endif
+    if (handle->receive_callback_ctx != NULL)                                           /* check ctx function */
     {
-        handle->debug_print("max30105: iic_read is null.\n");                                               /* iic_read is null */
+        handle->receive_callback_ctx(handle->user, type);                               /* run callback with the user context */
+    }
+    else if (handle->receive_callback != NULL)                                          /* check function */
+    {
+        handle->receive_callback(type);                                                 /* run callback */
+    }
+}
+
+#if (MAX30105_STATS != 0)
+/**
+ * @brief     enter a timed api call
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @note      only the outermost call of a nested chain starts the timing
+ */
+static void a_max30105_stats_enter(max30105_handle_t *handle)
+{
+    handle->stats_depth++;                                          /* one level deeper */
+    if (handle->stats_depth != 1)                                   /* check the outermost call */
+    {
+        return;                                                     /* return */
+    }
+    handle->stats_start = (handle->timestamp_ctx != NULL) ?
+                          handle->timestamp_ctx(handle->user) : 0;  /* get the start time */
+}
+
+/**
+ * @brief     exit a timed api call
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] api timed api
+ * @param[in] res status code of the call
+ * @return    status code of the call
+ * @note      calls nested in another timed api are not counted
+ */
+static uint8_t a_max30105_stats_exit(max30105_handle_t *handle, max30105_api_t api, uint8_t res)
+{
+    uint64_t ns;
+    
+    handle->stats_depth--;                                          /* one level up */
+    if (handle->stats_depth != 0)                                   /* check the outermost call */
+    {
+        return res;                                                 /* return the result */
+    }
+    handle->stats.api[api].calls++;                                 /* count the call */
+    if (handle->timestamp_ctx == NULL)                              /* check timestamp function */
+    {
+        return res;                                                 /* return the result */
+    }
+    ns = handle->timestamp_ctx(handle->user) - handle->stats_start; /* elapsed time */
+    handle->stats.api[api].ns += ns;                                /* add the time */
+    if (ns > handle->stats.api[api].max_ns)                         /* check the longest call */
+    {
+        handle->stats.api[api].max_ns = ns;                         /* set the longest call */
+    }
+    
+    return res;                                                     /* return the result */
+}
+#endif
+
+/**
+ * @brief      get the shadow index of a register
+ * @param[in]  reg register address
+ * @param[out] *index pointer to an index buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 register is not shadowed
+ * @note       0x02 - 0x03 => 0 - 1, 0x08 - 0x12 => 2 - 12, 0x21 => 13, 0x30 => 14
+ */
+static uint8_t a_max30105_shadow_index(uint8_t reg, uint8_t *index)
+{
+    if ((reg >= MAX30105_REG_INTERRUPT_ENABLE_1) && (reg <= MAX30105_REG_INTERRUPT_ENABLE_2))        /* interrupt enable */
+    {
+        *index = (uint8_t)(reg - MAX30105_REG_INTERRUPT_ENABLE_1);                                  /* 0 - 1 */
         
-        return 3;                                                                                           /* return error */
+        return 0;                                                                                   /* success return 0 */
     }
-    if (handle->iic_write == NULL)                                                                          /* check iic_write */
+    else if ((reg >= MAX30105_REG_FIFO_CONFIG) && (reg <= MAX30105_REG_MULTI_LED_MODE_CONTROL_2))   /* config */
     {
-        handle->debug_print("max30105: iic_write is null.\n");                                              /* iic_write is null */
+        *index = (uint8_t)(2 + reg - MAX30105_REG_FIFO_CONFIG);                                     /* 2 - 12 */
         
-        return 3;                                                                                           /* return error */
+        return 0;                                                                                   /* success return 0 */
     }
-    if (handle->receive_callback == NULL)                                                                   /* check receive_callback */
+    else if (reg == MAX30105_REG_DIE_TEMP_CONFIG)                                                   /* die temp config */
     {
-        handle->debug_print("max30105: receive_callback is null.\n");                                       /* receive_callback is null */
+        *index = 13;                                                                                /* 13 */
         
-        return 3;                                                                                           /* return error */
+        return 0;                                                                                   /* success return 0 */
+    }
+    else if (reg == MAX30105_REG_PROX_INT_THRESH)                                                   /* proximity threshold */
+    {
+        *index = 14;                                                                                /* 14 */
+        
+        return 0;                                                                                   /* success return 0 */
+    }
+    else
+    {
+        return 1;                                                                                   /* return error */
+    }
+}
+
+/**
+ * @brief     unpack one fifo word
+ * @param[in] p pointer to the first byte of the word
+ * @param[in] bit right shift of the adc resolution
+ */
+#define MAX30105_FIFO_WORD(p, bit) ((((uint32_t)(p)[0] << 16) | ((uint32_t)(p)[1] << 8) | ((uint32_t)(p)[2] << 0)) >> (bit))
+
+/**
+ * @brief     define a red mode decoder
+ * @param[in] res adc resolution bits
+ * @param[in] bit right shift of the adc resolution
+ * @note      none
+ */
+#define MAX30105_DECODER_RED(res, bit)                                                                      \
+static void a_max30105_decode_red_##res(const uint8_t *restrict buf, uint32_t len, uint32_t *restrict raw_red,  \
+                                        uint32_t *restrict raw_ir, uint32_t *restrict raw_green)            \
+{                                                                                                           \
+    uint32_t i;                                                                                             \
+                                                                                                            \
+    (void)raw_ir;                                                                                           \
+    (void)raw_green;                                                                                        \
+    for (i = 0; i < len; i++)                                                                               \
+    {                                                                                                       \
+        raw_red[i] = MAX30105_FIFO_WORD(buf, bit);                                                          \
+        buf += 3;                                                                                           \
+    }                                                                                                       \
+}
+
+/**
+ * @brief     define a red and ir mode decoder
+ * @param[in] res adc resolution bits
+ * @param[in] bit right shift of the adc resolution
+ * @note      none
+ */
+#define MAX30105_DECODER_RED_IR(res, bit)                                                                   \
+static void a_max30105_decode_red_ir_##res(const uint8_t *restrict buf, uint32_t len, uint32_t *restrict raw_red,  \
+                                           uint32_t *restrict raw_ir, uint32_t *restrict raw_green)         \
+{                                                                                                           \
+    uint32_t i;                                                                                             \
+                                                                                                            \
+    (void)raw_green;                                                                                        \
+    for (i = 0; i < len; i++)                                                                               \
+    {                                                                                                       \
+        raw_red[i] = MAX30105_FIFO_WORD(buf + 0, bit);                                                      \
+        raw_ir[i] = MAX30105_FIFO_WORD(buf + 3, bit);                                                       \
+        buf += 6;                                                                                           \
+    }                                                                                                       \
+}
+
+/**
+ * @brief     define a green, red and ir mode decoder
+ * @param[in] res adc resolution bits
+ * @param[in] bit right shift of the adc resolution
+ * @note      none
+ */
+#define MAX30105_DECODER_GREEN_RED_IR(res, bit)                                                             \
+static void a_max30105_decode_green_red_ir_##res(const uint8_t *restrict buf, uint32_t len,                 \
+                                                 uint32_t *restrict raw_red, uint32_t *restrict raw_ir,     \
+                                                 uint32_t *restrict raw_green)                              \
+{                                                                                                           \
+    uint32_t i;                                                                                             \
+                                                                                                            \
+    for (i = 0; i < len; i++)                                                                               \
+    {                                                                                                       \
+        raw_red[i] = MAX30105_FIFO_WORD(buf + 0, bit);                                                      \
+        raw_ir[i] = MAX30105_FIFO_WORD(buf + 3, bit);                                                       \
+        raw_green[i] = MAX30105_FIFO_WORD(buf + 6, bit);                                                    \
+        buf += 9;                                                                                           \
+    }                                                                                                       \
+}
+
+MAX30105_DECODER_RED(15, 3)                   /**< red mode with 15 bits */
+MAX30105_DECODER_RED(16, 2)                   /**< red mode with 16 bits */
+MAX30105_DECODER_RED(17, 1)                   /**< red mode with 17 bits */
+MAX30105_DECODER_RED(18, 0)                   /**< red mode with 18 bits */
+MAX30105_DECODER_RED_IR(15, 3)                /**< red and ir mode with 15 bits */
+MAX30105_DECODER_RED_IR(16, 2)                /**< red and ir mode with 16 bits */
+MAX30105_DECODER_RED_IR(17, 1)                /**< red and ir mode with 17 bits */
+MAX30105_DECODER_RED_IR(18, 0)                /**< red and ir mode with 18 bits */
+MAX30105_DECODER_GREEN_RED_IR(15, 3)          /**< green, red and ir mode with 15 bits */
+MAX30105_DECODER_GREEN_RED_IR(16, 2)          /**< green, red and ir mode with 16 bits */
+MAX30105_DECODER_GREEN_RED_IR(17, 1)          /**< green, red and ir mode with 17 bits */
+MAX30105_DECODER_GREEN_RED_IR(18, 0)          /**< green, red and ir mode with 18 bits */
+
+/**
+ * @brief decoder table indexed by the mode index and the adc resolution
+ * @note  bytes per sample and shift are constants in every decoder,
+ *        so each loop is branch-free and can be fully unrolled
+ */
+static void (*const gs_decoder[3][4])(const uint8_t *buf, uint32_t len, uint32_t *raw_red,
+                                      uint32_t *raw_ir, uint32_t *raw_green) =
+{
+    {a_max30105_decode_red_15, a_max30105_decode_red_16,
+     a_max30105_decode_red_17, a_max30105_decode_red_18},                                   /**< red mode */
+    {a_max30105_decode_red_ir_15, a_max30105_decode_red_ir_16,
+     a_max30105_decode_red_ir_17, a_max30105_decode_red_ir_18},                             /**< red and ir mode */
+    {a_max30105_decode_green_red_ir_15, a_max30105_decode_green_red_ir_16,
+     a_max30105_decode_green_red_ir_17, a_max30105_decode_green_red_ir_18},                 /**< green, red and ir mode */
+};
+
+/**
+ * @brief     define a sample decoder
+ * @param[in] name mode name
+ * @param[in] ch channel count of the mode
+ * @param[in] res adc resolution bits
+ * @param[in] bit right shift of the adc resolution
+ * @note      channels beyond ch are folded to 0 at compile time
+ */
+#define MAX30105_SAMPLE_DECODER(name, ch, res, bit)                                                         \
+static void a_max30105_decode_samples_##name##_##res(const uint8_t *restrict buf, uint32_t len,             \
+                                                     uint64_t sequence, max30105_sample_t *restrict sample) \
+{                                                                                                           \
+    uint32_t i;                                                                                             \
+                                                                                                            \
+    for (i = 0; i < len; i++)                                                                               \
+    {                                                                                                       \
+        sample[i].sequence = sequence + i;                                                                  \
+        sample[i].timestamp = 0;                                                                            \
+        sample[i].lost = 0;                                                                                 \
+        sample[i].red = MAX30105_FIFO_WORD(buf + 0, bit);                                                   \
+        sample[i].ir = ((ch) >= 2) ? MAX30105_FIFO_WORD(buf + 3, bit) : 0;                                  \
+        sample[i].green = ((ch) >= 3) ? MAX30105_FIFO_WORD(buf + 6, bit) : 0;                               \
+        sample[i].flags = ((sample[i].red == (0x3FFFFU >> (bit))) ||                                        \
+                           (sample[i].ir == (0x3FFFFU >> (bit))) ||                                         \
+                           (sample[i].green == (0x3FFFFU >> (bit)))) ? MAX30105_SAMPLE_FLAG_SATURATED : 0;  \
+        buf += (ch) * 3;                                                                                    \
+    }                                                                                                       \
+}
+
+MAX30105_SAMPLE_DECODER(red, 1, 15, 3)                   /**< red mode samples with 15 bits */
+MAX30105_SAMPLE_DECODER(red, 1, 16, 2)                   /**< red mode samples with 16 bits */
+MAX30105_SAMPLE_DECODER(red, 1, 17, 1)                   /**< red mode samples with 17 bits */
+MAX30105_SAMPLE_DECODER(red, 1, 18, 0)                   /**< red mode samples with 18 bits */
+MAX30105_SAMPLE_DECODER(red_ir, 2, 15, 3)                /**< red and ir mode samples with 15 bits */
+MAX30105_SAMPLE_DECODER(red_ir, 2, 16, 2)                /**< red and ir mode samples with 16 bits */
+MAX30105_SAMPLE_DECODER(red_ir, 2, 17, 1)                /**< red and ir mode samples with 17 bits */
+MAX30105_SAMPLE_DECODER(red_ir, 2, 18, 0)                /**< red and ir mode samples with 18 bits */
+MAX30105_SAMPLE_DECODER(green_red_ir, 3, 15, 3)          /**< green, red and ir mode samples with 15 bits */
+MAX30105_SAMPLE_DECODER(green_red_ir, 3, 16, 2)          /**< green, red and ir mode samples with 16 bits */
+MAX30105_SAMPLE_DECODER(green_red_ir, 3, 17, 1)          /**< green, red and ir mode samples with 17 bits */
+MAX30105_SAMPLE_DECODER(green_red_ir, 3, 18, 0)          /**< green, red and ir mode samples with 18 bits */
+
+/**
+ * @brief sample decoder table indexed by the mode index and the adc resolution
+ */
+static void (*const gs_sample_decoder[3][4])(const uint8_t *buf, uint32_t len, uint64_t sequence,
+                                             max30105_sample_t *sample) =
+{
+    {a_max30105_decode_samples_red_15, a_max30105_decode_samples_red_16,
+     a_max30105_decode_samples_red_17, a_max30105_decode_samples_red_18},                   /**< red mode */
+    {a_max30105_decode_samples_red_ir_15, a_max30105_decode_samples_red_ir_16,
+     a_max30105_decode_samples_red_ir_17, a_max30105_decode_samples_red_ir_18},             /**< red and ir mode */
+    {a_max30105_decode_samples_green_red_ir_15, a_max30105_decode_samples_green_red_ir_16,
+     a_max30105_decode_samples_green_red_ir_17, a_max30105_decode_samples_green_red_ir_18}, /**< green, red and ir mode */
+};
+
+/**
+ * @brief      get the decoder table index of a mode
+ * @param[in]  mode chip mode
+ * @param[out] *index pointer to a mode index buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 mode is invalid
+ * @note       red => 0, red and ir => 1, green, red and ir => 2
+ */
+static uint8_t a_max30105_mode_index(uint8_t mode, uint8_t *index)
+{
+    if (mode == MAX30105_MODE_RED)                                        /* check red mode */
+    {
+        *index = 0;                                                       /* 0 */
+    }
+    else if (mode == MAX30105_MODE_RED_IR)                                /* check red && ir mode */
+    {
+        *index = 1;                                                       /* 1 */
+    }
+    else if (mode == MAX30105_MODE_GREEN_RED_IR)                          /* check red && ir && green mode */
+    {
+        *index = 2;                                                       /* 2 */
+    }
+    else
+    {
+        return 1;                                                         /* return error */
+    }
+    
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief     check the decode buffers
+ * @param[in] index mode index
+ * @param[in] *buf pointer to a raw data buffer
+ * @param[in] *raw_red pointer to a red raw data buffer
+ * @param[in] *raw_ir pointer to an ir raw data buffer
+ * @param[in] *raw_green pointer to a green raw data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 buffer is NULL
+ * @note      raw_ir and raw_green are only needed when the mode fills them
+ */
+static uint8_t a_max30105_decode_check(uint8_t index, const uint8_t *buf, uint32_t *raw_red,
+                                       uint32_t *raw_ir, uint32_t *raw_green)
+{
+    if ((buf == NULL) || (raw_red == NULL))                               /* check buffer */
+    {
+        return 1;                                                         /* return error */
+    }
+    if ((index >= 1) && (raw_ir == NULL))                                 /* check ir buffer */
+    {
+        return 1;                                                         /* return error */
+    }
+    if ((index >= 2) && (raw_green == NULL))                              /* check green buffer */
+    {
+        return 1;                                                         /* return error */
+    }
+    
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief     select the decoder of the shadowed mode and adc resolution
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @note      the decoders are NULL until both registers are in the shadow
+ */
+static void a_max30105_decoder_select(max30105_handle_t *handle)
+{
+    uint8_t mode;
+    uint8_t spo2;
+    uint8_t index;
+    
+    handle->decoder = NULL;                                                         /* clear the decoder */
+    handle->sample_decoder = NULL;                                                  /* clear the sample decoder */
+    (void)a_max30105_shadow_index(MAX30105_REG_MODE_CONFIG, &mode);                 /* get mode config index */
+    (void)a_max30105_shadow_index(MAX30105_REG_SPO2_CONFIG, &spo2);                 /* get spo2 config index */
+    if ((handle->shadow_valid & (1U << mode)) == 0)                                 /* check mode config */
+    {
+        return;                                                                     /* not shadowed */
+    }
+    if ((handle->shadow_valid & (1U << spo2)) == 0)                                 /* check spo2 config */
+    {
+        return;                                                                     /* not shadowed */
+    }
+    if (a_max30105_mode_index(handle->shadow[mode] & 0x7, &index) != 0)             /* get mode index */
+    {
+        return;                                                                     /* mode is invalid */
+    }
+    handle->decoder = gs_decoder[index][handle->shadow[spo2] & 0x3];                /* select the decoder */
+    handle->sample_decoder = gs_sample_decoder[index][handle->shadow[spo2] & 0x3];  /* select the sample decoder */
+}
+
+/**
+ * @brief     clear the shadow and the state derived from the chip
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @note      the decoders, the fifo full edge, the clock estimation, the pending
+ *            interrupt edge and the pending overrun gap are all cleared with it
+ */
+static void a_max30105_shadow_clear(max30105_handle_t *handle)
+{
+    handle->shadow_valid = 0;                            /* clear the shadow */
+    handle->decoder = NULL;                              /* no decoder selected */
+    handle->sample_decoder = NULL;                       /* no sample decoder selected */
+    handle->fifo_known = 0;                              /* no fifo pointers */
+    handle->watermark_edge = 0;                          /* no fifo full edge to measure */
+    handle->clock_valid = 0;                             /* no clock estimation */
+    handle->clock_period = 0;                            /* no clock estimation */
+    handle->edge_pending = 0;                            /* no pending edge */
+    handle->edge_level = 0;                              /* no pending edge */
+    handle->edge_count = 0;                              /* no pending edge */
+    handle->edge_offset = 0;                             /* no pending edge */
+    handle->edge_timestamp = 0;                          /* no pending edge */
+    handle->gap_lost = 0;                                /* no pending gap */
+    handle->gap_after = 0;                               /* no pending gap */
+}
+
+/**
+ * @brief     save a register value to the shadow
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] reg register address
+ * @param[in] value register value
+ * @note      self-clearing bits are not kept in the shadow
+ */
+static void a_max30105_shadow_save(max30105_handle_t *handle, uint8_t reg, uint8_t value)
+{
+    uint8_t index;
+    uint8_t changed;
+    
+    if (a_max30105_shadow_index(reg, &index) != 0)                                      /* not shadowed */
+    {
+        return;                                                                         /* nothing to save */
+    }
+    changed = handle->shadow[index] ^ value;                                            /* changed bits */
+    if ((handle->shadow_valid & (1U << index)) == 0)                                    /* check the old value */
+    {
+        changed = 0xFF;                                                                 /* unknown, treat all bits as changed */
     }
-    if (handle->delay_ms == NULL)                                                                           /* check delay_ms */
+    if ((reg == MAX30105_REG_FIFO_CONFIG) && ((changed & 0xE0) != 0))                   /* averaging changes */
+    {
+        handle->clock_valid = 0;                                                        /* restart the clock estimation */
+    }
+    if ((reg == MAX30105_REG_SPO2_CONFIG) && ((changed & 0x1C) != 0))                   /* sample rate changes */
+    {
+        handle->clock_valid = 0;                                                        /* restart the clock estimation */
+    }
+    if (reg == MAX30105_REG_MODE_CONFIG)                                                /* mode config */
+    {
+        handle->shadow[index] = value & (uint8_t)(~(1 << 6));                           /* reset bit is self-cleared */
+    }
+    else if (reg == MAX30105_REG_DIE_TEMP_CONFIG)                                       /* die temp config */
+    {
+        handle->shadow[index] = value & (uint8_t)(~(1 << 0));                           /* temp enable bit is self-cleared */
+    }
+    else
+    {
+        handle->shadow[index] = value;                                                  /* save to the shadow */
+    }
+    handle->shadow_valid |= (uint16_t)(1U << index);                                    /* set valid */
+    if ((reg == MAX30105_REG_MODE_CONFIG) || (reg == MAX30105_REG_SPO2_CONFIG))         /* mode or adc resolution */
+    {
+        a_max30105_decoder_select(handle);                                              /* select the decoder */
+    }
+}
+
+/**
+ * @brief      read a register through the shadow
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[in]  reg register address
+ * @param[out] *value pointer to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the bus is only accessed when the shadow copy is invalid
+ */
+static uint8_t a_max30105_shadow_read(max30105_handle_t *handle, uint8_t reg, uint8_t *value)
+{
+    uint8_t index;
+    
+    if (a_max30105_shadow_index(reg, &index) != 0)                                      /* not shadowed */
+    {
+        return a_max30105_iic_read(handle, reg, value, 1);                              /* read from the bus */
+    }
+    if ((handle->shadow_valid & (1U << index)) != 0)                                    /* check valid */
+    {
+        *value = handle->shadow[index];                                                 /* get from the shadow */
+        
+        return 0;                                                                       /* success return 0 */
+    }
+    if (a_max30105_iic_read(handle, reg, value, 1) != 0)                                /* read from the bus */
+    {
+        return 1;                                                                       /* return error */
+    }
+    a_max30105_shadow_save(handle, reg, *value);                                        /* save to the shadow */
+    
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     write registers through the shadow in one burst
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] reg first register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_max30105_shadow_write_burst(max30105_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    uint8_t index;
+    
+    if (a_max30105_iic_write(handle, reg, buf, len) != 0)                               /* write to the bus */
+    {
+        for (i = 0; i < len; i++)                                                       /* invalidate all */
+        {
+            if (a_max30105_shadow_index((uint8_t)(reg + i), &index) == 0)               /* if shadowed */
+            {
+                handle->shadow_valid &= (uint16_t)(~(1U << index));                     /* the chip state is unknown */
+            }
+        }
+        
+        return 1;                                                                       /* return error */
+    }
+    for (i = 0; i < len; i++)                                                           /* update all */
+    {
+        a_max30105_shadow_save(handle, (uint8_t)(reg + i), buf[i]);                     /* save to the shadow */
+    }
+    
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief      read registers in one burst and refresh the shadow
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[in]  reg first register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the bus is always accessed
+ */
+static uint8_t a_max30105_shadow_read_burst(max30105_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    
+    if (a_max30105_iic_read(handle, reg, buf, len) != 0)                                /* read from the bus */
+    {
+        return 1;                                                                       /* return error */
+    }
+    for (i = 0; i < len; i++)                                                           /* update all */
+    {
+        a_max30105_shadow_save(handle, (uint8_t)(reg + i), buf[i]);                     /* save to the shadow */
+    }
+    
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     write a register through the shadow
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] reg register address
+ * @param[in] *value pointer to a value buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      self-clearing bits are not kept in the shadow
+ */
+static uint8_t a_max30105_shadow_write(max30105_handle_t *handle, uint8_t reg, uint8_t *value)
+{
+    return a_max30105_shadow_write_burst(handle, reg, value, 1);                        /* write one register */
+}
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 id is invalid
+ *            - 5 reset failed
+ *            - 6 reset fifo failed
+ * @note      none
+ */
+uint8_t max30105_init(max30105_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t prev;
+    uint8_t part_id;
+    
+    if (handle == NULL)                                                                                     /* check handle */
+    {
+        return 2;                                                                                           /* return error */
+    }
+    if (handle->debug_print == NULL)                                                                        /* check debug_print */
+    {
+        return 3;                                                                                           /* return error */
+    }
+    if ((handle->iic_init == NULL) && (handle->iic_init_ctx == NULL))                                       /* check iic_init */
+    {
+        handle->debug_print("max30105: iic_init is null.\n");                                               /* iic_init is null */
+        
+        return 3;                                                                                           /* return error */
+    }
+    if ((handle->iic_deinit == NULL) && (handle->iic_deinit_ctx == NULL))                                   /* check iic_deinit */
+    {
+        handle->debug_print("max30105: iic_deinit is null.\n");                                             /* iic_deinit is null */
+        
+        return 3;                                                                                           /* return error */
+    }
+    if ((handle->iic_read == NULL) && (handle->iic_read_ctx == NULL))                                       /* check iic_read */
+    {
+        handle->debug_print("max30105: iic_read is null.\n");                                               /* iic_read is null */
+        
+        return 3;                                                                                           /* return error */
+    }
+    if ((handle->iic_write == NULL) && (handle->iic_write_ctx == NULL))                                     /* check iic_write */
+    {
+        handle->debug_print("max30105: iic_write is null.\n");                                              /* iic_write is null */
+        
+        return 3;                                                                                           /* return error */
+    }
+    if ((handle->receive_callback == NULL) && (handle->receive_callback_ctx == NULL))                       /* check receive_callback */
+    {
+        handle->debug_print("max30105: receive_callback is null.\n");                                       /* receive_callback is null */
+        
+        return 3;                                                                                           /* return error */
+    }
+    if ((handle->delay_ms == NULL) && (handle->delay_ms_ctx == NULL))                                       /* check delay_ms */
+    {
+        handle->debug_print("max30105: delay_ms is null.\n");                                               /* delay_ms is null */
+        
+        return 3;                                                                                           /* return error */
+    }
+
+    if (a_max30105_iic_init(handle) != 0)                                                                   /* init iic */
+    {
+        handle->debug_print("max30105: iic init failed.\n");                                                /* iic init failed */
+        
+        return 1;                                                                                           /* return error */
+    }
+    res = a_max30105_iic_read(handle, MAX30105_REG_PART_ID, (uint8_t *)&part_id, 1);                        /* read part id */
+    if (res != 0)                                                                                           /* check result */
+    {
+        handle->debug_print("max30105: read part id failed.\n");                                            /* read part id failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 4;                                                                                           /* return error */
+    }
+    if (part_id != 0x15)                                                                                    /* check part id */
+    {
+        handle->debug_print("max30105: id is invalid.\n");                                                  /* id is invalid */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 4;                                                                                           /* return error */
+    }
+    res = a_max30105_iic_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);                       /* read mode config */
+    if (res != 0)                                                                                           /* check result */
+    {
+        handle->debug_print("max30105: read mode config failed.\n");                                        /* read mode config failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 5;                                                                                           /* return error */
+    }
+    prev &= ~(1 << 6);                                                                                      /* clear config */
+    prev |= 1 << 6;                                                                                         /* set 1 */
+    res = a_max30105_iic_write(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);                      /* write mode config */
+    if (res != 0)                                                                                           /* check result */
+    {
+        handle->debug_print("max30105: write mode config failed.\n");                                       /* write mode config failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 5;                                                                                           /* return error */
+    }
+    a_max30105_delay_ms(handle, 10);                                                                        /* delay 10 ms */
+    res = a_max30105_iic_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);                       /* read mode config */
+    if (res != 0)                                                                                           /* check result */
+    {
+        handle->debug_print("max30105: read mode config failed.\n");                                        /* read mode config failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 5;                                                                                           /* return error */
+    }
+    if ((prev & (1 << 6)) != 0)                                                                             /* check result */
+    {
+        handle->debug_print("max30105: reset failed.\n");                                                   /* reset failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 5;                                                                                           /* return error */
+    }
+    prev = 0;                                                                                               /* set zero */
+    res = a_max30105_iic_write(handle, MAX30105_REG_FIFO_READ_POINTER, (uint8_t *)&prev, 1);                /* write fifo read pointer */
+    if (res != 0)                                                                                           /* check result */
+    {
+        handle->debug_print("max30105: write fifo read pointer failed.\n");                                 /* write fifo read pointer failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 6;                                                                                           /* return error */
+    }
+    res = a_max30105_iic_write(handle, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)&prev, 1);               /* write fifo write pointer */
+    if (res != 0)                                                                                           /* check result */
+    {
+        handle->debug_print("max30105: write fifo write pointer failed.\n");                                /* write fifo write pointer failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 6;                                                                                           /* return error */
+    }
+    res = a_max30105_iic_write(handle, MAX30105_REG_OVERFLOW_COUNTER, (uint8_t *)&prev, 1);                 /* write overflow counter */
+    if (res != 0)                                                                                           /* check result */
+    {
+        handle->debug_print("max30105: write overflow counter failed.\n");                                  /* write overflow counter failed */
+        (void)a_max30105_iic_deinit(handle);                                                                /* iic deinit */
+        
+        return 6;                                                                                           /* return error */
+    }
+    a_max30105_shadow_clear(handle);                                                                        /* clear the shadow and the derived state */
+    handle->sequence = 0;                                                                                   /* start the sequence */
+    memset(&handle->loss, 0, sizeof(max30105_loss_t));                                                      /* clear the loss statistics */
+    handle->watermark_enable = 0;                                                                           /* no watermark control */
+    handle->poll_margin = 2;                                                                                /* default polling margin */
+    handle->poll_late = 0;                                                                                  /* no wake up latency yet */
+    handle->poll_calm = 0;                                                                                  /* restart the decay */
+    handle->inited = 1;                                                                                     /* flag finish initialization */
+    
+    return 0;                                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     close the chip
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 power down failed
+ * @note      none
+ */
+uint8_t max30105_deinit(max30105_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t prev;
+    
+    if (handle == NULL)                                                                              /* check handle */
+    {
+        return 2;                                                                                    /* return error */
+    }
+    if (handle->inited != 1)                                                                         /* check handle initialization */
+    {
+        return 3;                                                                                    /* return error */
+    }
+    
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                /* read mode config */
+    if (res != 0)                                                                                    /* check result */
+    {
+        handle->debug_print("max30105: read mode config failed.\n");                                 /* read mode config failed */
+       
+        return 4;                                                                                    /* return error */
+    }
+    prev &= ~(1 << 7);                                                                               /* clear config */
+    prev |= 1 << 7;                                                                                  /* set bool */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);               /* write mode config */
+    if (res != 0)                                                                                    /* check result */
+    {
+        handle->debug_print("max30105: write mode config failed.\n");                                /* write mode config failed */
+       
+        return 4;                                                                                    /* return error */
+    }
+    if (a_max30105_iic_deinit(handle) != 0)                                                          /* iic deinit */
+    {
+        handle->debug_print("max30105: iic deinit failed.\n");                                       /* iic deinit failed */
+        
+        return 1;                                                                                    /* return error */
+    }
+    
+    a_max30105_shadow_clear(handle);                                                                 /* clear the shadow */
+    handle->inited = 0;                                                                              /* flag close */
+    
+    return 0;                                                                                        /* success return 0 */
+}
+
+/**
+ * @brief      get the number of samples in the fifo from the pointers
+ * @param[in]  *point pointer to the fifo write point, overflow counter and read point
+ * @param[out] *level pointer to a level buffer
+ * @param[out] *overflow pointer to an overflow counter buffer
+ * @note       equal pointers mean empty unless the overflow counter is set
+ */
+static void a_max30105_fifo_point_level(const uint8_t *point, uint8_t *level, uint8_t *overflow)
+{
+    uint8_t read_point;
+    uint8_t write_point;
+    
+    write_point = point[0] & 0x1F;                                                                                /* get fifo write point */
+    *overflow = point[1] & 0x1F;                                                                                  /* get overflow counter */
+    read_point = point[2] & 0x1F;                                                                                 /* get fifo read point */
+    if (write_point != read_point)                                                                                /* check point */
+    {
+        *level = (write_point - read_point) & 0x1F;                                                               /* get length */
+    }
+    else if ((*overflow) != 0)                                                                                    /* check overflow */
+    {
+        *level = 32;                                                                                              /* fifo is full */
+    }
+    else
+    {
+        *level = 0;                                                                                               /* fifo is empty */
+    }
+}
+
+/**
+ * @brief      get the number of samples in the fifo
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *level pointer to a level buffer
+ * @param[out] *overflow pointer to an overflow counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get fifo level failed
+ * @note       equal pointers mean empty unless the overflow counter is set
+ */
+static uint8_t a_max30105_fifo_level(max30105_handle_t *handle, uint8_t *level, uint8_t *overflow)
+{
+    uint8_t res;
+    uint8_t point[3];
+    
+    res = a_max30105_iic_read(handle, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)point, 3);                      /* read fifo write point, overflow counter and read point */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("max30105: read fifo pointer failed.\n");                                             /* read fifo pointer failed */
+        
+        return 1;                                                                                                 /* return error */
+    }
+    a_max30105_fifo_point_level(point, level, overflow);                                                          /* get the level */
+    
+    return 0;                                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     irq handler
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      with a linked iic_transfer function the fifo pointers are read with the interrupt status,
+ *            the fifo drain and the data ready edge then take the level from them
+ */
+uint8_t max30105_irq_handler(max30105_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t prev;
+    uint8_t known;
+    uint8_t status[2];
+    uint8_t point[3];
+    max30105_iic_transfer_t transfer[2];
+    
+    if (handle == NULL)                                                                                            /* check handle */
+    {
+        return 2;                                                                                                  /* return error */
+    }
+    if (handle->inited != 1)                                                                                       /* check handle initialization */
+    {
+        return 3;                                                                                                  /* return error */
+    }
+    
+    MAX30105_STATS_ENTER(handle);                                                                                  /* enter the timed api */
+    known = 0;                                                                                                     /* no fifo pointers */
+    if ((handle->iic_transfer_ctx != NULL) || (handle->iic_transfer != NULL))                                      /* check transfer function */
+    {
+        transfer[0].reg = MAX30105_REG_INTERRUPT_STATUS_1;                                                         /* interrupt status1 and status2 */
+        transfer[0].read = 1;                                                                                      /* read */
+        transfer[0].buf = status;                                                                                  /* set buffer */
+        transfer[0].len = 2;                                                                                       /* 2 registers */
+        transfer[1].reg = MAX30105_REG_FIFO_WRITE_POINTER;                                                         /* fifo write point, overflow counter and read point */
+        transfer[1].read = 1;                                                                                      /* read */
+        transfer[1].buf = point;                                                                                   /* set buffer */
+        transfer[1].len = 3;                                                                                       /* 3 registers */
+        res = a_max30105_iic_transfer(handle, transfer, 2);                                                        /* read the status and the pointers at once */
+        known = 1;                                                                                                 /* the pointers come with the status */
+    }
+    else
+    {
+        res = a_max30105_iic_read(handle, MAX30105_REG_INTERRUPT_STATUS_1, (uint8_t *)status, 2);                  /* read interrupt status1 and status2 */
+    }
+    if (res != 0)                                                                                                  /* check result */
+    {
+        handle->debug_print("max30105: read interrupt status failed.\n");                                          /* read interrupt status failed */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_IRQ_HANDLER, 1);                                           /* return error */
+    }
+    if ((status[0] & (1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL)) != 0)                                             /* check fifo full */
+    {
+        res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);                          /* read fifo config */
+        if (res != 0)                                                                                              /* check result */
+        {
+            handle->debug_print("max30105: read fifo config failed.\n");                                           /* read fifo config failed */
+           
+            return MAX30105_STATS_EXIT(handle, MAX30105_API_IRQ_HANDLER, 1);                                       /* return error */
+        }
+        handle->edge_level = (uint8_t)(32 - (prev & 0xF));                                                         /* the edge is at the almost full level */
+        handle->edge_count = handle->edge_level;                                                                   /* samples up to the edge sample */
+        handle->watermark_edge = 1;                                                                                /* measure the service latency */
+    }
+    else if ((status[0] & (1 << MAX30105_INTERRUPT_STATUS_DATA_RDY)) == 0)                                         /* check data ready */
+    {
+        handle->edge_pending = 0;                                                                                  /* the edge is not from a sample */
+    }
+    else if (handle->edge_pending != 0)                                                                            /* check pending edge */
+    {
+        uint8_t level;
+        
+        if (known != 0)                                                                                            /* check fifo pointers */
+        {
+            a_max30105_fifo_point_level(point, (uint8_t *)&level, (uint8_t *)&prev);                               /* the edge is at the newest sample */
+        }
+        else
+        {
+            res = a_max30105_fifo_level(handle, (uint8_t *)&level, (uint8_t *)&prev);                              /* the edge is at the newest sample */
+            if (res != 0)                                                                                          /* check result */
+            {
+                return MAX30105_STATS_EXIT(handle, MAX30105_API_IRQ_HANDLER, 1);                                   /* return error */
+            }
+        }
+        handle->edge_count = level;                                                                                /* samples up to the edge sample */
+        handle->edge_pending = (level != 0) ? 1 : 0;                                                               /* an empty fifo was drained after the edge */
+    }
+    if ((status[0] & (1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL)) != 0)                                             /* check fifo full */
+    {
+        if (handle->irq_fifo_drain != 0)                                                                           /* check fifo drain */
+        {
+            handle->irq_fifo_len = 32;                                                                             /* drain the whole fifo */
+            handle->fifo_point[0] = point[0];                                                                      /* hand the fifo pointers to the drain */
+            handle->fifo_point[1] = point[1];                                                                      /* hand the fifo pointers to the drain */
+            handle->fifo_point[2] = point[2];                                                                      /* hand the fifo pointers to the drain */
+            handle->fifo_known = known;                                                                            /* set known */
+            res = max30105_read(handle, handle->irq_raw_red, handle->irq_raw_ir,                                   /* read the fifo */
+                               handle->irq_raw_green, (uint8_t *)&handle->irq_fifo_len);                           /* read the fifo */
+            handle->fifo_known = 0;                                                                                /* the pointers are only fresh in this call */
+            if ((res != 0) && (res != 4))                                                                          /* check result */
+            {
+                handle->irq_fifo_len = 0;                                                                          /* clear length */
+                handle->debug_print("max30105: drain fifo failed.\n");                                             /* drain fifo failed */
+                
+                return MAX30105_STATS_EXIT(handle, MAX30105_API_IRQ_HANDLER, 1);                                   /* return error */
+            }
+        }
+        a_max30105_receive_callback(handle, MAX30105_INTERRUPT_STATUS_FIFO_FULL);                                  /* run callback */
+    }
+    if ((status[0] & (1 << MAX30105_INTERRUPT_STATUS_DATA_RDY)) != 0)                                              /* check data ready */
+    {
+        a_max30105_receive_callback(handle, MAX30105_INTERRUPT_STATUS_DATA_RDY);                                   /* run callback */
+    }
+    if ((status[0] & (1 << MAX30105_INTERRUPT_STATUS_ALC_OVF)) != 0)                                               /* check alc ovf */
+    {
+        a_max30105_receive_callback(handle, MAX30105_INTERRUPT_STATUS_ALC_OVF);                                    /* run callback */
+    }
+    if ((status[0] & (1 << MAX30105_INTERRUPT_STATUS_PROX_INT)) != 0)                                              /* check proxy int */
+    {
+        a_max30105_receive_callback(handle, MAX30105_INTERRUPT_STATUS_PROX_INT);                                   /* run callback */
+    }
+    if ((status[0] & (1 << MAX30105_INTERRUPT_STATUS_PWR_RDY)) != 0)                                               /* check pwr ready */
+    {
+        a_max30105_shadow_clear(handle);                                                                           /* registers and fifo are in the power on state */
+        a_max30105_receive_callback(handle, MAX30105_INTERRUPT_STATUS_PWR_RDY);                                    /* run callback */
+    }
+    if ((status[1] & (1 << MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY)) != 0)                                          /* check die temp ready */
+    {
+        uint8_t temp[2];
+        
+        res = a_max30105_iic_read(handle, MAX30105_REG_DIE_TEMP_INTEGER, (uint8_t *)temp, 2);                      /* read die temp integer and fraction */
+        if (res != 0)                                                                                              /* check result */
+        {
+            handle->debug_print("max30105: read die temp failed.\n");                                              /* read die temp failed */
+           
+            return MAX30105_STATS_EXIT(handle, MAX30105_API_IRQ_HANDLER, 1);                                       /* return error */
+        }
+        handle->raw = ((uint16_t)temp[0] << 4) | temp[1];                                                          /* set integer and fraction part */
+        handle->temperature = (float)((int8_t)(temp[0])) + (float)(temp[1] & 0x0F) * 0.0625f;                      /* set the temperature */
+        handle->finished_flag = 1;                                                                                 /* set flag */
+        
+        a_max30105_receive_callback(handle, MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY);                               /* run callback */
+    }
+    
+    return MAX30105_STATS_EXIT(handle, MAX30105_API_IRQ_HANDLER, 0);                                               /* success return 0 */
+}
+
+/**
+ * @brief     track the samples lost in the last fifo read
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 read fifo config failed
+ * @note      with fifo roll the oldest samples are overwritten, so the gap is
+ *            before the samples in the fifo, otherwise it is after them,
+ *            another overrun before the pending gap is drained adds its samples
+ *            to it and keeps the earliest position
+ */
+static uint8_t a_max30105_gap_update(max30105_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t prev;
+    uint8_t after;
+    
+    if (handle->fifo_lost == 0)                                                               /* check lost samples */
+    {
+        return 0;                                                                             /* success return 0 */
+    }
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);         /* read fifo config */
+    if (res != 0)                                                                             /* check result */
+    {
+        handle->debug_print("max30105: read fifo config failed.\n");                          /* read fifo config failed */
+       
+        return 1;                                                                             /* return error */
+    }
+    after = ((prev & (1 << 4)) != 0) ? 0 : handle->fifo_level;                                /* position of this gap */
+    if ((handle->gap_lost == 0) || (after < handle->gap_after))                               /* check the earliest gap */
+    {
+        handle->gap_after = after;                                                            /* set the gap position */
+    }
+    handle->gap_lost += handle->fifo_lost;                                                    /* add to the pending gap */
+    handle->loss.lost += handle->fifo_lost;                                                   /* add to the total */
+    handle->loss.overruns++;                                                                  /* count the overrun */
+    MAX30105_STATS_ADD(handle, overflows, 1);                                                 /* count the overrun */
+    if (handle->fifo_lost == 0x1F)                                                            /* check saturated counter */
+    {
+        handle->loss.saturated++;                                                             /* the loss is a lower bound */
+    }
+    handle->fifo_lost = 0;                                                                    /* lost samples are counted */
+    
+    return 0;                                                                                 /* success return 0 */
+}
+
+/**
+ * @brief     advance the sample sequence over the drained samples
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] len number of drained samples
+ * @note      the pending gap is applied once the drained samples reach it,
+ *            the batch keeps its first sequence and gap for a_max30105_sequence_flag
+ */
+static void a_max30105_sequence_commit(max30105_handle_t *handle, uint8_t len)
+{
+    handle->batch_sequence = handle->sequence;                                                /* first sequence of this batch */
+    handle->batch_lost = 0;                                                                   /* no gap in this batch */
+    handle->batch_gap = 0;                                                                    /* no gap in this batch */
+    if ((handle->gap_lost != 0) && (handle->gap_after < len))                                 /* check gap in this batch */
+    {
+        handle->batch_lost = handle->gap_lost;                                                /* record the gap */
+        handle->batch_gap = handle->gap_after;                                                /* record the gap */
+        handle->sequence += handle->gap_lost;                                                 /* skip the lost samples */
+        handle->gap_lost = 0;                                                                 /* clear the gap */
+        handle->gap_after = 0;                                                                /* clear the gap */
+    }
+    else if (handle->gap_lost != 0)                                                           /* gap is after this batch */
+    {
+        handle->gap_after = (uint8_t)(handle->gap_after - len);                               /* move the gap position */
+    }
+    handle->sequence += len;                                                                  /* advance the sequence */
+    MAX30105_STATS_ADD(handle, samples, len);                                                 /* count the delivered samples */
+}
+
+/**
+ * @brief     flag the gap of the last drained batch in its samples
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *sample pointer to a sample buffer
+ * @param[in] len number of drained samples
+ * @note      samples are decoded from the first sequence of the batch
+ */
+static void a_max30105_sequence_flag(max30105_handle_t *handle, max30105_sample_t *sample, uint8_t len)
+{
+    uint8_t i;
+    
+    if ((handle->batch_lost == 0) || (handle->batch_gap >= len))                              /* check gap in this batch */
+    {
+        return;                                                                               /* return */
+    }
+    sample[handle->batch_gap].flags |= MAX30105_SAMPLE_FLAG_OVERFLOW_GAP;                     /* flag the gap */
+    sample[handle->batch_gap].lost = handle->batch_lost;                                      /* record the gap */
+    for (i = handle->batch_gap; i < len; i++)                                                 /* samples after the gap */
+    {
+        sample[i].sequence += handle->batch_lost;                                             /* skip the lost samples */
+    }
+}
+
+/**
+ * @brief      get the configured sample period
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *period pointer to a period buffer in ns << 8
+ * @return     status code
+ *             - 0 success
+ *             - 1 read config failed
+ * @note       sample rate divided by the averaging factor
+ */
+static uint8_t a_max30105_clock_nominal(max30105_handle_t *handle, uint64_t *period)
+{
+    const uint16_t rate[8] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+    uint8_t res;
+    uint8_t fifo;
+    uint8_t spo2;
+    uint8_t avg;
+    
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&fifo);         /* read fifo config */
+    if (res != 0)                                                                             /* check result */
+    {
+        handle->debug_print("max30105: read fifo config failed.\n");                          /* read fifo config failed */
+       
+        return 1;                                                                             /* return error */
+    }
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&spo2);         /* read spo2 config */
+    if (res != 0)                                                                             /* check result */
+    {
+        handle->debug_print("max30105: read spo2 config failed.\n");                          /* read spo2 config failed */
+       
+        return 1;                                                                             /* return error */
+    }
+    avg = (uint8_t)((fifo >> 5) & 0x7);                                                       /* get sample averaging */
+    avg = (avg > 5) ? 5 : avg;                                                                /* 0x5 - 0x7 are 32 */
+    *period = ((1000000000ULL << 8) << avg) / rate[(spo2 >> 2) & 0x7];                       /* ns << 8 */
+    
+    return 0;                                                                                 /* success return 0 */
+}
+
+/**
+ * @brief     update the clock estimation with an edge
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] sequence sequence number of the sample that raised the edge
+ * @param[in] ns edge time in ns
+ * @return    status code
+ *            - 0 success
+ *            - 1 read config failed
+ * @note      a phase and frequency locked loop, the period is kept within 5% of the nominal one
+ */
+static uint8_t a_max30105_clock_update(max30105_handle_t *handle, uint64_t sequence, uint64_t ns)
+{
+    int64_t d;
+    int64_t e;
+    uint64_t predict;
+    
+    if (handle->clock_valid == 0)                                                             /* check clock */
+    {
+        if (a_max30105_clock_nominal(handle, &handle->clock_nominal) != 0)                    /* get nominal period */
+        {
+            return 1;                                                                         /* return error */
+        }
+        handle->clock_period = handle->clock_nominal;                                         /* start from the nominal period */
+        handle->clock_sequence = sequence;                                                    /* set reference */
+        handle->clock_time = ns;                                                              /* set reference */
+        handle->clock_valid = 1;                                                              /* set valid */
+        
+        return 0;                                                                             /* success return 0 */
+    }
+    d = (int64_t)(sequence - handle->clock_sequence);                                         /* samples since the reference */
+    if (d <= 0)                                                                               /* check order */
+    {
+        return 0;                                                                             /* nothing to learn */
+    }
+    predict = handle->clock_time + (uint64_t)((d * (int64_t)handle->clock_period) / 256);     /* predicted edge time */
+    e = (int64_t)(ns - predict);                                                              /* phase error */
+    handle->clock_period = (uint64_t)((int64_t)handle->clock_period + (e * 256 / d) / 8);     /* frequency correction */
+    if (handle->clock_period > handle->clock_nominal + handle->clock_nominal / 20)            /* check upper limit */
+    {
+        handle->clock_period = handle->clock_nominal + handle->clock_nominal / 20;            /* clamp */
+    }
+    if (handle->clock_period < handle->clock_nominal - handle->clock_nominal / 20)            /* check lower limit */
+    {
+        handle->clock_period = handle->clock_nominal - handle->clock_nominal / 20;            /* clamp */
+    }
+    handle->clock_sequence = sequence;                                                        /* move reference */
+    handle->clock_time = (uint64_t)((int64_t)predict + e / 4);                                /* phase correction */
+    
+    return 0;                                                                                 /* success return 0 */
+}
+
+/**
+ * @brief     timestamp samples from the clock estimation
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *sample pointer to a sample buffer
+ * @param[in] len number of samples
+ * @note      samples keep timestamp 0 until the first edge is matched
+ */
+static void a_max30105_timestamp_fill(max30105_handle_t *handle, max30105_sample_t *sample, uint8_t len)
+{
+    uint8_t i;
+    int64_t d;
+    
+    if (handle->clock_valid == 0)                                                             /* check clock */
+    {
+        return;                                                                               /* no estimation */
+    }
+    for (i = 0; i < len; i++)                                                                 /* all samples */
+    {
+        d = (int64_t)(sample[i].sequence - handle->clock_sequence);                           /* samples from the reference */
+        sample[i].timestamp = (uint64_t)((int64_t)handle->clock_time +
+                                         (d * (int64_t)handle->clock_period) / 256);          /* back-compute the time */
+    }
+}
+
+/**
+ * @brief     adapt the fifo almost full watermark
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 set fifo almost full failed
+ * @note      the samples that arrived between the fifo full edge and the read measure the service latency,
+ *            every interrupt costs the same bus transactions, so the watermark is kept as high as the
+ *            peak latency plus the margin allows, an overrun jumps back to the safest watermark
+ */
+static uint8_t a_max30105_watermark_update(max30105_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t prev;
+    uint8_t excess;
+    uint8_t target;
+    
+    if ((handle->watermark_enable == 0) || (handle->watermark_edge == 0))                      /* check fifo full edge */
+    {
+        return 0;                                                                             /* success return 0 */
+    }
+    handle->watermark_edge = 0;                                                               /* edge is measured */
+    if (handle->fifo_lost != 0)                                                               /* check overrun */
+    {
+        handle->watermark_peak = 15;                                                          /* back to the safest watermark */
+        handle->watermark_calm = 0;                                                           /* restart the decay */
+    }
+    else
+    {
+        excess = (handle->fifo_level > handle->edge_level) ?
+                 (uint8_t)(handle->fifo_level - handle->edge_level) : 0;                     /* samples arrived while serving */
+        if (excess >= handle->watermark_peak)                                                 /* check peak */
+        {
+            handle->watermark_peak = excess;                                                  /* new peak */
+            handle->watermark_calm = 0;                                                       /* restart the decay */
+        }
+        else
+        {
+            handle->watermark_calm++;                                                         /* one more calm interrupt */
+            if (handle->watermark_calm >= 4)                                                  /* 4 calm interrupts */
+            {
+                handle->watermark_peak--;                                                     /* decay the peak */
+                handle->watermark_calm = 0;                                                   /* restart the decay */
+            }
+        }
+    }
+    target = (uint8_t)(handle->watermark_peak + handle->watermark_margin);                    /* empty slots to keep */
+    target = (target > 0xF) ? 0xF : target;                                                   /* 4 bits */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);         /* read fifo config */
+    if (res != 0)                                                                             /* check result */
+    {
+        handle->debug_print("max30105: read fifo config failed.\n");                          /* read fifo config failed */
+       
+        return 1;                                                                             /* return error */
+    }
+    if ((prev & 0xF) == target)                                                               /* check watermark */
+    {
+        return 0;                                                                             /* success return 0 */
+    }
+    prev &= ~0xF;                                                                             /* clear config */
+    prev |= target;                                                                           /* set watermark */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);        /* write fifo config */
+    if (res != 0)                                                                             /* check result */
+    {
+        handle->debug_print("max30105: write fifo config failed.\n");                         /* write fifo config failed */
+       
+        return 1;                                                                             /* return error */
+    }
+    
+    return 0;                                                                                 /* success return 0 */
+}
+
+/**
+ * @brief     track the wake up latency of the polling thread
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] batch samples expected at the wake up
+ * @note      samples beyond the expected batch measure how late the thread woke up,
+ *            the decaying peak of that shrinks the next batch, an overrun halves it
+ */
+static void a_max30105_poll_update(max30105_handle_t *handle, uint8_t batch)
+{
+    uint8_t late;
+    
+    if (handle->fifo_lost != 0)                                                               /* check overrun */
+    {
+        handle->poll_late = (uint8_t)(handle->poll_late + batch / 2);                         /* halve the batch */
+        handle->poll_calm = 0;                                                                /* restart the decay */
+        
+        return;                                                                               /* lateness is unknown */
+    }
+    late = (handle->fifo_level > batch) ? (uint8_t)(handle->fifo_level - batch) : 0;          /* samples over the batch */
+    if ((late != 0) && (late >= handle->poll_late))                                           /* check peak */
+    {
+        handle->poll_late = late;                                                             /* new peak */
+        handle->poll_calm = 0;                                                                /* restart the decay */
+    }
+    else if (handle->poll_late != 0)                                                          /* check decay */
+    {
+        handle->poll_calm++;                                                                  /* one more calm poll */
+        if (handle->poll_calm >= 4)                                                           /* 4 calm polls */
+        {
+            handle->poll_late--;                                                              /* decay the peak */
+            handle->poll_calm = 0;                                                            /* restart the decay */
+        }
+    }
+}
+
+/**
+ * @brief     follow the edge sample through a fifo read
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] level fifo level before the read
+ * @param[in] len number of popped samples
+ * @note      an edge sample left in the fifo moves towards the read pointer,
+ *            a popped one is located in the batch for a_max30105_edge_match
+ */
+static void a_max30105_edge_follow(max30105_handle_t *handle, uint8_t level, uint8_t len)
+{
+    uint8_t count;
+    
+    if ((handle->edge_pending != 1) || (len == 0))                                        /* check pending edge */
+    {
+        return;                                                                           /* return */
+    }
+    count = ((handle->edge_count != 0) && (handle->edge_count <= level)) ?                /* samples up to the edge sample, */
+            handle->edge_count : level;                                                   /* the newest one when unknown */
+    if (count > len)                                                                      /* check the edge sample is still in the fifo */
+    {
+        handle->edge_count = (uint8_t)(count - len);                                      /* anchor it to the new read pointer */
+        
+        return;                                                                           /* return */
+    }
+    handle->edge_offset = (uint8_t)(count - 1);                                           /* index of the edge sample in the batch */
+    handle->edge_pending = 2;                                                             /* located */
+}
+
+/**
+ * @brief     match a located edge to the sequence of its sample
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 update the clock failed
+ * @note      call it before the sequence commit of the batch that holds the edge sample
+ */
+static uint8_t a_max30105_edge_match(max30105_handle_t *handle)
+{
+    uint64_t sequence;
+    
+    if (handle->edge_pending != 2)                                                        /* check located edge */
+    {
+        return 0;                                                                         /* success return 0 */
+    }
+    handle->edge_pending = 0;                                                             /* edge is matched */
+    sequence = handle->sequence + handle->edge_offset;                                    /* sequence of the edge sample */
+    if ((handle->gap_lost != 0) && (handle->gap_after <= handle->edge_offset))            /* check the gap is before it */
+    {
+        sequence += handle->gap_lost;                                                     /* skip the lost samples */
+    }
+    
+    return a_max30105_clock_update(handle, sequence, handle->edge_timestamp);             /* update the clock */
+}
+
+/**
+ * @brief     account the samples of a fifo read
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] len number of popped samples
+ * @return    status code
+ *            - 0 success
+ *            - 1 account failed
+ * @note      adapts the watermark, records an overrun as a gap, matches the edge and advances
+ *            the sequence, so every path that pops the fifo keeps the same sample sequence
+ */
+static uint8_t a_max30105_fifo_account(max30105_handle_t *handle, uint8_t len)
+{
+    if (a_max30105_watermark_update(handle) != 0)                                         /* adapt the watermark */
+    {
+        return 1;                                                                         /* return error */
+    }
+    if (a_max30105_gap_update(handle) != 0)                                               /* track the lost samples */
+    {
+        return 1;                                                                         /* return error */
+    }
+    if (len == 0)                                                                         /* check empty */
+    {
+        return 0;                                                                         /* success return 0 */
+    }
+    if (a_max30105_edge_match(handle) != 0)                                               /* match the edge */
+    {
+        return 1;                                                                         /* return error */
+    }
+    a_max30105_sequence_commit(handle, len);                                              /* advance the sequence */
+    
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief         read the raw fifo bytes
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[out]    *buf pointer to a raw data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *mode pointer to a mode buffer
+ * @param[out]    *resolution pointer to an adc resolution buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 fifo overrun
+ *                - 5 mode is invalid
+ * @note          len is in samples, buf must hold len * 9 bytes,
+ *                mode and resolution describe the bytes for max30105_decode
+ *                and are only set when len is not 0, the fifo drain of the irq handler
+ *                takes the pointers read with the interrupt status,
+ *                the popped samples advance the sample sequence and an overrun is
+ *                recorded as a gap and in the loss statistics like in max30105_read_samples
+ */
+uint8_t max30105_read_fifo_raw(max30105_handle_t *handle, uint8_t *buf, uint8_t *len,
+                               max30105_mode_t *mode, max30105_adc_resolution_t *resolution)
+{
+    uint8_t res;
+    uint8_t prev;
+    uint8_t k;
+    uint8_t l;
+    uint8_t r;
+    
+    if (handle == NULL)                                                                                           /* check handle */
+    {
+        return 2;                                                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                                                      /* check handle initialization */
+    {
+        return 3;                                                                                                 /* return error */
+    }
+    
+    MAX30105_STATS_ENTER(handle);                                                                                 /* enter the timed api */
+    if (handle->edge_pending == 2)                                                                                /* check an edge located in a batch nobody matched */
+    {
+        handle->edge_pending = 0;                                                                                 /* drop it */
+    }
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                             /* read mode config */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("max30105: read mode config failed.\n");                                              /* read mode config failed */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, 1);                                        /* return error */
+    }
+    *mode = (max30105_mode_t)(prev & 0x7);                                                                        /* get mode */
+    if ((*mode) == MAX30105_MODE_RED)                                                                             /* check red mode */
+    {
+        k = 3;                                                                                                    /* 3 */
+    }
+    else if ((*mode) == MAX30105_MODE_RED_IR)                                                                     /* check red && ir mode */
+    {
+        k = 6;                                                                                                    /* 6 */
+    }
+    else if ((*mode) == MAX30105_MODE_GREEN_RED_IR)                                                               /* check red && ir && green mode */
+    {
+        k = 9;                                                                                                    /* 9 */
+    }
+    else
+    {
+        k = 0;                                                                                                    /* checked when samples are pending */
+    }
+    if (handle->fifo_known != 0)                                                                                  /* check the pointers read with the interrupt status */
+    {
+        a_max30105_fifo_point_level(handle->fifo_point, (uint8_t *)&l, (uint8_t *)&prev);                         /* get fifo level */
+        handle->fifo_known = 0;                                                                                   /* the pointers are used once */
+    }
+    else if (a_max30105_fifo_level(handle, (uint8_t *)&l, (uint8_t *)&prev) != 0)                                 /* get fifo level */
+    {
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, 1);                                        /* return error */
+    }
+    handle->fifo_level = l;                                                                                       /* save fifo level */
+    handle->fifo_lost = prev;                                                                                     /* save overflow counter */
+    r = 0;                                                                                                        /* set 0 */
+    if (prev != 0)                                                                                                /* check overflow */
+    {
+        r = 4;                                                                                                    /* set 4 */
+        
+        handle->debug_print("max30105: fifo overrun.\n");                                                         /* fifo overrun */
+    }
+    if (l == 0)                                                                                                   /* check empty */
+    {
+        *len = 0;                                                                                                 /* no sample pending */
+        if (a_max30105_fifo_account(handle, 0) != 0)                                                              /* account the overrun */
+        {
+            return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, 1);                                    /* return error */
+        }
+        
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, r);                                        /* return the status */
+    }
+    *len = ((*len) > l) ? l : (*len);                                                                             /* set read length */
+    if (k == 0)                                                                                                   /* check mode */
+    {
+        handle->debug_print("max30105: mode is invalid.\n");                                                      /* mode is invalid */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, 5);                                        /* return error */
+    }
+    res = a_max30105_iic_read(handle, MAX30105_REG_FIFO_DATA_REGISTER, buf, (*len) * k);                          /* read fifo data */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("max30105: read fifo data register failed.\n");                                       /* read fifo data register failed */
+    
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, 1);                                        /* return error */
+    }
+    a_max30105_edge_follow(handle, l, *len);                                                                      /* follow the edge sample */
+    if (a_max30105_fifo_account(handle, *len) != 0)                                                               /* account the popped samples */
+    {
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, 1);                                        /* return error */
+    }
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);                             /* read spo2 config */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("max30105: read spo2 config failed.\n");                                              /* read spo2 config failed */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, 1);                                        /* return error */
+    }
+    *resolution = (max30105_adc_resolution_t)(prev & 0x3);                                                        /* get adc resolution */
+    
+    return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_FIFO_RAW, r);                                            /* success return 0 */
+}
+
+/**
+ * @brief      decode raw fifo bytes
+ * @param[in]  mode chip mode of the raw bytes
+ * @param[in]  resolution adc resolution of the raw bytes
+ * @param[in]  *buf pointer to a raw data buffer
+ * @param[in]  len number of samples in the raw data buffer
+ * @param[out] *raw_red pointer to a red raw data buffer
+ * @param[out] *raw_ir pointer to an ir raw data buffer
+ * @param[out] *raw_green pointer to a green raw data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 buffer is NULL
+ *             - 5 mode is invalid
+ * @note       pure function without any bus access, raw_ir and raw_green
+ *             may be NULL when the mode doesn't fill them
+ */
+uint8_t max30105_decode(max30105_mode_t mode, max30105_adc_resolution_t resolution, const uint8_t *buf, uint32_t len,
+                        uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green)
+{
+    uint8_t index;
+    
+    if (a_max30105_mode_index(mode, &index) != 0)                                                                 /* check mode */
+    {
+        return 5;                                                                                                 /* return error */
+    }
+    if (a_max30105_decode_check(index, buf, raw_red, raw_ir, raw_green) != 0)                                     /* check buffer */
+    {
+        return 1;                                                                                                 /* return error */
+    }
+    
+    gs_decoder[index][resolution & 0x3](buf, len, raw_red, raw_ir, raw_green);                                    /* run the specialized decoder */
+    
+    return 0;                                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief         read the data
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[out]    *raw_red pointer to a red raw data buffer
+ * @param[out]    *raw_ir pointer to an ir raw data buffer
+ * @param[out]    *raw_green pointer to a green raw data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 fifo overrun
+ *                - 5 mode is invalid
+ * @note          mode and adc resolution are served from the register shadow,
+ *                an empty fifo returns len 0 without reading the fifo data register,
+ *                the buffers and the mode are checked before the fifo is popped
+ */
+uint8_t max30105_read(max30105_handle_t *handle, uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green, uint8_t *len)
+{
+    uint8_t res;
+    uint8_t index;
+    uint8_t r;
+    uint8_t prev;
+    max30105_mode_t mode;
+    max30105_adc_resolution_t resolution;
+    
+    if (handle == NULL)                                                                                           /* check handle */
+    {
+        return 2;                                                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                                                      /* check handle initialization */
+    {
+        return 3;                                                                                                 /* return error */
+    }
+    
+    MAX30105_STATS_ENTER(handle);                                                                                 /* enter the timed api */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                             /* read the shadowed mode config */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("max30105: read mode config failed.\n");                                              /* read mode config failed */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ, 1);                                                 /* return error */
+    }
+    if (a_max30105_mode_index((max30105_mode_t)(prev & 0x7), &index) != 0)                                        /* check mode before the fifo is popped */
+    {
+        handle->debug_print("max30105: mode is invalid.\n");                                                      /* mode is invalid */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ, 5);                                                 /* return error */
+    }
+    if (a_max30105_decode_check(index, handle->buf, raw_red, raw_ir, raw_green) != 0)                             /* check buffer */
+    {
+        handle->debug_print("max30105: buffer is null.\n");                                                       /* buffer is null */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ, 1);                                                 /* return error */
+    }
+    
+    r = max30105_read_fifo_raw(handle, handle->buf, len, &mode, &resolution);                                     /* read the raw fifo bytes */
+    if ((r != 0) && (r != 4))                                                                                     /* check result */
+    {
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ, r);                                                 /* return error */
+    }
+    if ((*len) == 0)                                                                                              /* check empty */
+    {
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ, r);                                                 /* return the status */
+    }
+    if (handle->decoder == NULL)                                                                                  /* check decoder */
+    {
+        handle->decoder = gs_decoder[index][resolution & 0x3];                                                    /* select the decoder */
+    }
+    handle->decoder(handle->buf, *len, raw_red, raw_ir, raw_green);                                               /* decode the raw fifo bytes */
+    
+    return MAX30105_STATS_EXIT(handle, MAX30105_API_READ, r);                                                     /* success return 0 */
+}
+
+/**
+ * @brief         read the samples
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 fifo overrun
+ *                - 5 mode is invalid
+ * @note          sequence numbers continue across reads and skip the samples lost
+ *                in a fifo overrun, the first sample after the loss is flagged
+ */
+uint8_t max30105_read_samples(max30105_handle_t *handle, max30105_sample_t *sample, uint8_t *len)
+{
+    uint8_t res;
+    uint8_t index;
+    uint8_t r;
+    uint8_t prev;
+    max30105_mode_t mode;
+    max30105_adc_resolution_t resolution;
+    
+    if (handle == NULL)                                                                                           /* check handle */
+    {
+        return 2;                                                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                                                      /* check handle initialization */
+    {
+        return 3;                                                                                                 /* return error */
+    }
+    if (sample == NULL)                                                                                           /* check sample */
+    {
+        handle->debug_print("max30105: sample is null.\n");                                                       /* sample is null */
+       
+        return 1;                                                                                                 /* return error */
+    }
+    
+    MAX30105_STATS_ENTER(handle);                                                                                 /* enter the timed api */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                             /* read the shadowed mode config */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("max30105: read mode config failed.\n");                                              /* read mode config failed */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_SAMPLES, 1);                                         /* return error */
+    }
+    if (a_max30105_mode_index((max30105_mode_t)(prev & 0x7), &index) != 0)                                        /* check mode before the fifo is popped */
+    {
+        handle->debug_print("max30105: mode is invalid.\n");                                                      /* mode is invalid */
+       
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_SAMPLES, 5);                                         /* return error */
+    }
+    
+    r = max30105_read_fifo_raw(handle, handle->buf, len, &mode, &resolution);                                     /* read the raw fifo bytes */
+    if ((r != 0) && (r != 4))                                                                                     /* check result */
+    {
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_SAMPLES, r);                                         /* return error */
+    }
+    if ((*len) == 0)                                                                                              /* check empty */
+    {
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_SAMPLES, r);                                         /* return the status */
+    }
+    if (handle->sample_decoder == NULL)                                                                           /* check sample decoder */
+    {
+        handle->sample_decoder = gs_sample_decoder[index][resolution & 0x3];                                      /* select the sample decoder */
+    }
+    handle->sample_decoder(handle->buf, *len, handle->batch_sequence, sample);                                    /* decode the raw fifo bytes */
+    a_max30105_sequence_flag(handle, sample, *len);                                                               /* flag the overrun gap */
+    a_max30105_timestamp_fill(handle, sample, *len);                                                              /* timestamp the samples */
+    
+    return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_SAMPLES, r);                                             /* success return 0 */
+}
+
+/**
+ * @brief      decode raw fifo bytes into samples
+ * @param[in]  mode chip mode of the raw bytes
+ * @param[in]  resolution adc resolution of the raw bytes
+ * @param[in]  *buf pointer to a raw data buffer
+ * @param[in]  len number of samples in the raw data buffer
+ * @param[in]  sequence sequence number of the first sample
+ * @param[out] *sample pointer to a sample buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 buffer is NULL
+ *             - 5 mode is invalid
+ * @note       pure function without any bus access, unused channels are 0
+ */
+uint8_t max30105_decode_samples(max30105_mode_t mode, max30105_adc_resolution_t resolution, const uint8_t *buf, uint32_t len,
+                                uint64_t sequence, max30105_sample_t *sample)
+{
+    uint8_t index;
+    
+    if (a_max30105_mode_index(mode, &index) != 0)                                                                 /* check mode */
     {
-        handle->debug_print("max30105: delay_ms is null.\n");                                               /* delay_ms is null */
-        
-        return 3;                                                                                           /* return error */
+        return 5;                                                                                                 /* return error */
     }
-
-    if (handle->iic_init() != 0)                                                                            /* init iic */
+    if ((buf == NULL) || (sample == NULL))                                                                        /* check buffer */
     {
-        handle->debug_print("max30105: iic init failed.\n");                                                /* iic init failed */
-        
-        return 1;                                                                                           /* return error */
+        return 1;                                                                                                 /* return error */
     }
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_PART_ID, (uint8_t *)&part_id, 1);                 /* read part id */
-    if (res != 0)                                                                                           /* check result */
+    
+    gs_sample_decoder[index][resolution & 0x3](buf, len, sequence, sample);                                       /* run the specialized decoder */
+    
+    return 0;                                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief      get the sequence number of the next sample
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *sequence pointer to a sequence buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       counts every sample drained from the fifo and every sample lost in an overrun since init
+ */
+uint8_t max30105_get_sample_sequence(max30105_handle_t *handle, uint64_t *sequence)
+{
+    if (handle == NULL)                       /* check handle */
     {
-        handle->debug_print("max30105: read part id failed.\n");                                            /* read part id failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 4;                                                                                           /* return error */
+        return 2;                             /* return error */
     }
-    if (part_id != 0x15)                                                                                    /* check part id */
+    if (handle->inited != 1)                  /* check handle initialization */
     {
-        handle->debug_print("max30105: id is invalid.\n");                                                  /* id is invalid */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 4;                                                                                           /* return error */
+        return 3;                             /* return error */
     }
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);                /* read mode config */
-    if (res != 0)                                                                                           /* check result */
+    
+    *sequence = handle->sequence;             /* get the sequence */
+    
+    return 0;                                 /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable the adaptive fifo almost full watermark
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] enable bool value
+ * @param[in] margin safety margin in samples
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 margin is invalid
+ * @note      margin is 1 - 15, each fifo full interrupt measures how many samples arrived before the fifo
+ *            was read and sets the fifo almost full value to the decaying peak of that plus the margin,
+ *            so the fifo is read as late as the latency allows, an overrun restores 0xF, the margin
+ *            keeps the fifo almost full value over 0 since a full fifo can't be told from an empty one
+ */
+uint8_t max30105_set_watermark_control(max30105_handle_t *handle, max30105_bool_t enable, uint8_t margin)
+{
+    if (handle == NULL)                                                   /* check handle */
     {
-        handle->debug_print("max30105: read mode config failed.\n");                                        /* read mode config failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 5;                                                                                           /* return error */
+        return 2;                                                         /* return error */
     }
-    prev &= ~(1 << 6);                                                                                      /* clear config */
-    prev |= 1 << 6;                                                                                         /* set 1 */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);               /* write mode config */
-    if (res != 0)                                                                                           /* check result */
+    if (handle->inited != 1)                                              /* check handle initialization */
     {
-        handle->debug_print("max30105: write mode config failed.\n");                                       /* write mode config failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 5;                                                                                           /* return error */
+        return 3;                                                         /* return error */
     }
-    handle->delay_ms(10);                                                                                   /* delay 10 ms */
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);                /* read mode config */
-    if (res != 0)                                                                                           /* check result */
+    if ((margin == 0) || (margin > 0xF))                                  /* check margin */
     {
-        handle->debug_print("max30105: read mode config failed.\n");                                        /* read mode config failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
+        handle->debug_print("max30105: margin is invalid.\n");            /* margin is invalid */
         
-        return 5;                                                                                           /* return error */
+        return 4;                                                         /* return error */
     }
-    if ((prev & (1 << 6)) != 0)                                                                             /* check result */
+    
+    handle->watermark_enable = (uint8_t)enable;                           /* set enable */
+    handle->watermark_margin = margin;                                    /* set margin */
+    handle->watermark_peak = (uint8_t)(0xF - margin);                     /* start from the safest watermark */
+    handle->watermark_calm = 0;                                           /* restart the decay */
+    handle->watermark_edge = 0;                                           /* no edge yet */
+    
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the adaptive fifo almost full watermark status
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @param[out] *margin pointer to a margin buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t max30105_get_watermark_control(max30105_handle_t *handle, max30105_bool_t *enable, uint8_t *margin)
+{
+    if (handle == NULL)                                          /* check handle */
     {
-        handle->debug_print("max30105: reset failed.\n");                                                   /* reset failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 5;                                                                                           /* return error */
+        return 2;                                                /* return error */
     }
-    prev = 0;                                                                                               /* set zero */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_READ_POINTER, (uint8_t *)&prev, 1);         /* write fifo read pointer */
-    if (res != 0)                                                                                           /* check result */
+    if (handle->inited != 1)                                     /* check handle initialization */
     {
-        handle->debug_print("max30105: write fifo read pointer failed.\n");                                 /* write fifo read pointer failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 6;                                                                                           /* return error */
+        return 3;                                                /* return error */
     }
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)&prev, 1);        /* write fifo write pointer */
-    if (res != 0)                                                                                           /* check result */
+    
+    *enable = (max30105_bool_t)(handle->watermark_enable);       /* get enable */
+    *margin = handle->watermark_margin;                          /* get margin */
+    
+    return 0;                                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the loss statistics
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *loss pointer to a loss statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       counts every fifo overrun seen by a read since init or the last clear
+ */
+uint8_t max30105_get_loss_statistics(max30105_handle_t *handle, max30105_loss_t *loss)
+{
+    if (handle == NULL)                     /* check handle */
     {
-        handle->debug_print("max30105: write fifo write pointer failed.\n");                                /* write fifo write pointer failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 6;                                                                                           /* return error */
+        return 2;                           /* return error */
     }
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_OVERFLOW_COUNTER, (uint8_t *)&prev, 1);          /* write overflow counter */
-    if (res != 0)                                                                                           /* check result */
+    if (handle->inited != 1)                /* check handle initialization */
     {
-        handle->debug_print("max30105: write overflow counter failed.\n");                                  /* write overflow counter failed */
-        (void)handle->iic_deinit();                                                                         /* iic deinit */
-        
-        return 6;                                                                                           /* return error */
+        return 3;                           /* return error */
     }
-    handle->inited = 1;                                                                                     /* flag finish initialization */
     
-    return 0;                                                                                               /* success return 0 */
+    *loss = handle->loss;                   /* get the statistics */
+    
+    return 0;                               /* success return 0 */
 }
 
 /**
- * @brief     close the chip
+ * @brief     clear the loss statistics
  * @param[in] *handle pointer to a max30105 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 iic deinit failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 power down failed
  * @note      none
  */
-uint8_t max30105_deinit(max30105_handle_t *handle)
+uint8_t max30105_clear_loss_statistics(max30105_handle_t *handle)
 {
-    uint8_t res;
-    uint8_t prev;
-    
-    if (handle == NULL)                                                                              /* check handle */
+    if (handle == NULL)                                       /* check handle */
     {
-        return 2;                                                                                    /* return error */
+        return 2;                                             /* return error */
     }
-    if (handle->inited != 1)                                                                         /* check handle initialization */
+    if (handle->inited != 1)                                  /* check handle initialization */
     {
-        return 3;                                                                                    /* return error */
+        return 3;                                             /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);         /* read mode config */
-    if (res != 0)                                                                                    /* check result */
-    {
-        handle->debug_print("max30105: read mode config failed.\n");                                 /* read mode config failed */
-       
-        return 4;                                                                                    /* return error */
-    }
-    prev &= ~(1 << 7);                                                                               /* clear config */
-    prev |= 1 << 7;                                                                                  /* set bool */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);        /* write mode config */
-    if (res != 0)                                                                                    /* check result */
+    memset(&handle->loss, 0, sizeof(max30105_loss_t));        /* clear the statistics */
+    
+    return 0;                                                 /* success return 0 */
+}
+
+#if (MAX30105_STATS != 0)
+/**
+ * @brief      get the statistics
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *stats pointer to a statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       counts since the handle was linked or the last clear
+ */
+uint8_t max30105_get_stats(max30105_handle_t *handle, max30105_stats_t *stats)
+{
+    if (handle == NULL)                     /* check handle */
     {
-        handle->debug_print("max30105: write mode config failed.\n");                                /* write mode config failed */
-       
-        return 4;                                                                                    /* return error */
+        return 2;                           /* return error */
     }
-    if (handle->iic_deinit() != 0)                                                                   /* iic deinit */
+    if (handle->inited != 1)                /* check handle initialization */
     {
-        handle->debug_print("max30105: iic deinit failed.\n");                                       /* iic deinit failed */
-        
-        return 1;                                                                                    /* return error */
+        return 3;                           /* return error */
     }
     
-    handle->inited = 0;                                                                              /* flag close */
+    *stats = handle->stats;                 /* get the statistics */
     
-    return 0;                                                                                        /* success return 0 */
+    return 0;                               /* success return 0 */
 }
 
 /**
- * @brief     irq handler
+ * @brief     clear the statistics
  * @param[in] *handle pointer to a max30105 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 run failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  * @note      none
  */
-uint8_t max30105_irq_handler(max30105_handle_t *handle)
+uint8_t max30105_clear_stats(max30105_handle_t *handle)
 {
-    uint8_t res;
-    uint8_t prev;
-    
-    if (handle == NULL)                                                                                            /* check handle */
+    if (handle == NULL)                                         /* check handle */
     {
-        return 2;                                                                                                  /* return error */
+        return 2;                                               /* return error */
     }
-    if (handle->inited != 1)                                                                                       /* check handle initialization */
+    if (handle->inited != 1)                                    /* check handle initialization */
     {
-        return 3;                                                                                                  /* return error */
+        return 3;                                               /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_STATUS_1, (uint8_t *)&prev, 1);                /* read interrupt status1 */
-    if (res != 0)                                                                                                  /* check result */
-    {
-        handle->debug_print("max30105: read interrupt status1 failed.\n");                                         /* read interrupt status1 failed */
-       
-        return 1;                                                                                                  /* return error */
-    }
-    if ((prev & (1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL)) != 0)                                                  /* check fifo full */
-    {
-        if (handle->receive_callback != NULL)                                                                      /* if receive callback */
-        {
-            handle->receive_callback(MAX30105_INTERRUPT_STATUS_FIFO_FULL);                                         /* run callback */
-        }
-    }
-    if ((prev & (1 << MAX30105_INTERRUPT_STATUS_DATA_RDY)) != 0)                                                   /* check data ready */
-    {
-        if (handle->receive_callback != NULL)                                                                      /* if receive callback */
-        {
-            handle->receive_callback(MAX30105_INTERRUPT_STATUS_DATA_RDY);                                          /* run callback */
-        }
-    }
-    if ((prev & (1 << MAX30105_INTERRUPT_STATUS_ALC_OVF)) != 0)                                                    /* check alc ovf */
+    memset(&handle->stats, 0, sizeof(max30105_stats_t));        /* clear the statistics */
+    
+    return 0;                                                   /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     set the time of the interrupt edge
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] ns edge time in ns from a monotonic clock
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it before max30105_irq_handler with the kernel timestamp of the INT falling edge,
+ *            the irq handler anchors it to the fifo level of the edge, the read that pops that
+ *            sample matches it and max30105_read_samples timestamps every sample from the
+ *            estimated sensor clock
+ */
+uint8_t max30105_set_edge_timestamp(max30105_handle_t *handle, uint64_t ns)
+{
+    if (handle == NULL)                         /* check handle */
     {
-        if (handle->receive_callback != NULL)                                                                      /* if receive callback */
-        {
-            handle->receive_callback(MAX30105_INTERRUPT_STATUS_ALC_OVF);                                           /* run callback */
-        }
+        return 2;                               /* return error */
     }
-    if ((prev & (1 << MAX30105_INTERRUPT_STATUS_PROX_INT)) != 0)                                                   /* check proxy int */
+    if (handle->inited != 1)                    /* check handle initialization */
     {
-        if (handle->receive_callback != NULL)                                                                      /* if receive callback */
-        {
-            handle->receive_callback(MAX30105_INTERRUPT_STATUS_PROX_INT);                                          /* run callback */
-        }
+        return 3;                               /* return error */
     }
-    if ((prev & (1 << MAX30105_INTERRUPT_STATUS_PWR_RDY)) != 0)                                                    /* check pwr ready */
+    
+    handle->edge_timestamp = ns;                /* set the edge time */
+    handle->edge_count = 0;                     /* newest sample until the irq handler knows better */
+    handle->edge_pending = 1;                   /* set pending */
+    
+    return 0;                                   /* success return 0 */
+}
+
+/**
+ * @brief      get the estimated clock drift
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *ppm pointer to a drift buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 no clock estimation yet
+ * @note       positive when the sensor samples slower than configured
+ */
+uint8_t max30105_get_clock_drift(max30105_handle_t *handle, float *ppm)
+{
+    if (handle == NULL)                                                                     /* check handle */
     {
-        if (handle->receive_callback != NULL)                                                                      /* if receive callback */
-        {
-            handle->receive_callback(MAX30105_INTERRUPT_STATUS_PWR_RDY);                                           /* run callback */
-        }
+        return 2;                                                                           /* return error */
     }
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_STATUS_2, (uint8_t *)&prev, 1);                /* read interrupt status2 */
-    if (res != 0)                                                                                                  /* check result */
+    if (handle->inited != 1)                                                                /* check handle initialization */
     {
-        handle->debug_print("max30105: read interrupt status2 failed.\n");                                         /* read interrupt status2 failed */
-       
-        return 1;                                                                                                  /* return error */
+        return 3;                                                                           /* return error */
     }
-    if ((prev & (1 << MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY)) != 0)                                               /* check die temp ready */
+    if (handle->clock_valid == 0)                                                           /* check clock */
     {
-        uint8_t prev1;
-        
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_DIE_TEMP_INTEGER, (uint8_t *)&prev, 1);              /* read die temp integer */
-        if (res != 0)                                                                                              /* check result */
-        {
-            handle->debug_print("max30105: read die temp integer failed.\n");                                      /* read die temp integer failed */
-           
-            return 1;                                                                                              /* return error */
-        }
-        handle->raw = (uint16_t)prev << 4;                                                                         /* set integer part */
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_DIE_TEMP_FRACTION, (uint8_t *)&prev1, 1);            /* read die temp fraction */
-        if (res != 0)                                                                                              /* check result */
-        {
-            handle->debug_print("max30105: read die temp fraction failed.\n");                                     /* read die temp fraction failed */
-           
-            return 1;                                                                                              /* return error */
-        }
-        handle->raw = handle->raw | prev1;                                                                         /* set fraction part */
-        handle->temperature = (float)((int8_t)(prev)) + (float)(prev1 & 0x0F) * 0.0625f;                           /* set the temperature */
-        handle->finished_flag = 1;                                                                                 /* set flag */
+        handle->debug_print("max30105: no clock estimation yet.\n");                        /* no clock estimation yet */
         
-        if (handle->receive_callback != NULL)                                                                      /* if receive callback */
-        {
-            handle->receive_callback(MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY);                                      /* run callback */
-        }
+        return 4;                                                                           /* return error */
     }
     
-    return 0;                                                                                                      /* success return 0 */
+    *ppm = (float)((double)((int64_t)(handle->clock_period - handle->clock_nominal)) /
+                   (double)handle->clock_nominal * 1000000.0);                              /* get the drift */
+    
+    return 0;                                                                               /* success return 0 */
 }
 
 /**
- * @brief         read the data
- * @param[in]     *handle pointer to a max30105 handle structure
- * @param[out]    *raw_red pointer to a red raw data buffer
- * @param[out]    *raw_ir pointer to an ir raw data buffer
- * @param[out]    *raw_green pointer to a green raw data buffer
- * @param[in,out] *len pointer to a length buffer
- * @return        status code
- *                - 0 success
- *                - 1 read failed
- *                - 2 handle is NULL
- *                - 3 handle is not initialized
- *                - 4 fifo overrun
- *                - 5 mode is invalid
- * @note          none
+ * @brief     set the polling safety margin
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] margin empty fifo slots kept at the deadline
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 margin is invalid
+ * @note      margin is 1 - 31, a full fifo can't be told from an empty one without an overflow,
+ *            the rest absorbs the wake up jitter of the polling thread, the default is 2
  */
-uint8_t max30105_read(max30105_handle_t *handle, uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green, uint8_t *len)
+uint8_t max30105_set_poll_margin(max30105_handle_t *handle, uint8_t margin)
 {
-    uint8_t res;
-    uint8_t prev;
-    uint8_t mode;
-    uint8_t k;
-    uint8_t read_point;
-    uint8_t write_point;
-    uint8_t l;
-    uint8_t bit;
-    uint8_t i;
-    uint8_t r;
-    
-    if (handle == NULL)                                                                                           /* check handle */
-    {
-        return 2;                                                                                                 /* return error */
-    }
-    if (handle->inited != 1)                                                                                      /* check handle initialization */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 3;                                                                                                 /* return error */
+        return 2;                                                    /* return error */
     }
-    
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_OVERFLOW_COUNTER, (uint8_t *)&prev, 1);                 /* read overflow counter */
-    if (res != 0)                                                                                                 /* check result */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        handle->debug_print("max30105: read overflow counter failed.\n");                                         /* read overflow counter failed */
-       
-        return 1;                                                                                                 /* return error */
+        return 3;                                                    /* return error */
     }
-    r = 0;                                                                                                        /* set 0 */
-    if (prev != 0)                                                                                                /* check overflow */
+    if ((margin == 0) || (margin > 31))                              /* check margin */
     {
-        r = 4;                                                                                                    /* set 4 */
+        handle->debug_print("max30105: margin is invalid.\n");       /* margin is invalid */
         
-        handle->debug_print("max30105: fifo overrun.\n");                                                         /* fifo overrun*/
+        return 4;                                                    /* return error */
     }
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_READ_POINTER, (uint8_t *)&read_point, 1);          /* read fifo read point */
-    if (res != 0)                                                                                                 /* check result */
+    
+    handle->poll_margin = margin;                                    /* set margin */
+    handle->poll_late = 0;                                           /* forget the latency */
+    handle->poll_calm = 0;                                           /* restart the decay */
+    
+    return 0;                                                        /* success return 0 */
+}
+
+/**
+ * @brief      get the polling safety margin
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *margin pointer to a margin buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t max30105_get_poll_margin(max30105_handle_t *handle, uint8_t *margin)
+{
+    if (handle == NULL)                             /* check handle */
     {
-        handle->debug_print("max30105: read fifo read point failed.\n");                                          /* read fifo read point failed */
-       
-        return 1;                                                                                                 /* return error */
+        return 2;                                   /* return error */
     }
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)&write_point, 1);        /* read fifo write point */
-    if (res != 0)                                                                                                 /* check result */
+    if (handle->inited != 1)                        /* check handle initialization */
     {
-        handle->debug_print("max30105: read fifo write point failed.\n");                                         /* read fifo write point failed */
-       
-        return 1;                                                                                                 /* return error */
+        return 3;                                   /* return error */
     }
     
-    if (write_point > read_point)                                                                                 /* check point */
+    *margin = handle->poll_margin;                  /* get margin */
+    
+    return 0;                                       /* success return 0 */
+}
+
+/**
+ * @brief         poll the fifo and get the next deadline
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[in]     now current time in ns from a monotonic clock
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *deadline pointer to a deadline buffer in ns
+ * @return        status code
+ *                - 0 success
+ *                - 1 poll failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 fifo overrun
+ *                - 5 mode is invalid
+ * @note          for boards without the INT line, sleep until the deadline with an absolute timer
+ *                and call it again, the deadline is when the largest batch the margin allows is
+ *                in the fifo, the read time drives the sensor clock estimation and the fifo level
+ *                seen at each wake up corrects the batch for the wake up latency
+ */
+uint8_t max30105_poll(max30105_handle_t *handle, uint64_t now, max30105_sample_t *sample, uint8_t *len, uint64_t *deadline)
+{
+    uint8_t r;
+    uint8_t batch;
+    uint64_t period;
+    int64_t d;
+    
+    if (handle == NULL)                                                                                  /* check handle */
     {
-        l = write_point - read_point;                                                                             /* get length */
+        return 2;                                                                                        /* return error */
     }
-    else
+    if (handle->inited != 1)                                                                             /* check handle initialization */
     {
-        l = 32 + write_point - read_point;                                                                        /* get length */
+        return 3;                                                                                        /* return error */
     }
-    *len = ((*len) > l) ? l : (*len);                                                                             /* set read length */
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);                      /* read mode config */
-    if (res != 0)                                                                                                 /* check result */
+    if (deadline == NULL)                                                                                /* check deadline */
     {
-        handle->debug_print("max30105: read mode config failed.\n");                                              /* read mode config failed */
+        handle->debug_print("max30105: deadline is null.\n");                                            /* deadline is null */
        
-        return 1;                                                                                                 /* return error */
+        return 1;                                                                                        /* return error */
     }
-    mode = (max30105_mode_t)(prev & 0x7);                                                                         /* get mode */
-    if (mode == MAX30105_MODE_RED)                                                                                /* check red mode */
+    
+    
+    MAX30105_STATS_ENTER(handle);                                                                        /* enter the timed api */
+    handle->edge_timestamp = now;                                                                        /* the newest sample is at most a period old */
+    handle->edge_count = 0;                                                                              /* match the newest sample */
+    handle->edge_pending = 1;                                                                            /* set pending */
+    batch = (uint8_t)(32 - handle->poll_margin - handle->poll_late);                                     /* batch this wake up expects */
+    r = max30105_read_samples(handle, sample, len);                                                      /* read the samples */
+    if ((r != 0) && (r != 4))                                                                            /* check result */
     {
-        k = 3;                                                                                                    /* 3 */
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_POLL, r);                                        /* return error */
     }
-    else if (mode == MAX30105_MODE_RED_IR)                                                                        /* check red && ir mode*/
+    a_max30105_poll_update(handle, batch);                                                               /* track the wake up latency */
+    if (handle->poll_late > 31 - handle->poll_margin)                                                    /* check limit */
     {
-        k = 6;                                                                                                    /* 6 */
+        handle->poll_late = (uint8_t)(31 - handle->poll_margin);                                         /* keep at least one sample */
     }
-    else if (mode == MAX30105_MODE_GREEN_RED_IR)                                                                  /* check red && ir && green mode */
+    batch = (uint8_t)(32 - handle->poll_margin - handle->poll_late);                                     /* next batch */
+    if (handle->clock_valid != 0)                                                                        /* check clock */
     {
-        k = 9;                                                                                                    /* 9 */
+        d = (int64_t)(handle->sequence + batch - 1 - handle->clock_sequence);                            /* samples from the reference */
+        *deadline = (uint64_t)((int64_t)handle->clock_time + (d * (int64_t)handle->clock_period) / 256
+                               - (int64_t)handle->clock_period / 512);                                   /* the read lags the newest sample by half a period */
+        if ((int64_t)(*deadline - now) > 0)                                                              /* check deadline */
+        {
+            return MAX30105_STATS_EXIT(handle, MAX30105_API_POLL, r);                                    /* success return 0 */
+        }
     }
-    else
+    if (a_max30105_clock_nominal(handle, &period) != 0)                                                  /* get nominal period */
     {
-        handle->debug_print("max30105: mode is invalid.\n");                                                      /* mode is invalid */
-       
-        return 5;                                                                                                 /* return error */
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_POLL, 1);                                        /* return error */
     }
+    *deadline = now + (batch * period) / 256;                                                            /* fill time of the drained fifo */
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_DATA_REGISTER, handle->buf, (*len) * k);           /* read fifo read point */
-    if (res != 0)                                                                                                 /* check result */
+    return MAX30105_STATS_EXIT(handle, MAX30105_API_POLL, r);                                            /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable draining the fifo in the irq handler
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] enable bool value
+ * @param[in] *raw_red pointer to a 32 length red raw data buffer
+ * @param[in] *raw_ir pointer to a 32 length ir raw data buffer
+ * @param[in] *raw_green pointer to a 32 length green raw data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 buffer is NULL
+ * @note      when enabled, a fifo full irq reads the fifo into the buffers before the callback runs
+ */
+uint8_t max30105_set_irq_fifo_drain(max30105_handle_t *handle, max30105_bool_t enable, uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green)
+{
+    if (handle == NULL)                                                                                   /* check handle */
     {
-        handle->debug_print("max30105: read fifo data register failed.\n");                                       /* read fifo data register failed */
-       
-        return 1;                                                                                                 /* return error */
+        return 2;                                                                                         /* return error */
     }
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);                      /* read spo2 config */
-    if (res != 0)                                                                                                 /* check result */
+    if (handle->inited != 1)                                                                              /* check handle initialization */
     {
-        handle->debug_print("max30105: read spo2 config failed.\n");                                              /* read spo2 config failed */
-       
-        return 1;                                                                                                 /* return error */
+        return 3;                                                                                         /* return error */
+    }
+    
+    if (enable == MAX30105_BOOL_TRUE)                                                                     /* check enable */
+    {
+        if ((raw_red == NULL) || (raw_ir == NULL) || (raw_green == NULL))                                 /* check buffer */
+        {
+            handle->debug_print("max30105: buffer is null.\n");                                           /* buffer is null */
+            
+            return 4;                                                                                     /* return error */
+        }
+        handle->irq_raw_red = raw_red;                                                                    /* set red buffer */
+        handle->irq_raw_ir = raw_ir;                                                                      /* set ir buffer */
+        handle->irq_raw_green = raw_green;                                                                /* set green buffer */
+        handle->irq_fifo_drain = 1;                                                                       /* enable drain */
     }
-    prev = prev & 0x3;                                                                                            /* get config */
-    if (prev == 0)                                                                                                /* if 0 */
+    else
     {
-        bit = 3;                                                                                                  /* 15 bits */
+        handle->irq_fifo_drain = 0;                                                                       /* disable drain */
     }
-    else if (prev == 1)                                                                                           /* if 1 */
+    handle->irq_fifo_len = 0;                                                                             /* clear length */
+    
+    return 0;                                                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the irq fifo drain status
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t max30105_get_irq_fifo_drain(max30105_handle_t *handle, max30105_bool_t *enable)
+{
+    if (handle == NULL)                                                                                   /* check handle */
     {
-        bit = 2;                                                                                                  /* 16 bits */
+        return 2;                                                                                         /* return error */
     }
-    else if (prev == 2)                                                                                           /* if 2 */
+    if (handle->inited != 1)                                                                              /* check handle initialization */
     {
-        bit = 1;                                                                                                  /* 17 bits */
+        return 3;                                                                                         /* return error */
     }
-    else                                                                                                          /* if 3 */
+    
+    *enable = (max30105_bool_t)(handle->irq_fifo_drain);                                                  /* get bool */
+    
+    return 0;                                                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the length drained by the last fifo full irq
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *len pointer to a length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       call it from the fifo full callback
+ */
+uint8_t max30105_get_irq_fifo_length(max30105_handle_t *handle, uint8_t *len)
+{
+    if (handle == NULL)                                                                                   /* check handle */
     {
-        bit = 0;                                                                                                  /* 18 bits */
+        return 2;                                                                                         /* return error */
     }
-    for (i = 0; i < (*len); i++)                                                                                  /* copy data */
+    if (handle->inited != 1)                                                                              /* check handle initialization */
     {
-        if (mode == MAX30105_MODE_RED)                                                                            /* check red mode */
-        {
-            raw_red[i] = ((uint32_t)handle->buf[i * 3 + 0] << 16) |                                               /* get raw red data */
-                         ((uint32_t)handle->buf[i * 3 + 1] << 8) |                                                /* get raw red data */
-                         ((uint32_t)handle->buf[i * 3 + 2] << 0);                                                 /* get raw red data */
-            raw_red[i] = raw_red[i] >> bit;                                                                       /* right shift bit */
-        }
-        else if (mode == MAX30105_MODE_RED_IR)                                                                    /* check red && ir mode*/
-        {
-            raw_red[i] = ((uint32_t)handle->buf[i * 6 + 0] << 16) |                                               /* get raw red data */
-                         ((uint32_t)handle->buf[i * 6 + 1] << 8) |                                                /* get raw red data */
-                         ((uint32_t)handle->buf[i * 6 + 2] << 0);                                                 /* get raw red data */
-            raw_red[i] = raw_red[i] >> bit;                                                                       /* right shift bit */
-            raw_ir[i] = ((uint32_t)handle->buf[i * 6 + 3] << 16) |                                                /* get raw ir data */
-                        ((uint32_t)handle->buf[i * 6 + 4] << 8) |                                                 /* get raw ir data */
-                        ((uint32_t)handle->buf[i * 6 + 5] << 0);                                                  /* get raw ir data */
-            raw_ir[i] = raw_ir[i] >> bit;                                                                         /* right shift bit */
-        }
-        else
-        {
-            raw_red[i] = ((uint32_t)handle->buf[i * 9 + 0] << 16) |                                               /* get raw red data */
-                         ((uint32_t)handle->buf[i * 9 + 1] << 8) |                                                /* get raw red data */
-                         ((uint32_t)handle->buf[i * 9 + 2] << 0);                                                 /* get raw red data */
-            raw_red[i] = raw_red[i] >> bit;                                                                       /* right shift bit */
-            raw_ir[i] = ((uint32_t)handle->buf[i * 9 + 3] << 16) |                                                /* get raw ir data */
-                        ((uint32_t)handle->buf[i * 9 + 4] << 8) |                                                 /* get raw ir data */
-                        ((uint32_t)handle->buf[i * 9 + 5] << 0);                                                  /* get raw ir data */
-            raw_ir[i] = raw_ir[i] >> bit;                                                                         /* right shift bit */
-            raw_green[i] = ((uint32_t)handle->buf[i * 9 + 6] << 16) |                                             /* get raw green data */
-                           ((uint32_t)handle->buf[i * 9 + 7] << 8) |                                              /* get raw green data */
-                           ((uint32_t)handle->buf[i * 9 + 8] << 0);                                               /* get raw green data */
-            raw_green[i] = raw_green[i] >> bit;                                                                   /* right shift bit */
-        }
+        return 3;                                                                                         /* return error */
     }
     
-    return r;                                                                                                     /* success return 0 */
+    *len = handle->irq_fifo_len;                                                                          /* get length */
+    
+    return 0;                                                                                             /* success return 0 */
 }
 
 /**
@@ -588,48 +2530,49 @@ uint8_t max30105_read_temperature(max30105_handle_t *handle, uint16_t *raw, floa
         return 3;                                                                                              /* return error */
     }
 
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev, 1);            /* read interrupt enable2 */
+    MAX30105_STATS_ENTER(handle);                                                                              /* enter the timed api */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev);                   /* read interrupt enable2 */
     if (res != 0)                                                                                              /* check result */
     {
         handle->debug_print("max30105: read interrupt enable2 failed.\n");                                     /* read interrupt enable2 failed */
        
-        return 1;                                                                                              /* return error */
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_TEMPERATURE, 1);                                  /* return error */
     }
     if ((prev & (1 << 1)) == 0)                                                                                /* check config */
     {
         prev &= ~(1 << 1);                                                                                     /* clear interrupt */
         prev |= 1 << 1;                                                                                        /* set interrupt */
-        res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev, 1);       /* write interrupt enable2 */
+        res = a_max30105_shadow_write(handle, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev);              /* write interrupt enable2 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: write interrupt enable2 failed.\n");                                /* write interrupt enable2 failed */
            
-            return 1;                                                                                          /* return error */
+            return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_TEMPERATURE, 1);                              /* return error */
         }
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev, 1);               /* read die temp config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev);                      /* read die temp config */
     if (res != 0)                                                                                              /* check result */
     {
         handle->debug_print("max30105: read die temp config failed.\n");                                       /* read die temp config failed */
        
-        return 1;                                                                                              /* return error */
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_TEMPERATURE, 1);                                  /* return error */
     }
     prev &= ~(1 << 0);                                                                                         /* clear config */
     prev |= (1 << 0);                                                                                          /* set bool */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev, 1);              /* write die temp config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev);                     /* write die temp config */
     if (res != 0)                                                                                              /* check result */
     {
         handle->debug_print("max30105: write die temp config failed.\n");                                      /* write die temp config failed */
        
-        return 1;                                                                                              /* return error */
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_TEMPERATURE, 1);                                  /* return error */
     }
     
     timeout = 5000;                                                                                            /* set 5000 ms */
     handle->finished_flag = 0;                                                                                 /* clear finished flag */
     while (timeout != 0)                                                                                       /* timeout */
     {
-        handle->delay_ms(1);                                                                                   /* delay 1 ms */
+        a_max30105_delay_ms(handle, 1);                                                                        /* delay 1 ms */
         timeout--;                                                                                             /* timeout */
         if (handle->finished_flag != 0)                                                                        /* check finished flag */
         {
@@ -640,12 +2583,12 @@ uint8_t max30105_read_temperature(max30105_handle_t *handle, uint16_t *raw, floa
     {
         handle->debug_print("max30105: read timeout.\n");                                                      /* read timeout */
        
-        return 1;                                                                                              /* return error */
+        return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_TEMPERATURE, 1);                                  /* return error */
     }
     *raw = handle->raw;                                                                                        /* get raw */
     *temp = handle->temperature;                                                                               /* get temperature */
     
-    return 0;                                                                                                  /* success return 0 */
+    return MAX30105_STATS_EXIT(handle, MAX30105_API_READ_TEMPERATURE, 0);                                      /* success return 0 */
 }
 
 /**
@@ -676,7 +2619,7 @@ uint8_t max30105_get_interrupt_status(max30105_handle_t *handle, max30105_interr
 
     if (status == MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY)                                                      /* if die temp ready status */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_STATUS_2, (uint8_t *)&prev, 1);        /* read interrupt status2 */
+        res = a_max30105_iic_read(handle, MAX30105_REG_INTERRUPT_STATUS_2, (uint8_t *)&prev, 1);               /* read interrupt status2 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: read interrupt status2 failed.\n");                                 /* read interrupt status2 failed */
@@ -689,7 +2632,7 @@ uint8_t max30105_get_interrupt_status(max30105_handle_t *handle, max30105_interr
     }
     else
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_STATUS_1, (uint8_t *)&prev, 1);        /* read interrupt status1 */
+        res = a_max30105_iic_read(handle, MAX30105_REG_INTERRUPT_STATUS_1, (uint8_t *)&prev, 1);               /* read interrupt status1 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: read interrupt status1 failed.\n");                                 /* read interrupt status1 failed */
@@ -730,7 +2673,7 @@ uint8_t max30105_set_interrupt(max30105_handle_t *handle, max30105_interrupt_t t
 
     if (type == MAX30105_INTERRUPT_DIE_TEMP_RDY_EN)                                                            /* if internal temperature enable */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev, 1);        /* read interrupt enable2 */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev);               /* read interrupt enable2 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: read interrupt enable2 failed.\n");                                 /* read interrupt enable2 failed */
@@ -739,7 +2682,7 @@ uint8_t max30105_set_interrupt(max30105_handle_t *handle, max30105_interrupt_t t
         }
         prev &= ~(1 << type);                                                                                  /* clear interrupt */
         prev |= enable << type;                                                                                /* set interrupt */
-        res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev, 1);       /* write interrupt enable2 */
+        res = a_max30105_shadow_write(handle, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev);              /* write interrupt enable2 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: write interrupt enable2 failed.\n");                                /* write interrupt enable2 failed */
@@ -751,7 +2694,7 @@ uint8_t max30105_set_interrupt(max30105_handle_t *handle, max30105_interrupt_t t
     }
     else
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)&prev, 1);        /* read interrupt enable1 */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)&prev);               /* read interrupt enable1 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: read interrupt enable1 failed.\n");                                 /* read interrupt enable1 failed */
@@ -760,7 +2703,7 @@ uint8_t max30105_set_interrupt(max30105_handle_t *handle, max30105_interrupt_t t
         }
         prev &= ~(1 << type);                                                                                  /* clear interrupt */
         prev |= enable << type;                                                                                /* set interrupt */
-        res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)&prev, 1);       /* write interrupt enable1 */
+        res = a_max30105_shadow_write(handle, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)&prev);              /* write interrupt enable1 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: write interrupt enable1 failed.\n");                                /* write interrupt enable1 failed */
@@ -800,7 +2743,7 @@ uint8_t max30105_get_interrupt(max30105_handle_t *handle, max30105_interrupt_t t
 
     if (type == MAX30105_INTERRUPT_DIE_TEMP_RDY_EN)                                                            /* if internal temperature enable */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev, 1);        /* read interrupt enable2 */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_INTERRUPT_ENABLE_2, (uint8_t *)&prev);               /* read interrupt enable2 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: read interrupt enable2 failed.\n");                                 /* read interrupt enable2 failed */
@@ -813,7 +2756,7 @@ uint8_t max30105_get_interrupt(max30105_handle_t *handle, max30105_interrupt_t t
     }
     else
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)&prev, 1);        /* read interrupt enable1 */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)&prev);               /* read interrupt enable1 */
         if (res != 0)                                                                                          /* check result */
         {
             handle->debug_print("max30105: read interrupt enable1 failed.\n");                                 /* read interrupt enable1 failed */
@@ -859,7 +2802,7 @@ uint8_t max30105_set_fifo_write_pointer(max30105_handle_t *handle, uint8_t point
     }
 
     prev = pointer & 0x1F;                                                                                  /* set pointer */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)&prev, 1);        /* write fifo write pointer */
+    res = a_max30105_iic_write(handle, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)&prev, 1);               /* write fifo write pointer */
     if (res != 0)                                                                                           /* check result */
     {
         handle->debug_print("max30105: write fifo write pointer failed.\n");                                /* write fifo write pointer failed */
@@ -895,7 +2838,7 @@ uint8_t max30105_get_fifo_write_pointer(max30105_handle_t *handle, uint8_t *poin
         return 3;                                                                                          /* return error */
     }
 
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)&prev, 1);        /* read fifo write pointer */
+    res = a_max30105_iic_read(handle, MAX30105_REG_FIFO_WRITE_POINTER, (uint8_t *)&prev, 1);               /* read fifo write pointer */
     if (res != 0)                                                                                          /* check result */
     {
         handle->debug_print("max30105: read fifo write pointer failed.\n");                                /* read fifo write pointer failed */
@@ -940,7 +2883,7 @@ uint8_t max30105_set_fifo_overflow_counter(max30105_handle_t *handle, uint8_t co
     }
 
     prev = counter & 0x1F;                                                                                /* set counter */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_OVERFLOW_COUNTER, (uint8_t *)&prev, 1);        /* set fifo overflow counter */
+    res = a_max30105_iic_write(handle, MAX30105_REG_OVERFLOW_COUNTER, (uint8_t *)&prev, 1);               /* set fifo overflow counter */
     if (res != 0)                                                                                         /* check result */
     {
         handle->debug_print("max30105: set fifo overflow counter failed.\n");                             /* set fifo overflow counter failed */
@@ -976,7 +2919,7 @@ uint8_t max30105_get_fifo_overflow_counter(max30105_handle_t *handle, uint8_t *c
         return 3;                                                                                        /* return error */
     }
 
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_OVERFLOW_COUNTER, (uint8_t *)&prev, 1);        /* get fifo overflow counter */
+    res = a_max30105_iic_read(handle, MAX30105_REG_OVERFLOW_COUNTER, (uint8_t *)&prev, 1);               /* get fifo overflow counter */
     if (res != 0)                                                                                        /* check result */
     {
         handle->debug_print("max30105: get fifo overflow counter failed.\n");                            /* get fifo overflow counter failed */
@@ -1021,7 +2964,7 @@ uint8_t max30105_set_fifo_read_pointer(max30105_handle_t *handle, uint8_t pointe
     }
 
     prev = pointer & 0x1F;                                                                                 /* set pointer */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_READ_POINTER, (uint8_t *)&prev, 1);        /* write fifo read pointer */
+    res = a_max30105_iic_write(handle, MAX30105_REG_FIFO_READ_POINTER, (uint8_t *)&prev, 1);               /* write fifo read pointer */
     if (res != 0)                                                                                          /* check result */
     {
         handle->debug_print("max30105: write fifo read pointer failed.\n");                                /* write fifo read pointer failed */
@@ -1057,7 +3000,7 @@ uint8_t max30105_get_fifo_read_pointer(max30105_handle_t *handle, uint8_t *point
         return 3;                                                                                         /* return error */
     }
 
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_READ_POINTER, (uint8_t *)&prev, 1);        /* read fifo read pointer */
+    res = a_max30105_iic_read(handle, MAX30105_REG_FIFO_READ_POINTER, (uint8_t *)&prev, 1);               /* read fifo read pointer */
     if (res != 0)                                                                                         /* check result */
     {
         handle->debug_print("max30105: read fifo read pointer failed.\n");                                /* read fifo read pointer failed */
@@ -1069,6 +3012,40 @@ uint8_t max30105_get_fifo_read_pointer(max30105_handle_t *handle, uint8_t *point
     return 0;                                                                                             /* success return 0 */
 }
 
+/**
+ * @brief      get the number of samples pending in the fifo
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *level pointer to a level buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get fifo level failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       level is 0 - 32, the overflow counter tells a full fifo from an empty one
+ */
+uint8_t max30105_get_fifo_level(max30105_handle_t *handle, uint8_t *level)
+{
+    uint8_t res;
+    uint8_t overflow;
+    
+    if (handle == NULL)                                                                                   /* check handle */
+    {
+        return 2;                                                                                         /* return error */
+    }
+    if (handle->inited != 1)                                                                              /* check handle initialization */
+    {
+        return 3;                                                                                         /* return error */
+    }
+    
+    res = a_max30105_fifo_level(handle, level, (uint8_t *)&overflow);                                     /* get fifo level */
+    if (res != 0)                                                                                         /* check result */
+    {
+        return 1;                                                                                         /* return error */
+    }
+    
+    return 0;                                                                                             /* success return 0 */
+}
+
 /**
  * @brief     set the fifo data
  * @param[in] *handle pointer to a max30105 handle structure
@@ -1093,7 +3070,7 @@ uint8_t max30105_set_fifo_data(max30105_handle_t *handle, uint8_t data)
         return 3;                                                                                           /* return error */
     }
     
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_DATA_REGISTER, (uint8_t *)&data, 1);        /* write fifo data register */
+    res = a_max30105_iic_write(handle, MAX30105_REG_FIFO_DATA_REGISTER, (uint8_t *)&data, 1);               /* write fifo data register */
     if (res != 0)                                                                                           /* check result */
     {
         handle->debug_print("max30105: write fifo data register failed.\n");                                /* write fifo data register failed */
@@ -1128,7 +3105,7 @@ uint8_t max30105_get_fifo_data(max30105_handle_t *handle, uint8_t *data)
         return 3;                                                                                         /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_DATA_REGISTER, (uint8_t *)data, 1);        /* read fifo data register */
+    res = a_max30105_iic_read(handle, MAX30105_REG_FIFO_DATA_REGISTER, (uint8_t *)data, 1);               /* read fifo data register */
     if (res != 0)                                                                                         /* check result */
     {
         handle->debug_print("max30105: read fifo data register failed.\n");                               /* read fifo data register failed */
@@ -1164,7 +3141,7 @@ uint8_t max30105_set_fifo_sample_averaging(max30105_handle_t *handle, max30105_s
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);         /* read fifo config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);                /* read fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read fifo config failed.\n");                                 /* read fifo config failed */
@@ -1173,7 +3150,7 @@ uint8_t max30105_set_fifo_sample_averaging(max30105_handle_t *handle, max30105_s
     }
     prev &= ~(0x7 << 5);                                                                             /* clear config */
     prev |= sample << 5;                                                                             /* set sample */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);        /* write fifo config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);               /* write fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write fifo config failed.\n");                                /* write fifo config failed */
@@ -1209,7 +3186,7 @@ uint8_t max30105_get_fifo_sample_averaging(max30105_handle_t *handle, max30105_s
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);         /* read fifo config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);                /* read fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read fifo config failed.\n");                                 /* read fifo config failed */
@@ -1246,7 +3223,7 @@ uint8_t max30105_set_fifo_roll(max30105_handle_t *handle, max30105_bool_t enable
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);         /* read fifo config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);                /* read fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read fifo config failed.\n");                                 /* read fifo config failed */
@@ -1255,7 +3232,7 @@ uint8_t max30105_set_fifo_roll(max30105_handle_t *handle, max30105_bool_t enable
     }
     prev &= ~(0x1 << 4);                                                                             /* clear config */
     prev |= enable << 4;                                                                             /* set enable */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);        /* write fifo config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);               /* write fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write fifo config failed.\n");                                /* write fifo config failed */
@@ -1291,7 +3268,7 @@ uint8_t max30105_get_fifo_roll(max30105_handle_t *handle, max30105_bool_t *enabl
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);         /* read fifo config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);                /* read fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read fifo config failed.\n");                                 /* read fifo config failed */
@@ -1335,7 +3312,7 @@ uint8_t max30105_set_fifo_almost_full(max30105_handle_t *handle, uint8_t value)
         return 4;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);         /* read fifo config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);                /* read fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read fifo config failed.\n");                                 /* read fifo config failed */
@@ -1344,7 +3321,7 @@ uint8_t max30105_set_fifo_almost_full(max30105_handle_t *handle, uint8_t value)
     }
     prev &= ~(0xF << 0);                                                                             /* clear config */
     prev |= value << 0;                                                                              /* set value */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);        /* write fifo config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);               /* write fifo config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write fifo config failed.\n");                                /* write fifo config failed */
@@ -1380,7 +3357,7 @@ uint8_t max30105_get_fifo_almost_full(max30105_handle_t *handle, uint8_t *value)
         return 3;                                                                                   /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev, 1);        /* read fifo config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)&prev);               /* read fifo config */
     if (res != 0)                                                                                   /* check result */
     {
         handle->debug_print("max30105: read fifo config failed.\n");                                /* read fifo config failed */
@@ -1417,7 +3394,7 @@ uint8_t max30105_set_shutdown(max30105_handle_t *handle, max30105_bool_t enable)
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);         /* read mode config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                /* read mode config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read mode config failed.\n");                                 /* read mode config failed */
@@ -1426,7 +3403,7 @@ uint8_t max30105_set_shutdown(max30105_handle_t *handle, max30105_bool_t enable)
     }
     prev &= ~(1 << 7);                                                                               /* clear config */
     prev |= enable << 7;                                                                             /* set bool */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);        /* write mode config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);               /* write mode config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write mode config failed.\n");                                /* write mode config failed */
@@ -1462,7 +3439,7 @@ uint8_t max30105_get_shutdown(max30105_handle_t *handle, max30105_bool_t *enable
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);         /* read mode config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                /* read mode config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read mode config failed.\n");                                 /* read mode config failed */
@@ -1482,7 +3459,7 @@ uint8_t max30105_get_shutdown(max30105_handle_t *handle, max30105_bool_t *enable
  *            - 1 reset failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      the shadow and the state derived from the chip are cleared
  */
 uint8_t max30105_reset(max30105_handle_t *handle)
 {
@@ -1498,7 +3475,7 @@ uint8_t max30105_reset(max30105_handle_t *handle)
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);         /* read mode config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                /* read mode config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read mode config failed.\n");                                 /* read mode config failed */
@@ -1507,7 +3484,8 @@ uint8_t max30105_reset(max30105_handle_t *handle)
     }
     prev &= ~(1 << 6);                                                                               /* clear config */
     prev |= 1 << 6;                                                                                  /* set 1 */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);        /* write mode config */
+    res = a_max30105_iic_write(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);               /* write mode config */
+    a_max30105_shadow_clear(handle);                                                                 /* all registers and the fifo are reset */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write mode config failed.\n");                                /* write mode config failed */
@@ -1543,7 +3521,7 @@ uint8_t max30105_set_mode(max30105_handle_t *handle, max30105_mode_t mode)
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);         /* read mode config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                /* read mode config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read mode config failed.\n");                                 /* read mode config failed */
@@ -1552,7 +3530,7 @@ uint8_t max30105_set_mode(max30105_handle_t *handle, max30105_mode_t mode)
     }
     prev &= ~(7 << 0);                                                                               /* clear config */
     prev |= mode << 0;                                                                               /* set mode */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);        /* write mode config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);               /* write mode config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write mode config failed.\n");                                /* write mode config failed */
@@ -1588,7 +3566,7 @@ uint8_t max30105_get_mode(max30105_handle_t *handle, max30105_mode_t *mode)
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev, 1);         /* read mode config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_MODE_CONFIG, (uint8_t *)&prev);                /* read mode config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read mode config failed.\n");                                 /* read mode config failed */
@@ -1625,7 +3603,7 @@ uint8_t max30105_set_particle_sensing_adc_range(max30105_handle_t *handle, max30
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);         /* read spo2 config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);                /* read spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read spo2 config failed.\n");                                 /* read spo2 config failed */
@@ -1634,7 +3612,7 @@ uint8_t max30105_set_particle_sensing_adc_range(max30105_handle_t *handle, max30
     }
     prev &= ~(3 << 5);                                                                               /* clear config */
     prev |= range << 5;                                                                              /* set range */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);        /* write spo2 config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);               /* write spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write spo2 config failed.\n");                                /* write spo2 config failed */
@@ -1670,7 +3648,7 @@ uint8_t max30105_get_particle_sensing_adc_range(max30105_handle_t *handle, max30
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);         /* read spo2 config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);                /* read spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read spo2 config failed.\n");                                 /* read spo2 config failed */
@@ -1707,7 +3685,7 @@ uint8_t max30105_set_particle_sensing_sample_rate(max30105_handle_t *handle, max
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);         /* read spo2 config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);                /* read spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read spo2 config failed.\n");                                 /* read spo2 config failed */
@@ -1716,7 +3694,7 @@ uint8_t max30105_set_particle_sensing_sample_rate(max30105_handle_t *handle, max
     }
     prev &= ~(7 << 2);                                                                               /* clear config */
     prev |= rate << 2;                                                                               /* set sample rate */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);        /* write spo2 config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);               /* write spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write spo2 config failed.\n");                                /* write spo2 config failed */
@@ -1752,7 +3730,7 @@ uint8_t max30105_get_particle_sensing_sample_rate(max30105_handle_t *handle, max
         return 3;                                                                                   /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);        /* read spo2 config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);               /* read spo2 config */
     if (res != 0)                                                                                   /* check result */
     {
         handle->debug_print("max30105: read spo2 config failed.\n");                                /* read spo2 config failed */
@@ -1789,7 +3767,7 @@ uint8_t max30105_set_adc_resolution(max30105_handle_t *handle, max30105_adc_reso
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);         /* read spo2 config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);                /* read spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read spo2 config failed.\n");                                 /* read spo2 config failed */
@@ -1798,7 +3776,7 @@ uint8_t max30105_set_adc_resolution(max30105_handle_t *handle, max30105_adc_reso
     }
     prev &= ~(3 << 0);                                                                               /* clear config */
     prev |= resolution << 0;                                                                         /* set adc resolution */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);        /* write spo2 config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);               /* write spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: write spo2 config failed.\n");                                /* write spo2 config failed */
@@ -1834,7 +3812,7 @@ uint8_t max30105_get_adc_resolution(max30105_handle_t *handle, max30105_adc_reso
         return 3;                                                                                    /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev, 1);         /* read spo2 config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_SPO2_CONFIG, (uint8_t *)&prev);                /* read spo2 config */
     if (res != 0)                                                                                    /* check result */
     {
         handle->debug_print("max30105: read spo2 config failed.\n");                                 /* read spo2 config failed */
@@ -1870,7 +3848,7 @@ uint8_t max30105_set_led_red_pulse_amplitude(max30105_handle_t *handle, uint8_t
         return 3;                                                                                /* return error */
     }
     
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_LED_1_PA, (uint8_t *)&amp, 1);        /* write led 1 pa*/
+    res = a_max30105_shadow_write(handle, MAX30105_REG_LED_1_PA, (uint8_t *)&amp);               /* write led 1 pa*/
     if (res != 0)                                                                                /* check result */
     {
         handle->debug_print("max30105: write led 1 pa failed.\n");                               /* write led 1 pa failed */
@@ -1905,7 +3883,7 @@ uint8_t max30105_get_led_red_pulse_amplitude(max30105_handle_t *handle, uint8_t
         return 3;                                                                              /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_LED_1_PA, (uint8_t *)amp, 1);        /* read led 1 pa */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_LED_1_PA, (uint8_t *)amp);               /* read led 1 pa */
     if (res != 0)                                                                              /* check result */
     {
         handle->debug_print("max30105: read led 1 pa failed.\n");                              /* read led 1 pa failed */
@@ -1940,7 +3918,7 @@ uint8_t max30105_set_led_ir_pulse_amplitude(max30105_handle_t *handle, uint8_t a
         return 3;                                                                                /* return error */
     }
     
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_LED_2_PA, (uint8_t *)&amp, 1);        /* write led 2 pa */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_LED_2_PA, (uint8_t *)&amp);               /* write led 2 pa */
     if (res != 0)                                                                                /* check result */
     {
         handle->debug_print("max30105: write led 2 pa failed.\n");                               /* write led 2 pa failed */
@@ -1975,7 +3953,7 @@ uint8_t max30105_get_led_ir_pulse_amplitude(max30105_handle_t *handle, uint8_t *
         return 3;                                                                              /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_LED_2_PA, (uint8_t *)amp, 1);        /* read led 2 pa */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_LED_2_PA, (uint8_t *)amp);               /* read led 2 pa */
     if (res != 0)                                                                              /* check result */
     {
         handle->debug_print("max30105: read led 2 pa failed.\n");                              /* read led 2 pa failed */
@@ -2010,7 +3988,7 @@ uint8_t max30105_set_led_green_pulse_amplitude(max30105_handle_t *handle, uint8_
         return 3;                                                                                /* return error */
     }
     
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_LED_3_PA, (uint8_t *)&amp, 1);        /* write led 3 pa */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_LED_3_PA, (uint8_t *)&amp);               /* write led 3 pa */
     if (res != 0)                                                                                /* check result */
     {
         handle->debug_print("max30105: write led 3 pa failed.\n");                               /* write led 3 pa failed */
@@ -2045,7 +4023,7 @@ uint8_t max30105_get_led_green_pulse_amplitude(max30105_handle_t *handle, uint8_
         return 3;                                                                              /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_LED_3_PA, (uint8_t *)amp, 1);        /* read led 3 pa */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_LED_3_PA, (uint8_t *)amp);               /* read led 3 pa */
     if (res != 0)                                                                              /* check result */
     {
         handle->debug_print("max30105: read led 3 pa failed.\n");                              /* read led 3 pa failed */
@@ -2080,7 +4058,7 @@ uint8_t max30105_set_led_proximity_pulse_amplitude(max30105_handle_t *handle, ui
         return 3;                                                                                /* return error */
     }
     
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_PILOT_PA, (uint8_t *)&amp, 1);        /* write led proximity pa */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_PILOT_PA, (uint8_t *)&amp);               /* write led proximity pa */
     if (res != 0)                                                                                /* check result */
     {
         handle->debug_print("max30105: write led proximity pa failed.\n");                       /* write led proximity pa failed */
@@ -2115,7 +4093,7 @@ uint8_t max30105_get_led_proximity_pulse_amplitude(max30105_handle_t *handle, ui
         return 3;                                                                              /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_PILOT_PA, (uint8_t *)amp, 1);        /* read led proximity pa */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_PILOT_PA, (uint8_t *)amp);               /* read led proximity pa */
     if (res != 0)                                                                              /* check result */
     {
         handle->debug_print("max30105: read led proximity pa failed.\n");                      /* read led proximity pa failed */
@@ -2154,7 +4132,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     
     if (slot == MAX30105_SLOT_1)                                                                                     /* slot 1 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2163,7 +4141,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
         }
         prev &= ~(0x7 << 0);                                                                                         /* clear config */
         prev |= led << 0;                                                                                            /* set led */
-        res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev, 1);       /* write led slot */
+        res = a_max30105_shadow_write(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev);              /* write led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: write led slot failed.\n");                                               /* write led slot failed */
@@ -2175,7 +4153,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     }
     else if (slot == MAX30105_SLOT_2)                                                                                /* slot 2 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2184,7 +4162,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
         }
         prev &= ~(0x7 << 4);                                                                                         /* clear config */
         prev |= led << 4;                                                                                            /* set led */
-        res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev, 1);       /* write led slot */
+        res = a_max30105_shadow_write(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev);              /* write led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: write led slot failed.\n");                                               /* write led slot failed */
@@ -2196,7 +4174,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     }
     else if (slot == MAX30105_SLOT_3)                                                                                /* slot 3 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2205,7 +4183,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
         }
         prev &= ~(0x7 << 0);                                                                                         /* clear config */
         prev |= led << 0;                                                                                            /* set led */
-        res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev, 1);       /* write led slot */
+        res = a_max30105_shadow_write(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev);              /* write led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: write led slot failed.\n");                                               /* write led slot failed */
@@ -2217,7 +4195,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     }
     else if (slot == MAX30105_SLOT_4)                                                                                /* slot 4 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2226,7 +4204,7 @@ uint8_t max30105_set_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
         }
         prev &= ~(0x7 << 4);                                                                                         /* clear config */
         prev |= led << 4;                                                                                            /* set led */
-        res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev, 1);       /* write led slot */
+        res = a_max30105_shadow_write(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev);              /* write led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: write led slot failed.\n");                                               /* write led slot failed */
@@ -2272,7 +4250,7 @@ uint8_t max30105_get_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     
     if (slot == MAX30105_SLOT_1)                                                                                     /* slot 1 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2285,7 +4263,7 @@ uint8_t max30105_get_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     }
     else if (slot == MAX30105_SLOT_2)                                                                                /* slot 2 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_1, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2298,7 +4276,7 @@ uint8_t max30105_get_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     }
     else if (slot == MAX30105_SLOT_3)                                                                                /* slot 3 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2311,7 +4289,7 @@ uint8_t max30105_get_slot(max30105_handle_t *handle, max30105_slot_t slot, max30
     }
     else if (slot == MAX30105_SLOT_4)                                                                                /* slot 4 */
     {
-        res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev, 1);        /* read led slot */
+        res = a_max30105_shadow_read(handle, MAX30105_REG_MULTI_LED_MODE_CONTROL_2, (uint8_t *)&prev);               /* read led slot */
         if (res != 0)                                                                                                /* check result */
         {
             handle->debug_print("max30105: read led slot failed.\n");                                                /* read led slot failed */
@@ -2355,7 +4333,7 @@ uint8_t max30105_set_die_temperature(max30105_handle_t *handle, max30105_bool_t
         return 3;                                                                                        /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev, 1);         /* read die temp config */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev);                /* read die temp config */
     if (res != 0)                                                                                        /* check result */
     {
         handle->debug_print("max30105: read die temp config failed.\n");                                 /* read die temp config failed */
@@ -2364,7 +4342,7 @@ uint8_t max30105_set_die_temperature(max30105_handle_t *handle, max30105_bool_t
     }
     prev &= ~(1 << 0);                                                                                   /* clear config */
     prev |= (enable << 0);                                                                               /* set bool */
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev, 1);        /* write die temp config */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev);               /* write die temp config */
     if (res != 0)                                                                                        /* check result */
     {
         handle->debug_print("max30105: write die temp config failed.\n");                                /* write die temp config failed */
@@ -2400,7 +4378,7 @@ uint8_t max30105_get_die_temperature(max30105_handle_t *handle, max30105_bool_t
         return 3;                                                                                        /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev, 1);         /* read die temp config */
+    res = a_max30105_iic_read(handle, MAX30105_REG_DIE_TEMP_CONFIG, (uint8_t *)&prev, 1);                /* read die temp config */
     if (res != 0)                                                                                        /* check result */
     {
         handle->debug_print("max30105: read die temp config failed.\n");                                 /* read die temp config failed */
@@ -2436,7 +4414,7 @@ uint8_t max30105_set_proximity_interrupt_threshold(max30105_handle_t *handle, ui
         return 3;                                                                                             /* return error */
     }
     
-    res = handle->iic_write(MAX30105_ADDRESS, MAX30105_REG_PROX_INT_THRESH, (uint8_t *)&threshold, 1);        /* write proximity interrupt threshold */
+    res = a_max30105_shadow_write(handle, MAX30105_REG_PROX_INT_THRESH, (uint8_t *)&threshold);               /* write proximity interrupt threshold */
     if (res != 0)                                                                                             /* check result */
     {
         handle->debug_print("max30105: write proximity interrupt threshold failed.\n");                       /* write read proximity interrupt threshold failed */
@@ -2471,7 +4449,7 @@ uint8_t max30105_get_proximity_interrupt_threshold(max30105_handle_t *handle, ui
         return 3;                                                                                           /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_PROX_INT_THRESH, (uint8_t *)threshold, 1);        /* read proximity interrupt threshold */
+    res = a_max30105_shadow_read(handle, MAX30105_REG_PROX_INT_THRESH, (uint8_t *)threshold);               /* read proximity interrupt threshold */
     if (res != 0)                                                                                           /* check result */
     {
         handle->debug_print("max30105: read proximity interrupt threshold failed.\n");                      /* read read proximity interrupt threshold failed */
@@ -2561,14 +4539,14 @@ uint8_t max30105_get_id(max30105_handle_t *handle, uint8_t *revision_id, uint8_t
         return 3;                                                                                         /* return error */
     }
     
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_REVISION_ID, (uint8_t *)revision_id, 1);        /* read revision id */
+    res = a_max30105_iic_read(handle, MAX30105_REG_REVISION_ID, (uint8_t *)revision_id, 1);               /* read revision id */
     if (res != 0)                                                                                         /* check result */
     {
         handle->debug_print("max30105: read revision id failed.\n");                                      /* read revision id failed */
        
         return 1;                                                                                         /* return error */
     }
-    res = handle->iic_read(MAX30105_ADDRESS, MAX30105_REG_PART_ID, (uint8_t *)part_id, 1);                /* read part id */
+    res = a_max30105_iic_read(handle, MAX30105_REG_PART_ID, (uint8_t *)part_id, 1);                       /* read part id */
     if (res != 0)                                                                                         /* check result */
     {
         handle->debug_print("max30105: read part id failed.\n");                                          /* read part id failed */
@@ -2579,6 +4557,258 @@ uint8_t max30105_get_id(max30105_handle_t *handle, uint8_t *revision_id, uint8_t
     return 0;                                                                                             /* success return 0 */
 }
 
+/**
+ * @brief     resync the register shadow from the chip
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 resync failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it after a reset or a power ready event, the decoders, the clock estimation
+ *            and the pending interrupt edge and overrun gap are cleared like in max30105_shadow_invalidate
+ */
+uint8_t max30105_shadow_resync(max30105_handle_t *handle)
+{
+    uint8_t res;
+    max30105_iic_transfer_t transfer[4];
+    
+    if (handle == NULL)                                                                                           /* check handle */
+    {
+        return 2;                                                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                                                      /* check handle initialization */
+    {
+        return 3;                                                                                                 /* return error */
+    }
+    
+    a_max30105_shadow_clear(handle);                                                                              /* clear the shadow and its derived state */
+    transfer[0].reg = MAX30105_REG_INTERRUPT_ENABLE_1;                                                            /* interrupt enable */
+    transfer[0].read = 1;                                                                                         /* read */
+    transfer[0].buf = (uint8_t *)&handle->shadow[0];                                                              /* set buffer */
+    transfer[0].len = 2;                                                                                          /* set length */
+    transfer[1].reg = MAX30105_REG_FIFO_CONFIG;                                                                   /* config */
+    transfer[1].read = 1;                                                                                         /* read */
+    transfer[1].buf = (uint8_t *)&handle->shadow[2];                                                              /* set buffer */
+    transfer[1].len = 11;                                                                                         /* set length */
+    transfer[2].reg = MAX30105_REG_DIE_TEMP_CONFIG;                                                               /* die temp config */
+    transfer[2].read = 1;                                                                                         /* read */
+    transfer[2].buf = (uint8_t *)&handle->shadow[13];                                                             /* set buffer */
+    transfer[2].len = 1;                                                                                          /* set length */
+    transfer[3].reg = MAX30105_REG_PROX_INT_THRESH;                                                               /* proximity interrupt threshold */
+    transfer[3].read = 1;                                                                                         /* read */
+    transfer[3].buf = (uint8_t *)&handle->shadow[14];                                                             /* set buffer */
+    transfer[3].len = 1;                                                                                          /* set length */
+    res = a_max30105_iic_transfer(handle, transfer, 4);                                                           /* read all shadowed registers at once */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("max30105: read config failed.\n");                                                   /* read config failed */
+        
+        return 1;                                                                                                 /* return error */
+    }
+    handle->shadow[13] &= (uint8_t)(~(1 << 0));                                                                   /* temp enable bit is self-cleared */
+    handle->shadow_valid = MAX30105_SHADOW_ALL;                                                                   /* set all valid */
+    a_max30105_decoder_select(handle);                                                                            /* select the decoder */
+    
+    return 0;                                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     invalidate the register shadow
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the next access of each register goes to the bus, the decoders, the clock
+ *            estimation and the pending interrupt edge and overrun gap are cleared too
+ */
+uint8_t max30105_shadow_invalidate(max30105_handle_t *handle)
+{
+    if (handle == NULL)                     /* check handle */
+    {
+        return 2;                           /* return error */
+    }
+    if (handle->inited != 1)                /* check handle initialization */
+    {
+        return 3;                           /* return error */
+    }
+    
+    a_max30105_shadow_clear(handle);        /* clear the shadow and the derived state */
+    
+    return 0;                               /* success return 0 */
+}
+
+/**
+ * @brief     apply a whole chip config
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *config pointer to a config structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 apply config failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 fifo almost full value can't be over 0xF
+ * @note      the register image is built in memory and written in five bursts,
+ *            0x02 - 0x03, 0x0C - 0x0E, 0x10 - 0x12, 0x30 and 0x08 - 0x0A, mode config goes last,
+ *            the reserved register 0x0F is never written
+ */
+uint8_t max30105_apply_config(max30105_handle_t *handle, const max30105_config_t *config)
+{
+    uint8_t res;
+    uint8_t buf[3];
+    
+    if (handle == NULL)                                                                                               /* check handle */
+    {
+        return 2;                                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                                     /* return error */
+    }
+    
+    if (config->fifo_almost_full > 0xF)                                                                               /* check value */
+    {
+        handle->debug_print("max30105: value can't be over 0xF.\n");                                                  /* value can't be over 0xF */
+       
+        return 4;                                                                                                     /* return error */
+    }
+    
+    buf[0] = (uint8_t)((config->interrupt_fifo_full << MAX30105_INTERRUPT_FIFO_FULL_EN) |                             /* set interrupt enable 1 */
+                       (config->interrupt_data_rdy << MAX30105_INTERRUPT_DATA_RDY_EN) |                               /* set interrupt enable 1 */
+                       (config->interrupt_alc_ovf << MAX30105_INTERRUPT_ALC_OVF_EN) |                                 /* set interrupt enable 1 */
+                       (config->interrupt_prox_int << MAX30105_INTERRUPT_PROX_INT_EN));                               /* set interrupt enable 1 */
+    buf[1] = (uint8_t)(config->interrupt_die_temp_rdy << MAX30105_INTERRUPT_DIE_TEMP_RDY_EN);                         /* set interrupt enable 2 */
+    res = a_max30105_shadow_write_burst(handle, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)buf, 2);                  /* write interrupt enable */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: write interrupt enable failed.\n");                                            /* write interrupt enable failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    buf[0] = config->led_red_pulse_amplitude;                                                                         /* set led 1 pa */
+    buf[1] = config->led_ir_pulse_amplitude;                                                                          /* set led 2 pa */
+    buf[2] = config->led_green_pulse_amplitude;                                                                       /* set led 3 pa */
+    res = a_max30105_shadow_write_burst(handle, MAX30105_REG_LED_1_PA, (uint8_t *)buf, 3);                            /* write led pa */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: write led pa failed.\n");                                                      /* write led pa failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    buf[0] = config->led_proximity_pulse_amplitude;                                                                   /* set pilot pa */
+    buf[1] = (uint8_t)((config->slot[1] << 4) | (config->slot[0] << 0));                                              /* set slot 2 and slot 1 */
+    buf[2] = (uint8_t)((config->slot[3] << 4) | (config->slot[2] << 0));                                              /* set slot 4 and slot 3 */
+    res = a_max30105_shadow_write_burst(handle, MAX30105_REG_PILOT_PA, (uint8_t *)buf, 3);                            /* write pilot pa and slot */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: write led config failed.\n");                                                  /* write led config failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    buf[0] = config->proximity_threshold;                                                                             /* set proximity threshold */
+    res = a_max30105_shadow_write_burst(handle, MAX30105_REG_PROX_INT_THRESH, (uint8_t *)buf, 1);                     /* write proximity interrupt threshold */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: write proximity interrupt threshold failed.\n");                               /* write proximity interrupt threshold failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    buf[0] = (uint8_t)((config->sample_averaging << 5) | (config->fifo_roll << 4) |                                   /* set fifo config */
+                       (config->fifo_almost_full << 0));                                                              /* set fifo config */
+    buf[1] = (uint8_t)((config->shutdown << 7) | (config->mode << 0));                                                /* set mode config */
+    buf[2] = (uint8_t)((config->adc_range << 5) | (config->sample_rate << 2) |                                        /* set spo2 config */
+                       (config->adc_resolution << 0));                                                                /* set spo2 config */
+    res = a_max30105_shadow_write_burst(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)buf, 3);                         /* write fifo, mode and spo2 config */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: write fifo mode spo2 config failed.\n");                                       /* write fifo mode spo2 config failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief      read back the whole chip config
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *config pointer to a config structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 read config failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the registers are read in four bursts and the shadow is refreshed
+ */
+uint8_t max30105_read_config(max30105_handle_t *handle, max30105_config_t *config)
+{
+    uint8_t res;
+    uint8_t buf[7];
+    
+    if (handle == NULL)                                                                                               /* check handle */
+    {
+        return 2;                                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                                     /* return error */
+    }
+    
+    res = a_max30105_shadow_read_burst(handle, MAX30105_REG_INTERRUPT_ENABLE_1, (uint8_t *)buf, 2);                   /* read interrupt enable */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: read interrupt enable failed.\n");                                             /* read interrupt enable failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    config->interrupt_fifo_full = (max30105_bool_t)((buf[0] >> MAX30105_INTERRUPT_FIFO_FULL_EN) & 0x01);              /* get fifo full interrupt */
+    config->interrupt_data_rdy = (max30105_bool_t)((buf[0] >> MAX30105_INTERRUPT_DATA_RDY_EN) & 0x01);                /* get data ready interrupt */
+    config->interrupt_alc_ovf = (max30105_bool_t)((buf[0] >> MAX30105_INTERRUPT_ALC_OVF_EN) & 0x01);                  /* get alc ovf interrupt */
+    config->interrupt_prox_int = (max30105_bool_t)((buf[0] >> MAX30105_INTERRUPT_PROX_INT_EN) & 0x01);                /* get proximity interrupt */
+    config->interrupt_die_temp_rdy = (max30105_bool_t)((buf[1] >> MAX30105_INTERRUPT_DIE_TEMP_RDY_EN) & 0x01);        /* get die temp ready interrupt */
+    res = a_max30105_shadow_read_burst(handle, MAX30105_REG_FIFO_CONFIG, (uint8_t *)buf, 3);                          /* read fifo, mode and spo2 config */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: read fifo mode spo2 config failed.\n");                                        /* read fifo mode spo2 config failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    config->sample_averaging = (max30105_sample_averaging_t)((buf[0] >> 5) & 0x7);                                    /* get sample averaging */
+    config->fifo_roll = (max30105_bool_t)((buf[0] >> 4) & 0x1);                                                       /* get fifo roll */
+    config->fifo_almost_full = buf[0] & 0xF;                                                                          /* get fifo almost full */
+    config->shutdown = (max30105_bool_t)((buf[1] >> 7) & 0x1);                                                        /* get shutdown */
+    config->mode = (max30105_mode_t)(buf[1] & 0x7);                                                                   /* get mode */
+    config->adc_range = (max30105_particle_sensing_adc_range_t)((buf[2] >> 5) & 0x3);                                 /* get adc range */
+    config->sample_rate = (max30105_particle_sensing_sample_rate_t)((buf[2] >> 2) & 0x7);                             /* get sample rate */
+    config->adc_resolution = (max30105_adc_resolution_t)(buf[2] & 0x3);                                               /* get adc resolution */
+    res = a_max30105_shadow_read_burst(handle, MAX30105_REG_LED_1_PA, (uint8_t *)buf, 7);                             /* read led pa and slot */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: read led config failed.\n");                                                   /* read led config failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    config->led_red_pulse_amplitude = buf[0];                                                                         /* get led 1 pa */
+    config->led_ir_pulse_amplitude = buf[1];                                                                          /* get led 2 pa */
+    config->led_green_pulse_amplitude = buf[2];                                                                       /* get led 3 pa */
+    config->led_proximity_pulse_amplitude = buf[4];                                                                   /* get pilot pa */
+    config->slot[0] = (max30105_led_t)((buf[5] >> 0) & 0x7);                                                          /* get slot 1 */
+    config->slot[1] = (max30105_led_t)((buf[5] >> 4) & 0x7);                                                          /* get slot 2 */
+    config->slot[2] = (max30105_led_t)((buf[6] >> 0) & 0x7);                                                          /* get slot 3 */
+    config->slot[3] = (max30105_led_t)((buf[6] >> 4) & 0x7);                                                          /* get slot 4 */
+    res = a_max30105_shadow_read_burst(handle, MAX30105_REG_PROX_INT_THRESH, (uint8_t *)buf, 1);                      /* read proximity interrupt threshold */
+    if (res != 0)                                                                                                     /* check result */
+    {
+        handle->debug_print("max30105: read proximity interrupt threshold failed.\n");                                /* read proximity interrupt threshold failed */
+       
+        return 1;                                                                                                     /* return error */
+    }
+    config->proximity_threshold = buf[0];                                                                             /* get proximity threshold */
+    
+    return 0;                                                                                                         /* success return 0 */
+}
+
 /**
  * @brief     set the chip register
  * @param[in] *handle pointer to a max30105 handle structure
@@ -2603,7 +4833,8 @@ uint8_t max30105_set_reg(max30105_handle_t *handle, uint8_t reg, uint8_t *buf, u
         return 3;                                                  /* return error */
     }
     
-    if (handle->iic_write(MAX30105_ADDRESS, reg, buf, len) != 0)   /* write data */
+    a_max30105_shadow_clear(handle);                               /* the shadow may be stale */
+    if (a_max30105_iic_write(handle, reg, buf, len) != 0)          /* write data */
     {
         return 1;                                                  /* return error */
     }
@@ -2637,7 +4868,7 @@ uint8_t max30105_get_reg(max30105_handle_t *handle, uint8_t reg, uint8_t *buf, u
         return 3;                                                 /* return error */
     }
     
-    if (handle->iic_read(MAX30105_ADDRESS, reg, buf, len) != 0)   /* read data */
+    if (a_max30105_iic_read(handle, reg, buf, len) != 0)          /* read data */
     {
         return 1;                                                 /* return error */
     }
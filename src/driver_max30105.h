@@ -45,6 +45,13 @@
 extern "C"{
 #endif
 
+/**
+ * @brief statistics counters in the handle, define it as 1 for all translation units to compile them in
+ */
+#ifndef MAX30105_STATS
+    #define MAX30105_STATS    0
+#endif
+
 /**
  * @defgroup max30105_driver max30105 driver function
  * @brief    max30105 driver modules
@@ -175,6 +182,119 @@ typedef enum
     MAX30105_SLOT_4 = 3,        /**< slot 4 */
 } max30105_slot_t;
 
+/**
+ * @brief max30105 config structure definition
+ */
+typedef struct max30105_config_s
+{
+    max30105_bool_t interrupt_fifo_full;                          /**< fifo almost full interrupt enable */
+    max30105_bool_t interrupt_data_rdy;                           /**< new fifo data ready interrupt enable */
+    max30105_bool_t interrupt_alc_ovf;                            /**< ambient light cancellation overflow interrupt enable */
+    max30105_bool_t interrupt_prox_int;                           /**< proximity threshold interrupt enable */
+    max30105_bool_t interrupt_die_temp_rdy;                       /**< internal temperature interrupt enable */
+    max30105_sample_averaging_t sample_averaging;                 /**< fifo sample averaging */
+    max30105_bool_t fifo_roll;                                    /**< fifo roll enable */
+    uint8_t fifo_almost_full;                                     /**< fifo almost full value */
+    max30105_bool_t shutdown;                                     /**< shutdown enable */
+    max30105_mode_t mode;                                         /**< chip mode */
+    max30105_particle_sensing_adc_range_t adc_range;              /**< particle sensing adc range */
+    max30105_particle_sensing_sample_rate_t sample_rate;          /**< particle sensing sample rate */
+    max30105_adc_resolution_t adc_resolution;                     /**< adc resolution */
+    uint8_t led_red_pulse_amplitude;                              /**< led red pulse amplitude */
+    uint8_t led_ir_pulse_amplitude;                               /**< led ir pulse amplitude */
+    uint8_t led_green_pulse_amplitude;                            /**< led green pulse amplitude */
+    uint8_t led_proximity_pulse_amplitude;                        /**< led proximity pulse amplitude */
+    max30105_led_t slot[4];                                       /**< led of slot 1 - 4 */
+    uint8_t proximity_threshold;                                  /**< proximity interrupt threshold register value */
+} max30105_config_t;
+
+/**
+ * @brief max30105 sample flag enumeration definition
+ */
+typedef enum
+{
+    MAX30105_SAMPLE_FLAG_SATURATED    = (1 << 0),        /**< a channel is at the adc full scale */
+    MAX30105_SAMPLE_FLAG_OVERFLOW_GAP = (1 << 1),        /**< samples were lost right before this one */
+} max30105_sample_flag_t;
+
+/**
+ * @brief max30105 sample structure definition
+ */
+typedef struct max30105_sample_s
+{
+    uint64_t sequence;        /**< monotonic sample sequence number */
+    uint64_t timestamp;       /**< sample time in ns, 0 before the first edge timestamp */
+    uint32_t red;             /**< red raw data */
+    uint32_t ir;              /**< ir raw data */
+    uint32_t green;           /**< green raw data */
+    uint32_t lost;            /**< samples lost right before this one, set with the overflow gap flag */
+    uint8_t flags;            /**< sample flags */
+} max30105_sample_t;
+
+/**
+ * @brief max30105 loss statistics structure definition
+ */
+typedef struct max30105_loss_s
+{
+    uint64_t lost;             /**< total lost samples */
+    uint32_t overruns;         /**< fifo overruns */
+    uint32_t saturated;        /**< overruns with a saturated overflow counter, more samples may be lost */
+} max30105_loss_t;
+
+#if (MAX30105_STATS != 0)
+/**
+ * @brief max30105 timed api enumeration definition
+ */
+typedef enum
+{
+    MAX30105_API_IRQ_HANDLER      = 0,        /**< max30105_irq_handler */
+    MAX30105_API_READ             = 1,        /**< max30105_read */
+    MAX30105_API_READ_FIFO_RAW    = 2,        /**< max30105_read_fifo_raw */
+    MAX30105_API_READ_SAMPLES     = 3,        /**< max30105_read_samples */
+    MAX30105_API_POLL             = 4,        /**< max30105_poll */
+    MAX30105_API_READ_TEMPERATURE = 5,        /**< max30105_read_temperature */
+    MAX30105_API_NUM              = 6,        /**< number of timed apis */
+} max30105_api_t;
+
+/**
+ * @brief max30105 api time structure definition
+ */
+typedef struct max30105_api_time_s
+{
+    uint32_t calls;           /**< calls */
+    uint64_t ns;              /**< total time in ns, 0 without a timestamp function */
+    uint64_t max_ns;          /**< longest call in ns */
+} max30105_api_time_t;
+
+/**
+ * @brief max30105 statistics structure definition
+ */
+typedef struct max30105_stats_s
+{
+    uint32_t iic_read;                                 /**< iic read calls */
+    uint32_t iic_write;                                /**< iic write calls */
+    uint32_t iic_transfer;                             /**< iic batch transfer calls */
+    uint32_t iic_failed;                               /**< failed iic calls */
+    uint64_t read_bytes;                               /**< payload bytes read */
+    uint64_t write_bytes;                              /**< payload bytes written */
+    uint64_t samples;                                  /**< samples delivered by the read functions */
+    uint32_t overflows;                                /**< fifo overruns seen by a read */
+    uint32_t irq[8];                                   /**< irq handler callbacks indexed by the interrupt status bit */
+    max30105_api_time_t api[MAX30105_API_NUM];         /**< time of each timed api */
+} max30105_stats_t;
+#endif
+
+/**
+ * @brief max30105 iic transfer structure definition
+ */
+typedef struct max30105_iic_transfer_s
+{
+    uint8_t reg;          /**< iic register address */
+    uint8_t read;         /**< 1 to read from the register, 0 to write to it */
+    uint8_t *buf;         /**< pointer to a data buffer */
+    uint16_t len;         /**< length of the data buffer */
+} max30105_iic_transfer_t;
+
 /**
  * @brief max30105 handle structure definition
  */
@@ -187,11 +307,70 @@ typedef struct max30105_handle_s
     void (*receive_callback)(uint8_t type);                                             /**< point to a receive_callback function address */
     void (*delay_ms)(uint32_t ms);                                                      /**< point to a delay_ms function address */
     void (*debug_print)(const char *const fmt, ...);                                    /**< point to a debug_print function address */
+    void *user;                                                                         /**< user context passed to the ctx functions */
+    uint8_t (*iic_init_ctx)(void *user);                                                /**< point to an iic_init_ctx function address */
+    uint8_t (*iic_deinit_ctx)(void *user);                                              /**< point to an iic_deinit_ctx function address */
+    uint8_t (*iic_read_ctx)(void *user, uint8_t addr, uint8_t reg,
+                            uint8_t *buf, uint16_t len);                                /**< point to an iic_read_ctx function address */
+    uint8_t (*iic_write_ctx)(void *user, uint8_t addr, uint8_t reg,
+                             uint8_t *buf, uint16_t len);                               /**< point to an iic_write_ctx function address */
+    void (*receive_callback_ctx)(void *user, uint8_t type);                             /**< point to a receive_callback_ctx function address */
+    void (*delay_ms_ctx)(void *user, uint32_t ms);                                      /**< point to a delay_ms_ctx function address */
+    uint8_t (*iic_transfer)(uint8_t addr, max30105_iic_transfer_t *transfer,
+                            uint8_t num);                                               /**< point to an optional iic_transfer function address */
+    uint8_t (*iic_transfer_ctx)(void *user, uint8_t addr,
+                                max30105_iic_transfer_t *transfer, uint8_t num);        /**< point to an optional iic_transfer_ctx function address */
     uint8_t inited;                                                                     /**< inited flag */
     uint8_t finished_flag;                                                              /**< finished flag */
     uint16_t raw;                                                                       /**< raw */
     float temperature;                                                                  /**< temperature */
+    uint8_t shadow[15];                                                                 /**< register shadow */
+    uint16_t shadow_valid;                                                              /**< register shadow valid flag */
+    void (*decoder)(const uint8_t *buf, uint32_t len, uint32_t *raw_red,
+                    uint32_t *raw_ir, uint32_t *raw_green);                             /**< point to the selected fifo decoder */
+    void (*sample_decoder)(const uint8_t *buf, uint32_t len, uint64_t sequence,
+                           max30105_sample_t *sample);                                  /**< point to the selected sample decoder */
+    uint64_t sequence;                                                                  /**< next sample sequence number */
+    uint32_t gap_lost;                                                                  /**< lost samples of the pending gap */
+    uint8_t gap_after;                                                                  /**< samples left before the pending gap */
+    uint64_t batch_sequence;                                                            /**< sequence number of the first sample of the last drained batch */
+    uint32_t batch_lost;                                                                /**< lost samples of the gap in the last drained batch */
+    uint8_t batch_gap;                                                                  /**< index of the gap in the last drained batch */
+    uint8_t fifo_level;                                                                 /**< fifo level of the last read */
+    uint8_t fifo_lost;                                                                  /**< overflow counter of the last read */
+    max30105_loss_t loss;                                                               /**< loss statistics */
+    uint8_t watermark_enable;                                                           /**< watermark control enable flag */
+    uint8_t watermark_margin;                                                           /**< watermark safety margin in samples */
+    uint8_t watermark_peak;                                                             /**< peak service latency in samples */
+    uint8_t watermark_calm;                                                             /**< interrupts below the peak */
+    uint8_t watermark_edge;                                                             /**< fifo full edge not yet measured */
+    uint64_t edge_timestamp;                                                            /**< time of the last interrupt edge in ns */
+    uint8_t edge_pending;                                                               /**< 1 for an edge sample in the fifo, 2 for one in the last drained batch */
+    uint8_t edge_level;                                                                 /**< fifo level that raised the last fifo full edge */
+    uint8_t edge_count;                                                                 /**< samples in the fifo up to the edge sample, 0 for the newest sample */
+    uint8_t edge_offset;                                                                /**< index of the edge sample in the last drained batch */
+    uint8_t clock_valid;                                                                /**< clock model valid flag */
+    uint64_t clock_sequence;                                                            /**< sequence number of the clock reference */
+    uint64_t clock_time;                                                                /**< time of the clock reference in ns */
+    uint64_t clock_period;                                                              /**< estimated sample period in ns << 8 */
+    uint64_t clock_nominal;                                                             /**< configured sample period in ns << 8 */
+    uint8_t poll_margin;                                                                /**< polling safety margin in samples */
+    uint8_t poll_late;                                                                  /**< peak wake up latency in samples */
+    uint8_t poll_calm;                                                                  /**< polls below the peak */
+    uint8_t fifo_known;                                                                 /**< fifo pointers read with the interrupt status flag */
+    uint8_t fifo_point[3];                                                              /**< fifo pointers read with the interrupt status */
+    uint8_t irq_fifo_drain;                                                             /**< drain the fifo in the irq flag */
+    uint8_t irq_fifo_len;                                                               /**< irq drained fifo length */
+    uint32_t *irq_raw_red;                                                              /**< irq red raw data buffer */
+    uint32_t *irq_raw_ir;                                                               /**< irq ir raw data buffer */
+    uint32_t *irq_raw_green;                                                            /**< irq green raw data buffer */
     uint8_t buf[288];                                                                   /**< inner buffer */
+#if (MAX30105_STATS != 0)
+    uint64_t (*timestamp_ctx)(void *user);                                              /**< point to an optional monotonic clock function in ns */
+    max30105_stats_t stats;                                                             /**< statistics counters */
+    uint8_t stats_depth;                                                                /**< nesting depth of the timed apis */
+    uint64_t stats_start;                                                               /**< start time of the outermost timed api */
+#endif
 } max30105_handle_t;
 
 /**
@@ -285,6 +464,91 @@ typedef struct max30105_info_s
  */
 #define DRIVER_MAX30105_LINK_RECEIVE_CALLBACK(HANDLE, FUC)  (HANDLE)->receive_callback = FUC
 
+/**
+ * @brief     link the user context
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] USER user context pointer passed to every ctx function
+ * @note      none
+ */
+#define DRIVER_MAX30105_LINK_USER(HANDLE, USER)                  (HANDLE)->user = USER
+
+/**
+ * @brief     link iic_init_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to an iic_init_ctx function address
+ * @note      the ctx function takes priority over iic_init
+ */
+#define DRIVER_MAX30105_LINK_IIC_INIT_CTX(HANDLE, FUC)           (HANDLE)->iic_init_ctx = FUC
+
+/**
+ * @brief     link iic_deinit_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to an iic_deinit_ctx function address
+ * @note      the ctx function takes priority over iic_deinit
+ */
+#define DRIVER_MAX30105_LINK_IIC_DEINIT_CTX(HANDLE, FUC)         (HANDLE)->iic_deinit_ctx = FUC
+
+/**
+ * @brief     link iic_read_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to an iic_read_ctx function address
+ * @note      the ctx function takes priority over iic_read
+ */
+#define DRIVER_MAX30105_LINK_IIC_READ_CTX(HANDLE, FUC)           (HANDLE)->iic_read_ctx = FUC
+
+/**
+ * @brief     link iic_write_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to an iic_write_ctx function address
+ * @note      the ctx function takes priority over iic_write
+ */
+#define DRIVER_MAX30105_LINK_IIC_WRITE_CTX(HANDLE, FUC)          (HANDLE)->iic_write_ctx = FUC
+
+/**
+ * @brief     link delay_ms_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to a delay_ms_ctx function address
+ * @note      the ctx function takes priority over delay_ms
+ */
+#define DRIVER_MAX30105_LINK_DELAY_MS_CTX(HANDLE, FUC)           (HANDLE)->delay_ms_ctx = FUC
+
+/**
+ * @brief     link receive_callback_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to a receive_callback_ctx function address
+ * @note      the ctx function takes priority over receive_callback
+ */
+#define DRIVER_MAX30105_LINK_RECEIVE_CALLBACK_CTX(HANDLE, FUC)   (HANDLE)->receive_callback_ctx = FUC
+
+/**
+ * @brief     link iic_transfer function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to an iic_transfer function address
+ * @note      optional, runs several register accesses in one bus transaction, the driver
+ *            only batches accesses that stay correct when a port runs them one after another
+ */
+#define DRIVER_MAX30105_LINK_IIC_TRANSFER(HANDLE, FUC)           (HANDLE)->iic_transfer = FUC
+
+/**
+ * @brief     link iic_transfer_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to an iic_transfer_ctx function address
+ * @note      optional, the ctx function takes priority over iic_transfer
+ */
+#define DRIVER_MAX30105_LINK_IIC_TRANSFER_CTX(HANDLE, FUC)       (HANDLE)->iic_transfer_ctx = FUC
+
+/**
+ * @brief     link timestamp_ctx function
+ * @param[in] HANDLE pointer to a max30105 handle structure
+ * @param[in] FUC pointer to a timestamp_ctx function address
+ * @note      optional, times the apis in the statistics, does nothing when they are compiled out
+ */
+#if (MAX30105_STATS != 0)
+#define DRIVER_MAX30105_LINK_TIMESTAMP_CTX(HANDLE, FUC)          (HANDLE)->timestamp_ctx = FUC
+#else
+#define DRIVER_MAX30105_LINK_TIMESTAMP_CTX(HANDLE, FUC)          (void)(HANDLE)
+#endif
+
 /**
  * @}
  */
@@ -360,10 +624,293 @@ uint8_t max30105_deinit(max30105_handle_t *handle);
  *                - 3 handle is not initialized
  *                - 4 fifo overrun
  *                - 5 mode is invalid
- * @note          none
+ * @note          mode and adc resolution are served from the register shadow,
+ *                an empty fifo returns len 0 without reading the fifo data register,
+ *                the buffers and the mode are checked before the fifo is popped
  */
 uint8_t max30105_read(max30105_handle_t *handle, uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green, uint8_t *len);
 
+/**
+ * @brief         read the raw fifo bytes
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[out]    *buf pointer to a raw data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *mode pointer to a mode buffer
+ * @param[out]    *resolution pointer to an adc resolution buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 fifo overrun
+ *                - 5 mode is invalid
+ * @note          len is in samples, buf must hold len * 9 bytes,
+ *                mode and resolution describe the bytes for max30105_decode
+ *                and are only set when len is not 0, the popped samples advance
+ *                the sample sequence and an overrun is recorded as a gap and in
+ *                the loss statistics like in max30105_read_samples
+ */
+uint8_t max30105_read_fifo_raw(max30105_handle_t *handle, uint8_t *buf, uint8_t *len,
+                               max30105_mode_t *mode, max30105_adc_resolution_t *resolution);
+
+/**
+ * @brief      decode raw fifo bytes
+ * @param[in]  mode chip mode of the raw bytes
+ * @param[in]  resolution adc resolution of the raw bytes
+ * @param[in]  *buf pointer to a raw data buffer
+ * @param[in]  len number of samples in the raw data buffer
+ * @param[out] *raw_red pointer to a red raw data buffer
+ * @param[out] *raw_ir pointer to an ir raw data buffer
+ * @param[out] *raw_green pointer to a green raw data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 buffer is NULL
+ *             - 5 mode is invalid
+ * @note       pure function without any bus access, raw_ir and raw_green
+ *             may be NULL when the mode doesn't fill them
+ */
+uint8_t max30105_decode(max30105_mode_t mode, max30105_adc_resolution_t resolution, const uint8_t *buf, uint32_t len,
+                        uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green);
+
+/**
+ * @brief         read the samples
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 fifo overrun
+ *                - 5 mode is invalid
+ * @note          sequence numbers continue across reads and skip the samples lost
+ *                in a fifo overrun, the first sample after the loss is flagged
+ */
+uint8_t max30105_read_samples(max30105_handle_t *handle, max30105_sample_t *sample, uint8_t *len);
+
+/**
+ * @brief      decode raw fifo bytes into samples
+ * @param[in]  mode chip mode of the raw bytes
+ * @param[in]  resolution adc resolution of the raw bytes
+ * @param[in]  *buf pointer to a raw data buffer
+ * @param[in]  len number of samples in the raw data buffer
+ * @param[in]  sequence sequence number of the first sample
+ * @param[out] *sample pointer to a sample buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 buffer is NULL
+ *             - 5 mode is invalid
+ * @note       pure function without any bus access, unused channels are 0
+ */
+uint8_t max30105_decode_samples(max30105_mode_t mode, max30105_adc_resolution_t resolution, const uint8_t *buf, uint32_t len,
+                                uint64_t sequence, max30105_sample_t *sample);
+
+/**
+ * @brief      get the sequence number of the next sample
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *sequence pointer to a sequence buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       counts every sample drained from the fifo and every sample lost in an overrun since init
+ */
+uint8_t max30105_get_sample_sequence(max30105_handle_t *handle, uint64_t *sequence);
+
+/**
+ * @brief     enable or disable the adaptive fifo almost full watermark
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] enable bool value
+ * @param[in] margin safety margin in samples
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 margin is invalid
+ * @note      margin is 1 - 15, each fifo full interrupt measures how many samples arrived before the fifo
+ *            was read and sets the fifo almost full value to the decaying peak of that plus the margin,
+ *            so the fifo is read as late as the latency allows, an overrun restores 0xF, the margin
+ *            keeps the fifo almost full value over 0 since a full fifo can't be told from an empty one
+ */
+uint8_t max30105_set_watermark_control(max30105_handle_t *handle, max30105_bool_t enable, uint8_t margin);
+
+/**
+ * @brief      get the adaptive fifo almost full watermark status
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @param[out] *margin pointer to a margin buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t max30105_get_watermark_control(max30105_handle_t *handle, max30105_bool_t *enable, uint8_t *margin);
+
+/**
+ * @brief      get the loss statistics
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *loss pointer to a loss statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       counts every fifo overrun seen by a read since init or the last clear
+ */
+uint8_t max30105_get_loss_statistics(max30105_handle_t *handle, max30105_loss_t *loss);
+
+/**
+ * @brief     clear the loss statistics
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t max30105_clear_loss_statistics(max30105_handle_t *handle);
+
+#if (MAX30105_STATS != 0)
+/**
+ * @brief      get the statistics
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *stats pointer to a statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       counts since the handle was linked or the last clear
+ */
+uint8_t max30105_get_stats(max30105_handle_t *handle, max30105_stats_t *stats);
+
+/**
+ * @brief     clear the statistics
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t max30105_clear_stats(max30105_handle_t *handle);
+#endif
+
+/**
+ * @brief     set the time of the interrupt edge
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] ns edge time in ns from a monotonic clock
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it before max30105_irq_handler with the kernel timestamp of the INT falling edge,
+ *            the irq handler anchors it to the fifo level of the edge, the read that pops that
+ *            sample matches it and max30105_read_samples timestamps every sample from the
+ *            estimated sensor clock
+ */
+uint8_t max30105_set_edge_timestamp(max30105_handle_t *handle, uint64_t ns);
+
+/**
+ * @brief      get the estimated clock drift
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *ppm pointer to a drift buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 no clock estimation yet
+ * @note       positive when the sensor samples slower than configured
+ */
+uint8_t max30105_get_clock_drift(max30105_handle_t *handle, float *ppm);
+
+/**
+ * @brief     set the polling safety margin
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] margin empty fifo slots kept at the deadline
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 margin is invalid
+ * @note      margin is 1 - 31, a full fifo can't be told from an empty one without an overflow,
+ *            the rest absorbs the wake up jitter of the polling thread, the default is 2
+ */
+uint8_t max30105_set_poll_margin(max30105_handle_t *handle, uint8_t margin);
+
+/**
+ * @brief      get the polling safety margin
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *margin pointer to a margin buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t max30105_get_poll_margin(max30105_handle_t *handle, uint8_t *margin);
+
+/**
+ * @brief         poll the fifo and get the next deadline
+ * @param[in]     *handle pointer to a max30105 handle structure
+ * @param[in]     now current time in ns from a monotonic clock
+ * @param[out]    *sample pointer to a sample buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[out]    *deadline pointer to a deadline buffer in ns
+ * @return        status code
+ *                - 0 success
+ *                - 1 poll failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 fifo overrun
+ *                - 5 mode is invalid
+ * @note          for boards without the INT line, sleep until the deadline with an absolute timer
+ *                and call it again, the deadline is when the largest batch the margin allows is
+ *                in the fifo, the read time drives the sensor clock estimation and the fifo level
+ *                seen at each wake up corrects the batch for the wake up latency
+ */
+uint8_t max30105_poll(max30105_handle_t *handle, uint64_t now, max30105_sample_t *sample, uint8_t *len, uint64_t *deadline);
+
+/**
+ * @brief     enable or disable draining the fifo in the irq handler
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] enable bool value
+ * @param[in] *raw_red pointer to a 32 length red raw data buffer
+ * @param[in] *raw_ir pointer to a 32 length ir raw data buffer
+ * @param[in] *raw_green pointer to a 32 length green raw data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 buffer is NULL
+ * @note      when enabled, a fifo full irq reads the fifo into the buffers before the callback runs
+ */
+uint8_t max30105_set_irq_fifo_drain(max30105_handle_t *handle, max30105_bool_t enable, uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green);
+
+/**
+ * @brief      get the irq fifo drain status
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t max30105_get_irq_fifo_drain(max30105_handle_t *handle, max30105_bool_t *enable);
+
+/**
+ * @brief      get the length drained by the last fifo full irq
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *len pointer to a length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       call it from the fifo full callback
+ */
+uint8_t max30105_get_irq_fifo_length(max30105_handle_t *handle, uint8_t *len);
+
 /**
  * @brief      read the temperature
  * @param[in]  *handle pointer to a max30105 handle structure
@@ -501,6 +1048,19 @@ uint8_t max30105_set_fifo_read_pointer(max30105_handle_t *handle, uint8_t pointe
  */
 uint8_t max30105_get_fifo_read_pointer(max30105_handle_t *handle, uint8_t *pointer);
 
+/**
+ * @brief      get the number of samples pending in the fifo
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *level pointer to a level buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get fifo level failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       level is 0 - 32, the overflow counter tells a full fifo from an empty one
+ */
+uint8_t max30105_get_fifo_level(max30105_handle_t *handle, uint8_t *level);
+
 /**
  * @brief     set the fifo data
  * @param[in] *handle pointer to a max30105 handle structure
@@ -640,7 +1200,7 @@ uint8_t max30105_get_shutdown(max30105_handle_t *handle, max30105_bool_t *enable
  *            - 1 reset failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      the shadow and the state derived from the chip are cleared
  */
 uint8_t max30105_reset(max30105_handle_t *handle);
 
@@ -972,6 +1532,60 @@ uint8_t max30105_proximity_threshold_convert_to_data(max30105_handle_t *handle,
  */
 uint8_t max30105_get_id(max30105_handle_t *handle, uint8_t *revision_id, uint8_t *part_id);
 
+/**
+ * @brief     resync the register shadow from the chip
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 resync failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it after a reset or a power ready event, the decoders, the clock estimation
+ *            and the pending interrupt edge and overrun gap are cleared like in max30105_shadow_invalidate
+ */
+uint8_t max30105_shadow_resync(max30105_handle_t *handle);
+
+/**
+ * @brief     invalidate the register shadow
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the next access of each register goes to the bus, the decoders, the clock
+ *            estimation and the pending interrupt edge and overrun gap are cleared too
+ */
+uint8_t max30105_shadow_invalidate(max30105_handle_t *handle);
+
+/**
+ * @brief     apply a whole chip config
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *config pointer to a config structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 apply config failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 fifo almost full value can't be over 0xF
+ * @note      the register image is built in memory and written in five bursts,
+ *            0x02 - 0x03, 0x0C - 0x0E, 0x10 - 0x12, 0x30 and 0x08 - 0x0A, mode config goes last,
+ *            the reserved register 0x0F is never written
+ */
+uint8_t max30105_apply_config(max30105_handle_t *handle, const max30105_config_t *config);
+
+/**
+ * @brief      read back the whole chip config
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[out] *config pointer to a config structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 read config failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the registers are read in four bursts and the shadow is refreshed
+ */
+uint8_t max30105_read_config(max30105_handle_t *handle, max30105_config_t *config);
+
 /**
  * @}
  */
@@ -0,0 +1,569 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_bus.c
+ * @brief     driver max30105 bus source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_bus.h"
+
+/**
+ * @brief     select the mux channel of a device
+ * @param[in] *device pointer to a max30105 bus device structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 select failed
+ * @note      the mux control register is written only when the channel changes,
+ *            a failed write forgets the selection so the next access writes it again
+ */
+static uint8_t a_max30105_bus_select(max30105_bus_device_t *device)
+{
+    uint8_t mask;
+    max30105_bus_t *bus = device->bus;
+    
+    if (bus->channel == device->channel)                                   /* check selected channel */
+    {
+        return 0;                                                          /* success return 0 */
+    }
+    mask = (uint8_t)(1 << device->channel);                                /* enable only this channel */
+    if (bus->iic_write_ctx(bus->user, bus->mux_addr, mask, &mask, 0) != 0) /* write the control register */
+    {
+        bus->channel = MAX30105_BUS_CHANNEL_NONE;                          /* selection unknown */
+        
+        return 1;                                                          /* return error */
+    }
+    bus->channel = device->channel;                                        /* save channel */
+    bus->switch_count++;                                                   /* count the switch */
+    
+    return 0;                                                              /* success return 0 */
+}
+
+/**
+ * @brief     device iic init
+ * @param[in] *user pointer to a max30105 bus device structure
+ * @return    status code
+ *            - 0 success
+ * @note      the bus is opened by its owner
+ */
+static uint8_t a_max30105_bus_iic_init(void *user)
+{
+    (void)user;                                             /* unused */
+    
+    return 0;                                               /* success return 0 */
+}
+
+/**
+ * @brief     device iic deinit
+ * @param[in] *user pointer to a max30105 bus device structure
+ * @return    status code
+ *            - 0 success
+ * @note      the bus is closed by its owner
+ */
+static uint8_t a_max30105_bus_iic_deinit(void *user)
+{
+    (void)user;                                             /* unused */
+    
+    return 0;                                               /* success return 0 */
+}
+
+/**
+ * @brief      device iic read
+ * @param[in]  *user pointer to a max30105 bus device structure
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+static uint8_t a_max30105_bus_iic_read(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    max30105_bus_device_t *device = (max30105_bus_device_t *)user;
+    
+    if (a_max30105_bus_select(device) != 0)                                   /* select the channel */
+    {
+        return 1;                                                             /* return error */
+    }
+    
+    return device->bus->iic_read_ctx(device->bus->user, addr, reg, buf, len); /* read */
+}
+
+/**
+ * @brief     device iic write
+ * @param[in] *user pointer to a max30105 bus device structure
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_max30105_bus_iic_write(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    max30105_bus_device_t *device = (max30105_bus_device_t *)user;
+    
+    if (a_max30105_bus_select(device) != 0)                                    /* select the channel */
+    {
+        return 1;                                                              /* return error */
+    }
+    
+    return device->bus->iic_write_ctx(device->bus->user, addr, reg, buf, len); /* write */
+}
+
+/**
+ * @brief         device iic batch transfer
+ * @param[in]     *user pointer to a max30105 bus device structure
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          none
+ */
+static uint8_t a_max30105_bus_iic_transfer(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    max30105_bus_device_t *device = (max30105_bus_device_t *)user;
+    
+    if (a_max30105_bus_select(device) != 0)                                       /* select the channel */
+    {
+        return 1;                                                                 /* return error */
+    }
+    
+    return device->bus->iic_transfer_ctx(device->bus->user, addr, transfer, num); /* transfer */
+}
+
+/**
+ * @brief     device delay ms
+ * @param[in] *user pointer to a max30105 bus device structure
+ * @param[in] ms time
+ * @note      forwards the user context the handle had
+ */
+static void a_max30105_bus_delay_ms(void *user, uint32_t ms)
+{
+    max30105_bus_device_t *device = (max30105_bus_device_t *)user;
+    
+    device->delay_ms_ctx(device->user, ms);                 /* delay */
+}
+
+/**
+ * @brief     device receive callback
+ * @param[in] *user pointer to a max30105 bus device structure
+ * @param[in] type irq type
+ * @note      forwards the user context the handle had
+ */
+static void a_max30105_bus_receive_callback(void *user, uint8_t type)
+{
+    max30105_bus_device_t *device = (max30105_bus_device_t *)user;
+    
+    device->receive_callback_ctx(device->user, type);       /* run the callback */
+}
+
+/**
+ * @brief     initialize the bus
+ * @param[in] *bus pointer to a max30105 bus structure
+ * @param[in] mux_addr mux iic address
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ *            - 2 bus is NULL
+ *            - 3 linked functions is NULL
+ * @note      all mux channels are disabled, the iic bus itself must already be open
+ */
+uint8_t max30105_bus_init(max30105_bus_t *bus, uint8_t mux_addr)
+{
+    uint8_t mask;
+    
+    if (bus == NULL)                                                                 /* check bus */
+    {
+        return 2;                                                                    /* return error */
+    }
+    if (bus->debug_print == NULL)                                                    /* check debug_print */
+    {
+        return 3;                                                                    /* return error */
+    }
+    if (bus->iic_read_ctx == NULL)                                                   /* check iic_read_ctx */
+    {
+        bus->debug_print("max30105: iic_read_ctx is null.\n");                       /* iic_read_ctx is null */
+        
+        return 3;                                                                    /* return error */
+    }
+    if (bus->iic_write_ctx == NULL)                                                  /* check iic_write_ctx */
+    {
+        bus->debug_print("max30105: iic_write_ctx is null.\n");                      /* iic_write_ctx is null */
+        
+        return 3;                                                                    /* return error */
+    }
+    if (bus->receive_ctx == NULL)                                                    /* check receive_ctx */
+    {
+        bus->debug_print("max30105: receive_ctx is null.\n");                        /* receive_ctx is null */
+        
+        return 3;                                                                    /* return error */
+    }
+    
+    mask = 0;                                                                        /* disable all channels */
+    if (bus->iic_write_ctx(bus->user, mux_addr, mask, &mask, 0) != 0)                /* write the control register */
+    {
+        bus->debug_print("max30105: mux write failed.\n");                           /* mux write failed */
+        
+        return 1;                                                                    /* return error */
+    }
+    memset(bus->device, 0, sizeof(max30105_bus_device_t) * MAX30105_BUS_MAX_DEVICE); /* clear devices */
+    bus->mux_addr = mux_addr;                                                        /* save mux address */
+    bus->channel = MAX30105_BUS_CHANNEL_NONE;                                        /* no channel selected */
+    bus->device_num = 0;                                                             /* no device */
+    bus->drain_time = 0;                                                             /* no drain yet */
+    bus->switch_count = 0;                                                           /* clear switch counter */
+    bus->inited = 1;                                                                 /* flag finish initialization */
+    
+    return 0;                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     close the bus
+ * @param[in] *bus pointer to a max30105 bus structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ *            - 2 bus is NULL
+ *            - 3 bus is not initialized
+ * @note      all mux channels are disabled, deinit the device handles first
+ */
+uint8_t max30105_bus_deinit(max30105_bus_t *bus)
+{
+    uint8_t mask;
+    
+    if (bus == NULL)                                                       /* check bus */
+    {
+        return 2;                                                          /* return error */
+    }
+    if (bus->inited != 1)                                                  /* check bus initialization */
+    {
+        return 3;                                                          /* return error */
+    }
+    
+    mask = 0;                                                              /* disable all channels */
+    if (bus->iic_write_ctx(bus->user, bus->mux_addr, mask, &mask, 0) != 0) /* write the control register */
+    {
+        bus->debug_print("max30105: mux write failed.\n");                 /* mux write failed */
+        
+        return 1;                                                          /* return error */
+    }
+    bus->channel = MAX30105_BUS_CHANNEL_NONE;                              /* no channel selected */
+    bus->inited = 0;                                                       /* flag close */
+    
+    return 0;                                                              /* success return 0 */
+}
+
+/**
+ * @brief      add a device behind a mux channel
+ * @param[in]  *bus pointer to a max30105 bus structure
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[in]  channel mux channel
+ * @param[out] *index pointer to a device index buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 add failed
+ *             - 2 bus is NULL
+ *             - 3 bus is not initialized
+ *             - 4 channel is invalid or used
+ *             - 5 bus is full
+ * @note       call it after linking the handle and before max30105_init, the handle iic functions
+ *             are replaced by ones that select the channel first, delay_ms_ctx and receive_callback_ctx
+ *             still get the user context the handle had
+ */
+uint8_t max30105_bus_add(max30105_bus_t *bus, max30105_handle_t *handle, uint8_t channel, uint8_t *index)
+{
+    uint8_t i;
+    max30105_bus_device_t *device;
+    
+    if (bus == NULL)                                                                                 /* check bus */
+    {
+        return 2;                                                                                    /* return error */
+    }
+    if (bus->inited != 1)                                                                            /* check bus initialization */
+    {
+        return 3;                                                                                    /* return error */
+    }
+    if ((handle == NULL) || (index == NULL))                                                         /* check handle and index */
+    {
+        bus->debug_print("max30105: handle or index is null.\n");                                    /* handle or index is null */
+        
+        return 1;                                                                                    /* return error */
+    }
+    if (channel > 7)                                                                                 /* check channel */
+    {
+        bus->debug_print("max30105: channel > 7.\n");                                                /* channel > 7 */
+        
+        return 4;                                                                                    /* return error */
+    }
+    for (i = 0; i < bus->device_num; i++)                                                            /* check all devices */
+    {
+        if (bus->device[i].channel == channel)                                                       /* check channel */
+        {
+            bus->debug_print("max30105: channel is used.\n");                                        /* channel is used */
+            
+            return 4;                                                                                /* return error */
+        }
+    }
+    if (bus->device_num >= MAX30105_BUS_MAX_DEVICE)                                                  /* check device number */
+    {
+        bus->debug_print("max30105: bus is full.\n");                                                /* bus is full */
+        
+        return 5;                                                                                    /* return error */
+    }
+    
+    device = &bus->device[bus->device_num];                                                          /* get the free device */
+    device->bus = bus;                                                                               /* set bus */
+    device->handle = handle;                                                                         /* set handle */
+    device->user = handle->user;                                                                     /* keep the user context */
+    device->delay_ms_ctx = handle->delay_ms_ctx;                                                     /* keep delay_ms_ctx */
+    device->receive_callback_ctx = handle->receive_callback_ctx;                                     /* keep receive_callback_ctx */
+    device->deadline = 0;                                                                            /* due at once */
+    device->channel = channel;                                                                       /* set channel */
+    device->index = bus->device_num;                                                                 /* set index */
+    handle->user = device;                                                                           /* the device is the new user context */
+    handle->iic_init_ctx = a_max30105_bus_iic_init;                                                  /* link iic_init_ctx */
+    handle->iic_deinit_ctx = a_max30105_bus_iic_deinit;                                              /* link iic_deinit_ctx */
+    handle->iic_read_ctx = a_max30105_bus_iic_read;                                                  /* link iic_read_ctx */
+    handle->iic_write_ctx = a_max30105_bus_iic_write;                                                /* link iic_write_ctx */
+    handle->iic_transfer = NULL;                                                                     /* never bypass the mux */
+    handle->iic_transfer_ctx = (bus->iic_transfer_ctx != NULL) ? a_max30105_bus_iic_transfer : NULL; /* link iic_transfer_ctx */
+    if (handle->delay_ms_ctx != NULL)                                                                /* check delay_ms_ctx */
+    {
+        handle->delay_ms_ctx = a_max30105_bus_delay_ms;                                              /* forward the user context */
+    }
+    if (handle->receive_callback_ctx != NULL)                                                        /* check receive_callback_ctx */
+    {
+        handle->receive_callback_ctx = a_max30105_bus_receive_callback;                              /* forward the user context */
+    }
+    *index = bus->device_num;                                                                        /* save index */
+    bus->device_num++;                                                                               /* add the device */
+    
+    return 0;                                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     mark a device as ready to drain
+ * @param[in] *bus pointer to a max30105 bus structure
+ * @param[in] index device index
+ * @param[in] now time of the INT edge in ns
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus is NULL
+ *            - 3 bus is not initialized
+ *            - 4 index is invalid
+ * @note      for boards that wire the INT lines, the device is served at the next service call
+ */
+uint8_t max30105_bus_mark(max30105_bus_t *bus, uint8_t index, uint64_t now)
+{
+    if (bus == NULL)                                        /* check bus */
+    {
+        return 2;                                           /* return error */
+    }
+    if (bus->inited != 1)                                   /* check bus initialization */
+    {
+        return 3;                                           /* return error */
+    }
+    if (index >= bus->device_num)                           /* check index */
+    {
+        bus->debug_print("max30105: index is invalid.\n");  /* index is invalid */
+        
+        return 4;                                           /* return error */
+    }
+    
+    if ((int64_t)(now - bus->device[index].deadline) < 0)   /* check deadline */
+    {
+        bus->device[index].deadline = now;                  /* the fifo reached the watermark */
+    }
+    
+    return 0;                                               /* success return 0 */
+}
+
+/**
+ * @brief      drain every device whose fifo is due
+ * @param[in]  *bus pointer to a max30105 bus structure
+ * @param[in]  now current time in ns from a monotonic clock
+ * @param[out] *deadline pointer to a deadline buffer in ns
+ * @return     status code
+ *             - 0 success
+ *             - 1 service failed
+ *             - 2 bus is NULL
+ *             - 3 bus is not initialized
+ * @note       the due devices are drained with max30105_poll in order of urgency, the earliest
+ *             deadline first since its fifo is the closest to the watermark, ties go to the
+ *             selected channel to save a switch, each device is drained at most once per call,
+ *             a failed device doesn't stop the others, sleep until the deadline and call it again,
+ *             with timestamp_ctx linked a device is due early by the time the other devices
+ *             may hold the bus, so a device waiting its turn doesn't overflow
+ */
+uint8_t max30105_bus_service(max30105_bus_t *bus, uint64_t now, uint64_t *deadline)
+{
+    uint8_t res;
+    uint8_t r;
+    uint8_t len;
+    uint8_t i;
+    uint8_t next;
+    uint8_t done[MAX30105_BUS_MAX_DEVICE];
+    uint64_t slack;
+    uint64_t start;
+    uint64_t elapsed;
+    max30105_sample_t sample[32];
+    max30105_bus_device_t *device;
+    
+    if (bus == NULL)                                                                                     /* check bus */
+    {
+        return 2;                                                                                        /* return error */
+    }
+    if (bus->inited != 1)                                                                                /* check bus initialization */
+    {
+        return 3;                                                                                        /* return error */
+    }
+    if (deadline == NULL)                                                                                /* check deadline */
+    {
+        bus->debug_print("max30105: deadline is null.\n");                                               /* deadline is null */
+        
+        return 1;                                                                                        /* return error */
+    }
+    if (bus->device_num == 0)                                                                            /* check device number */
+    {
+        bus->debug_print("max30105: no device.\n");                                                      /* no device */
+        
+        return 1;                                                                                        /* return error */
+    }
+    
+    res = 0;                                                                                             /* init 0 */
+    memset(done, 0, sizeof(uint8_t) * MAX30105_BUS_MAX_DEVICE);                                          /* clear done flags */
+    while (1)                                                                                            /* loop */
+    {
+        slack = (uint64_t)(bus->device_num - 1) * bus->drain_time;                                       /* the other devices may hold the bus this long */
+        next = MAX30105_BUS_MAX_DEVICE;                                                                  /* no device */
+        for (i = 0; i < bus->device_num; i++)                                                            /* find the most urgent device */
+        {
+            device = &bus->device[i];                                                                    /* get device */
+            if ((done[i] != 0) || ((int64_t)(device->deadline - slack - now) > 0))                       /* check due */
+            {
+                continue;                                                                                /* next */
+            }
+            if ((next == MAX30105_BUS_MAX_DEVICE) ||
+                ((int64_t)(device->deadline - bus->device[next].deadline) < 0) ||
+                ((device->deadline == bus->device[next].deadline) && (device->channel == bus->channel))) /* check urgency */
+            {
+                next = i;                                                                                /* save device */
+            }
+        }
+        if (next == MAX30105_BUS_MAX_DEVICE)                                                             /* check device */
+        {
+            break;                                                                                       /* nothing is due */
+        }
+        
+        device = &bus->device[next];                                                                     /* get device */
+        done[next] = 1;                                                                                  /* drained once */
+        if (bus->timestamp_ctx != NULL)                                                                  /* check timestamp_ctx */
+        {
+            now = bus->timestamp_ctx(bus->user);                                                         /* the previous drains took bus time */
+        }
+        start = now;                                                                                     /* save start */
+        len = 32;                                                                                        /* whole fifo */
+        r = max30105_poll(device->handle, now, sample, &len, &device->deadline);                         /* poll the fifo */
+        if (bus->timestamp_ctx != NULL)                                                                  /* check timestamp_ctx */
+        {
+            now = bus->timestamp_ctx(bus->user);                                                         /* get the drain end */
+            elapsed = now - start;                                                                       /* drain time */
+            if (bus->drain_time == 0)                                                                    /* check history */
+            {
+                elapsed = (elapsed * 32) / (len + 1);                                                    /* assume full fifos until drains were timed */
+            }
+            if (elapsed > bus->drain_time)                                                               /* check peak */
+            {
+                bus->drain_time = elapsed;                                                               /* new peak */
+            }
+            else
+            {
+                bus->drain_time -= bus->drain_time / 64;                                                 /* decay slowly */
+            }
+        }
+        if ((r != 0) && (r != 4))                                                                        /* check result */
+        {
+            bus->debug_print("max30105: device %d poll failed.\n", next);                                /* poll failed */
+            res = 1;                                                                                     /* mark error */
+            
+            continue;                                                                                    /* next */
+        }
+        if (len != 0)                                                                                    /* check length */
+        {
+            bus->receive_ctx(bus->user, next, sample, len);                                              /* hand over the samples */
+        }
+    }
+    
+    *deadline = 0;                                                                                       /* init 0 */
+    for (i = 0; i < bus->device_num; i++)                                                                /* find the earliest deadline */
+    {
+        if ((i == 0) || ((int64_t)(bus->device[i].deadline - *deadline) < 0))                            /* check deadline */
+        {
+            *deadline = bus->device[i].deadline;                                                         /* save deadline */
+        }
+    }
+    *deadline -= (uint64_t)(bus->device_num - 1) * bus->drain_time;                                      /* wake up early enough for the slowest turn */
+    
+    return res;                                                                                          /* return the result */
+}
+
+/**
+ * @brief      get the mux channel switch counter
+ * @param[in]  *bus pointer to a max30105 bus structure
+ * @param[out] *count pointer to a counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 bus is NULL
+ *             - 3 bus is not initialized
+ * @note       none
+ */
+uint8_t max30105_bus_get_switch_count(max30105_bus_t *bus, uint32_t *count)
+{
+    if (bus == NULL)                                        /* check bus */
+    {
+        return 2;                                           /* return error */
+    }
+    if (bus->inited != 1)                                   /* check bus initialization */
+    {
+        return 3;                                           /* return error */
+    }
+    
+    *count = bus->switch_count;                             /* get counter */
+    
+    return 0;                                               /* success return 0 */
+}
@@ -0,0 +1,263 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_bus.h
+ * @brief     driver max30105 bus header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_MAX30105_BUS_H
+#define DRIVER_MAX30105_BUS_H
+
+#include "driver_max30105.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup max30105_bus_driver max30105 bus driver function
+ * @brief    max30105 bus driver modules
+ * @ingroup  max30105_driver
+ * @{
+ */
+
+/**
+ * @brief max30105 bus definition
+ */
+#define MAX30105_BUS_MAX_DEVICE        8           /**< max devices on one bus, one per mux channel */
+#define MAX30105_BUS_MUX_ADDRESS       0xE0        /**< tca9548a address with A2 A1 A0 low, 0x70 << 1 */
+#define MAX30105_BUS_CHANNEL_NONE      0xFF        /**< no mux channel selected or selection unknown */
+
+struct max30105_bus_s;
+
+/**
+ * @brief max30105 bus device structure definition
+ */
+typedef struct max30105_bus_device_s
+{
+    struct max30105_bus_s *bus;                                        /**< owning bus */
+    max30105_handle_t *handle;                                         /**< device handle */
+    void *user;                                                        /**< user context of the handle before it joined the bus */
+    void (*delay_ms_ctx)(void *user, uint32_t ms);                     /**< delay_ms_ctx of the handle before it joined the bus */
+    void (*receive_callback_ctx)(void *user, uint8_t type);            /**< receive_callback_ctx of the handle before it joined the bus */
+    uint64_t deadline;                                                 /**< time the fifo is expected to reach its batch in ns */
+    uint8_t channel;                                                   /**< mux channel */
+    uint8_t index;                                                     /**< device index on the bus */
+} max30105_bus_device_t;
+
+/**
+ * @brief max30105 bus structure definition
+ */
+typedef struct max30105_bus_s
+{
+    void *user;                                                                         /**< user context passed to the ctx functions */
+    uint8_t (*iic_read_ctx)(void *user, uint8_t addr, uint8_t reg,
+                            uint8_t *buf, uint16_t len);                                /**< point to an iic_read_ctx function address */
+    uint8_t (*iic_write_ctx)(void *user, uint8_t addr, uint8_t reg,
+                             uint8_t *buf, uint16_t len);                               /**< point to an iic_write_ctx function address */
+    uint8_t (*iic_transfer_ctx)(void *user, uint8_t addr,
+                                max30105_iic_transfer_t *transfer, uint8_t num);        /**< point to an optional iic_transfer_ctx function address */
+    uint64_t (*timestamp_ctx)(void *user);                                              /**< point to an optional timestamp_ctx function address */
+    void (*receive_ctx)(void *user, uint8_t index,
+                        max30105_sample_t *sample, uint8_t len);                        /**< point to a receive_ctx function address */
+    void (*debug_print)(const char *const fmt, ...);                                    /**< point to a debug_print function address */
+    max30105_bus_device_t device[MAX30105_BUS_MAX_DEVICE];                              /**< devices on the bus */
+    uint64_t drain_time;                                                                /**< decaying peak time of one drain in ns */
+    uint32_t switch_count;                                                              /**< mux channel switches */
+    uint8_t mux_addr;                                                                   /**< mux iic address */
+    uint8_t channel;                                                                    /**< selected mux channel */
+    uint8_t device_num;                                                                 /**< device number */
+    uint8_t inited;                                                                     /**< inited flag */
+} max30105_bus_t;
+
+/**
+ * @brief     initialize max30105_bus_t structure
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] STRUCTURE max30105_bus_t
+ * @note      none
+ */
+#define DRIVER_MAX30105_BUS_LINK_INIT(BUS, STRUCTURE)           memset(BUS, 0, sizeof(STRUCTURE))
+
+/**
+ * @brief     link the user context
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] USER user context pointer passed to every ctx function
+ * @note      none
+ */
+#define DRIVER_MAX30105_BUS_LINK_USER(BUS, USER)                (BUS)->user = USER
+
+/**
+ * @brief     link iic_read_ctx function
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] FUC pointer to an iic_read_ctx function address
+ * @note      none
+ */
+#define DRIVER_MAX30105_BUS_LINK_IIC_READ_CTX(BUS, FUC)         (BUS)->iic_read_ctx = FUC
+
+/**
+ * @brief     link iic_write_ctx function
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] FUC pointer to an iic_write_ctx function address
+ * @note      none
+ */
+#define DRIVER_MAX30105_BUS_LINK_IIC_WRITE_CTX(BUS, FUC)        (BUS)->iic_write_ctx = FUC
+
+/**
+ * @brief     link iic_transfer_ctx function
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] FUC pointer to an iic_transfer_ctx function address
+ * @note      optional
+ */
+#define DRIVER_MAX30105_BUS_LINK_IIC_TRANSFER_CTX(BUS, FUC)     (BUS)->iic_transfer_ctx = FUC
+
+/**
+ * @brief     link timestamp_ctx function
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] FUC pointer to a timestamp_ctx function address returning a monotonic time in ns
+ * @note      optional, without it every drain of one service call uses the same time
+ */
+#define DRIVER_MAX30105_BUS_LINK_TIMESTAMP_CTX(BUS, FUC)        (BUS)->timestamp_ctx = FUC
+
+/**
+ * @brief     link receive_ctx function
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] FUC pointer to a receive_ctx function address
+ * @note      none
+ */
+#define DRIVER_MAX30105_BUS_LINK_RECEIVE_CTX(BUS, FUC)          (BUS)->receive_ctx = FUC
+
+/**
+ * @brief     link debug_print function
+ * @param[in] BUS pointer to a max30105 bus structure
+ * @param[in] FUC pointer to a debug_print function address
+ * @note      none
+ */
+#define DRIVER_MAX30105_BUS_LINK_DEBUG_PRINT(BUS, FUC)          (BUS)->debug_print = FUC
+
+/**
+ * @brief     initialize the bus
+ * @param[in] *bus pointer to a max30105 bus structure
+ * @param[in] mux_addr mux iic address
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ *            - 2 bus is NULL
+ *            - 3 linked functions is NULL
+ * @note      all mux channels are disabled, the iic bus itself must already be open
+ */
+uint8_t max30105_bus_init(max30105_bus_t *bus, uint8_t mux_addr);
+
+/**
+ * @brief     close the bus
+ * @param[in] *bus pointer to a max30105 bus structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ *            - 2 bus is NULL
+ *            - 3 bus is not initialized
+ * @note      all mux channels are disabled, deinit the device handles first
+ */
+uint8_t max30105_bus_deinit(max30105_bus_t *bus);
+
+/**
+ * @brief      add a device behind a mux channel
+ * @param[in]  *bus pointer to a max30105 bus structure
+ * @param[in]  *handle pointer to a max30105 handle structure
+ * @param[in]  channel mux channel
+ * @param[out] *index pointer to a device index buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 add failed
+ *             - 2 bus is NULL
+ *             - 3 bus is not initialized
+ *             - 4 channel is invalid or used
+ *             - 5 bus is full
+ * @note       call it after linking the handle and before max30105_init, the handle iic functions
+ *             are replaced by ones that select the channel first, delay_ms_ctx and receive_callback_ctx
+ *             still get the user context the handle had
+ */
+uint8_t max30105_bus_add(max30105_bus_t *bus, max30105_handle_t *handle, uint8_t channel, uint8_t *index);
+
+/**
+ * @brief     mark a device as ready to drain
+ * @param[in] *bus pointer to a max30105 bus structure
+ * @param[in] index device index
+ * @param[in] now time of the INT edge in ns
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus is NULL
+ *            - 3 bus is not initialized
+ *            - 4 index is invalid
+ * @note      for boards that wire the INT lines, the device is served at the next service call
+ */
+uint8_t max30105_bus_mark(max30105_bus_t *bus, uint8_t index, uint64_t now);
+
+/**
+ * @brief      drain every device whose fifo is due
+ * @param[in]  *bus pointer to a max30105 bus structure
+ * @param[in]  now current time in ns from a monotonic clock
+ * @param[out] *deadline pointer to a deadline buffer in ns
+ * @return     status code
+ *             - 0 success
+ *             - 1 service failed
+ *             - 2 bus is NULL
+ *             - 3 bus is not initialized
+ * @note       the due devices are drained with max30105_poll in order of urgency, the earliest
+ *             deadline first since its fifo is the closest to the watermark, ties go to the
+ *             selected channel to save a switch, each device is drained at most once per call,
+ *             a failed device doesn't stop the others, sleep until the deadline and call it again,
+ *             with timestamp_ctx linked a device is due early by the time the other devices
+ *             may hold the bus, so a device waiting its turn doesn't overflow
+ */
+uint8_t max30105_bus_service(max30105_bus_t *bus, uint64_t now, uint64_t *deadline);
+
+/**
+ * @brief      get the mux channel switch counter
+ * @param[in]  *bus pointer to a max30105 bus structure
+ * @param[out] *count pointer to a counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 bus is NULL
+ *             - 3 bus is not initialized
+ * @note       none
+ */
+uint8_t max30105_bus_get_switch_count(max30105_bus_t *bus, uint32_t *count);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_bench.c
+ * @brief     driver max30105 benchmark source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_bench.h"
+#include "driver_max30105_sim.h"
+
+/**
+ * @brief bench bus definition
+ */
+#define MAX30105_BENCH_BUS_HZ           400000        /**< bus clock the bus time is reported for */
+#define MAX30105_BENCH_BYTE_NS          22500         /**< 9 clocks per byte at 400khz */
+#define MAX30105_BENCH_PERIOD_NS        312500        /**< conversion period at 3200hz */
+
+static max30105_handle_t gs_handle;        /**< max30105 handle */
+static max30105_sim_t gs_sim;              /**< max30105 simulator */
+static uint8_t gs_raw[32 * 9];             /**< raw fifo bytes */
+static uint32_t gs_red[32];                /**< red buffer */
+static uint32_t gs_ir[32];                 /**< ir buffer */
+static uint32_t gs_green[32];              /**< green buffer */
+
+/**
+ * @brief     silent debug print
+ * @param[in] fmt format data
+ * @note      driver messages would break the json document
+ */
+static void a_bench_print(const char *const fmt, ...)
+{
+    (void)fmt;
+}
+
+/**
+ * @brief      measure one mode, resolution and batch size
+ * @param[in]  mode chip mode
+ * @param[in]  resolution adc resolution
+ * @param[in]  batch samples per drain
+ * @param[in]  times iterations
+ * @param[in]  *now pointer to a monotonic clock function in ns
+ * @param[in]  last bool value, the last record of the document
+ * @return     status code
+ *             - 0 success
+ *             - 1 run failed
+ * @note       a full fifo of 32 samples reads as empty without an overflow,
+ *             so the largest batch is 31
+ */
+static uint8_t a_bench_run(max30105_mode_t mode, max30105_adc_resolution_t resolution, uint8_t batch,
+                           uint32_t times, uint64_t (*now)(void), uint8_t last)
+{
+    const char *name[8] = {"", "", "red", "red_ir", "", "", "", "green_red_ir"};
+    uint8_t res;
+    uint8_t len;
+    uint32_t i;
+    uint32_t loops;
+    uint32_t transactions;
+    uint64_t bytes;
+    uint64_t start;
+    uint64_t decode;
+    uint64_t drain;
+    double samples;
+    
+    res = max30105_set_mode(&gs_handle, mode);
+    res |= max30105_set_adc_resolution(&gs_handle, resolution);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    /* decode loop */
+    for (i = 0; i < sizeof(gs_raw); i++)
+    {
+        gs_raw[i] = (uint8_t)(i * 37 + 11);
+    }
+    loops = (times * 32) / batch;
+    loops = (loops == 0) ? 1 : loops;
+    start = now();
+    for (i = 0; i < loops; i++)
+    {
+        if (max30105_decode(mode, resolution, gs_raw, batch, gs_red, gs_ir, gs_green) != 0)
+        {
+            return 1;
+        }
+    }
+    decode = now() - start;
+    
+    /* drain a fifo holding the batch on an ideal bus */
+    len = 32;
+    res = max30105_read(&gs_handle, gs_red, gs_ir, gs_green, &len);
+    if ((res != 0) && (res != 4))
+    {
+        return 1;
+    }
+    transactions = gs_sim.read_count + gs_sim.write_count + gs_sim.transfer_count;
+    bytes = gs_sim.byte_count;
+    drain = 0;
+    for (i = 0; i < times; i++)
+    {
+        max30105_sim_advance(&gs_sim, (uint64_t)batch * MAX30105_BENCH_PERIOD_NS);
+        len = 32;
+        start = now();
+        res = max30105_read(&gs_handle, gs_red, gs_ir, gs_green, &len);
+        drain += now() - start;
+        if (((res != 0) && (res != 4)) || (len != batch))
+        {
+            return 1;
+        }
+    }
+    transactions = gs_sim.read_count + gs_sim.write_count + gs_sim.transfer_count - transactions;
+    bytes = gs_sim.byte_count - bytes;
+    
+    /* print the record */
+    samples = (double)times * batch;
+    max30105_interface_debug_print("    {\"mode\": \"%s\", \"resolution\": %d, \"batch\": %d, ", name[mode], resolution + 15, batch);
+    max30105_interface_debug_print("\"decode_ns_per_sample\": %0.2f, ", (double)decode / ((double)loops * batch));
+    max30105_interface_debug_print("\"transactions_per_sample\": %0.3f, \"bytes_per_sample\": %0.2f, ",
+                                   transactions / samples, bytes / samples);
+    max30105_interface_debug_print("\"drain_ns\": %0.1f, \"drain_bus_ns\": %0.0f}%s\n", (double)drain / times,
+                                   ((double)bytes * MAX30105_BENCH_BYTE_NS) / times, (last != 0) ? "" : ",");
+    
+    return 0;
+}
+
+/**
+ * @brief     read path benchmark
+ * @param[in] times iterations of each measurement
+ * @param[in] *now pointer to a monotonic clock function in ns
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      runs every mode, resolution and batch size against the simulator and
+ *            prints one json document with the decode cost, the bus traffic and the drain cost
+ */
+uint8_t max30105_bench(uint32_t times, uint64_t (*now)(void))
+{
+    const max30105_mode_t mode[3] = {MAX30105_MODE_RED, MAX30105_MODE_RED_IR, MAX30105_MODE_GREEN_RED_IR};
+    const uint8_t batch[4] = {1, 8, 16, 31};
+    uint8_t res;
+    uint8_t m;
+    uint8_t r;
+    uint8_t b;
+    max30105_info_t info;
+    
+    if ((times == 0) || (now == NULL))
+    {
+        max30105_interface_debug_print("max30105: invalid bench param.\n");
+        
+        return 1;
+    }
+    
+    /* the simulator behind an ideal bus, the bus time is computed from the bytes */
+    max30105_sim_init(&gs_sim);
+    max30105_sim_link(&gs_handle, &gs_sim);
+    DRIVER_MAX30105_LINK_DEBUG_PRINT(&gs_handle, a_bench_print);
+    res = max30105_init(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* green, red and ir slots for the multi led mode */
+    res = max30105_set_slot(&gs_handle, MAX30105_SLOT_1, MAX30105_LED_RED_LED1_PA);
+    res |= max30105_set_slot(&gs_handle, MAX30105_SLOT_2, MAX30105_LED_IR_LED2_PA);
+    res |= max30105_set_slot(&gs_handle, MAX30105_SLOT_3, MAX30105_LED_GREEN_LED3_PA);
+    res |= max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_PARTICLE_SENSING_SAMPLE_RATE_3200_HZ);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: bench config failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* print the document */
+    (void)max30105_info(&info);
+    max30105_interface_debug_print("{\n");
+    max30105_interface_debug_print("  \"driver\": \"max30105\",\n");
+    max30105_interface_debug_print("  \"driver_version\": %d,\n", (int)info.driver_version);
+    max30105_interface_debug_print("  \"times\": %d,\n", (int)times);
+    max30105_interface_debug_print("  \"bus_hz\": %d,\n", MAX30105_BENCH_BUS_HZ);
+    max30105_interface_debug_print("  \"results\": [\n");
+    for (m = 0; m < 3; m++)
+    {
+        for (r = 0; r < 4; r++)
+        {
+            for (b = 0; b < 4; b++)
+            {
+                res = a_bench_run(mode[m], (max30105_adc_resolution_t)r, batch[b], times, now,
+                                  ((m == 2) && (r == 3) && (b == 3)) ? 1 : 0);
+                if (res != 0)
+                {
+                    max30105_interface_debug_print("max30105: bench failed.\n");
+                    (void)max30105_deinit(&gs_handle);
+                    
+                    return 1;
+                }
+            }
+        }
+    }
+    max30105_interface_debug_print("  ]\n");
+    max30105_interface_debug_print("}\n");
+    (void)max30105_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,1977 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_read_test.c
+ * @brief     driver max30105 read test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_read_test.h"
+#include "driver_max30105_bus.h"
+
+/**
+ * @brief read test simulated bus structure definition
+ */
+typedef struct read_test_bus_s
+{
+    uint8_t reg[256];                      /**< simulated register map */
+    uint8_t fifo[32][9];                   /**< simulated fifo */
+    uint8_t fifo_byte;                     /**< byte index in the current fifo sample */
+    uint32_t read_count;                   /**< bus read transaction counter */
+    uint32_t write_count;                  /**< bus write transaction counter */
+    uint32_t transfer_count;               /**< bus batch transfer counter */
+    uint8_t irq_type;                      /**< received irq type mask */
+    uint8_t irq_len;                       /**< fifo length seen by the fifo full callback */
+    max30105_handle_t *handle;             /**< handle linked to this bus */
+} read_test_bus_t;
+
+static max30105_handle_t gs_handle;        /**< max30105 handle */
+static max30105_handle_t gs_handle2;       /**< second max30105 handle */
+static read_test_bus_t gs_bus;             /**< simulated bus */
+static read_test_bus_t gs_bus2;            /**< second simulated bus */
+
+/**
+ * @brief     get the bytes of one simulated fifo sample
+ * @param[in] *bus pointer to a simulated bus
+ * @return    bytes per sample
+ * @note      none
+ */
+static uint8_t a_read_test_sample_bytes(read_test_bus_t *bus)
+{
+    uint8_t mode;
+    
+    mode = bus->reg[0x09] & 0x7;
+    if (mode == MAX30105_MODE_RED)
+    {
+        return 3;
+    }
+    else if (mode == MAX30105_MODE_RED_IR)
+    {
+        return 6;
+    }
+    else
+    {
+        return 9;
+    }
+}
+
+/**
+ * @brief     reset a simulated bus to the power on state
+ * @param[in] *bus pointer to a simulated bus
+ * @param[in] *handle pointer to the linked max30105 handle
+ * @note      none
+ */
+static void a_read_test_bus_reset(read_test_bus_t *bus, max30105_handle_t *handle)
+{
+    memset(bus, 0, sizeof(read_test_bus_t));
+    bus->reg[0xFF] = 0x15;
+    bus->handle = handle;
+}
+
+/**
+ * @brief     simulated iic bus init
+ * @param[in] *user pointer to a simulated bus
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+static uint8_t a_read_test_iic_init(void *user)
+{
+    (void)user;
+    
+    return 0;
+}
+
+/**
+ * @brief     simulated iic bus deinit
+ * @param[in] *user pointer to a simulated bus
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+static uint8_t a_read_test_iic_deinit(void *user)
+{
+    (void)user;
+    
+    return 0;
+}
+
+/**
+ * @brief      simulated iic bus read
+ * @param[in]  *user pointer to a simulated bus
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ * @note       the fifo data register doesn't auto increment and
+ *             the interrupt status registers are cleared on read
+ */
+static uint8_t a_read_test_iic_read(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    read_test_bus_t *bus = (read_test_bus_t *)user;
+    
+    (void)addr;
+    bus->read_count++;
+    for (i = 0; i < len; i++)
+    {
+        if (reg == 0x07)
+        {
+            buf[i] = bus->fifo[bus->reg[0x06]][bus->fifo_byte];
+            bus->fifo_byte++;
+            if (bus->fifo_byte >= a_read_test_sample_bytes(bus))
+            {
+                bus->fifo_byte = 0;
+                bus->reg[0x06] = (bus->reg[0x06] + 1) & 0x1F;
+                bus->reg[0x05] = 0;
+            }
+        }
+        else
+        {
+            buf[i] = bus->reg[(uint8_t)(reg + i)];
+            if (((uint8_t)(reg + i)) <= 0x01)
+            {
+                bus->reg[(uint8_t)(reg + i)] = 0;
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     simulated iic bus write
+ * @param[in] *user pointer to a simulated bus
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ * @note      the reset bit restores the power on state at once
+ */
+static uint8_t a_read_test_iic_write(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    read_test_bus_t *bus = (read_test_bus_t *)user;
+    
+    (void)addr;
+    bus->write_count++;
+    for (i = 0; i < len; i++)
+    {
+        if ((((uint8_t)(reg + i)) == 0x09) && ((buf[i] & (1 << 6)) != 0))
+        {
+            memset(bus->reg, 0, sizeof(uint8_t) * 0xFE);
+            bus->fifo_byte = 0;
+        }
+        else
+        {
+            bus->reg[(uint8_t)(reg + i)] = buf[i];
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief         simulated iic bus batch transfer
+ * @param[in]     *user pointer to a simulated bus
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ * @note          counts as one bus transaction
+ */
+static uint8_t a_read_test_iic_transfer(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    uint8_t i;
+    uint32_t read_count;
+    uint32_t write_count;
+    read_test_bus_t *bus = (read_test_bus_t *)user;
+    
+    read_count = bus->read_count;
+    write_count = bus->write_count;
+    for (i = 0; i < num; i++)
+    {
+        if (transfer[i].read != 0)
+        {
+            (void)a_read_test_iic_read(user, addr, transfer[i].reg, transfer[i].buf, transfer[i].len);
+        }
+        else
+        {
+            (void)a_read_test_iic_write(user, addr, transfer[i].reg, transfer[i].buf, transfer[i].len);
+        }
+    }
+    bus->read_count = read_count;
+    bus->write_count = write_count;
+    bus->transfer_count++;
+    
+    return 0;
+}
+
+/**
+ * @brief     simulated delay ms
+ * @param[in] *user pointer to a simulated bus
+ * @param[in] ms time
+ * @note      none
+ */
+static void a_read_test_delay_ms(void *user, uint32_t ms)
+{
+    (void)user;
+    (void)ms;
+}
+
+/**
+ * @brief     simulated receive callback
+ * @param[in] *user pointer to a simulated bus
+ * @param[in] type irq type
+ * @note      none
+ */
+static void a_read_test_receive_callback(void *user, uint8_t type)
+{
+    read_test_bus_t *bus = (read_test_bus_t *)user;
+    
+    bus->irq_type |= (uint8_t)(1 << type);
+    if (type == MAX30105_INTERRUPT_STATUS_FIFO_FULL)
+    {
+        (void)max30105_get_irq_fifo_length(bus->handle, (uint8_t *)&bus->irq_len);
+    }
+}
+
+/**
+ * @brief     link a handle to a simulated bus
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *bus pointer to a simulated bus
+ * @note      none
+ */
+static void a_read_test_link(max30105_handle_t *handle, read_test_bus_t *bus)
+{
+    DRIVER_MAX30105_LINK_INIT(handle, max30105_handle_t);
+    DRIVER_MAX30105_LINK_USER(handle, bus);
+    DRIVER_MAX30105_LINK_IIC_INIT_CTX(handle, a_read_test_iic_init);
+    DRIVER_MAX30105_LINK_IIC_DEINIT_CTX(handle, a_read_test_iic_deinit);
+    DRIVER_MAX30105_LINK_IIC_READ_CTX(handle, a_read_test_iic_read);
+    DRIVER_MAX30105_LINK_IIC_WRITE_CTX(handle, a_read_test_iic_write);
+    DRIVER_MAX30105_LINK_DELAY_MS_CTX(handle, a_read_test_delay_ms);
+    DRIVER_MAX30105_LINK_DEBUG_PRINT(handle, max30105_interface_debug_print);
+    DRIVER_MAX30105_LINK_RECEIVE_CALLBACK_CTX(handle, a_read_test_receive_callback);
+    a_read_test_bus_reset(bus, handle);
+}
+
+/**
+ * @brief     push one sample into the simulated fifo
+ * @param[in] *bus pointer to a simulated bus
+ * @param[in] red red raw data
+ * @param[in] ir ir raw data
+ * @param[in] green green raw data
+ * @param[in] bit left shift of the adc resolution
+ * @note      none
+ */
+static void a_read_test_push(read_test_bus_t *bus, uint32_t red, uint32_t ir, uint32_t green, uint8_t bit)
+{
+    uint8_t i;
+    uint32_t value[3];
+    
+    value[0] = red << bit;
+    value[1] = ir << bit;
+    value[2] = green << bit;
+    for (i = 0; i < 3; i++)
+    {
+        bus->fifo[bus->reg[0x04]][i * 3 + 0] = (value[i] >> 16) & 0xFF;
+        bus->fifo[bus->reg[0x04]][i * 3 + 1] = (value[i] >> 8) & 0xFF;
+        bus->fifo[bus->reg[0x04]][i * 3 + 2] = (value[i] >> 0) & 0xFF;
+    }
+    bus->reg[0x04] = (bus->reg[0x04] + 1) & 0x1F;
+}
+
+/**
+ * @brief     reference unpack of one fifo word
+ * @param[in] *buf pointer to a raw data buffer
+ * @param[in] offset byte offset of the word
+ * @param[in] bit right shift of the adc resolution
+ * @return    sample value
+ * @note      none
+ */
+static uint32_t a_read_test_word(const uint8_t *buf, uint32_t offset, uint8_t bit)
+{
+    uint32_t value;
+    
+    value = ((uint32_t)buf[offset + 0] << 16) | ((uint32_t)buf[offset + 1] << 8) | ((uint32_t)buf[offset + 2] << 0);
+    
+    return value >> bit;
+}
+
+/**
+ * @brief read test simulated mux structure definition
+ */
+typedef struct read_test_mux_s
+{
+    read_test_bus_t *channel[8];           /**< simulated device behind each channel */
+    uint64_t now;                          /**< virtual time in ns */
+    uint64_t start;                        /**< virtual time the devices start sampling */
+    uint64_t produced[8];                  /**< samples produced by each device */
+    uint64_t received[8];                  /**< samples received from each device */
+    uint32_t period[8];                    /**< sample period of each device in ns */
+    uint8_t mask;                          /**< control register */
+    uint8_t log[8];                        /**< first selected channels */
+    uint8_t log_len;                       /**< selected channel log length */
+    uint32_t write_count;                  /**< control register write counter */
+    uint32_t device_count;                 /**< device transaction counter */
+    uint32_t collision_count;              /**< device accesses without exactly one channel */
+    uint32_t overflow_count;               /**< samples pushed into a full fifo */
+    uint32_t error_count;                  /**< samples received out of order */
+} read_test_mux_t;
+
+static read_test_mux_t gs_mux;             /**< simulated mux */
+static max30105_bus_t gs_mux_bus;          /**< bus behind the simulated mux */
+static max30105_handle_t gs_mux_handle[8]; /**< handles behind the simulated mux */
+static read_test_bus_t gs_mux_device[8];   /**< simulated devices behind the mux */
+
+/**
+ * @brief     advance the simulated mux time
+ * @param[in] *mux pointer to a simulated mux
+ * @param[in] ns elapsed time in ns
+ * @note      every device pushes the samples it took meanwhile
+ */
+static void a_read_test_mux_advance(read_test_mux_t *mux, uint64_t ns)
+{
+    uint8_t c;
+    
+    mux->now += ns;
+    for (c = 0; c < 8; c++)
+    {
+        if (mux->period[c] == 0)
+        {
+            continue;
+        }
+        while (mux->start + (mux->produced[c] + 1) * mux->period[c] + c * 137000ULL <= mux->now)
+        {
+            if (((mux->channel[c]->reg[0x04] - mux->channel[c]->reg[0x06]) & 0x1F) == 31)
+            {
+                mux->overflow_count++;
+            }
+            a_read_test_push(mux->channel[c], (uint32_t)(mux->produced[c] & 0x7FFF), 0, 0, 3);
+            mux->produced[c]++;
+        }
+    }
+}
+
+/**
+ * @brief     get the simulated device of the selected channel
+ * @param[in] *mux pointer to a simulated mux
+ * @param[in] bytes transaction length in bytes
+ * @return    pointer to a simulated bus, NULL without exactly one channel
+ * @note      a transaction takes 22.5us per byte at 400kHz
+ */
+static read_test_bus_t *a_read_test_mux_device(read_test_mux_t *mux, uint32_t bytes)
+{
+    uint8_t c;
+    
+    a_read_test_mux_advance(mux, bytes * 22500ULL);
+    mux->device_count++;
+    for (c = 0; c < 8; c++)
+    {
+        if (mux->mask == (1 << c))
+        {
+            return mux->channel[c];
+        }
+    }
+    mux->collision_count++;
+    
+    return NULL;
+}
+
+/**
+ * @brief      simulated mux bus read
+ * @param[in]  *user pointer to a simulated mux
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no device answered
+ * @note       the control register is write only here
+ */
+static uint8_t a_read_test_mux_read(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    read_test_mux_t *mux = (read_test_mux_t *)user;
+    read_test_bus_t *bus;
+    
+    if (addr == MAX30105_BUS_MUX_ADDRESS)
+    {
+        return 1;
+    }
+    bus = a_read_test_mux_device(mux, len + 3);
+    if (bus == NULL)
+    {
+        return 1;
+    }
+    
+    return a_read_test_iic_read(bus, addr, reg, buf, len);
+}
+
+/**
+ * @brief     simulated mux bus write
+ * @param[in] *user pointer to a simulated mux
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address or mux control byte
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 no device answered
+ * @note      none
+ */
+static uint8_t a_read_test_mux_write(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    read_test_mux_t *mux = (read_test_mux_t *)user;
+    read_test_bus_t *bus;
+    
+    if (addr == MAX30105_BUS_MUX_ADDRESS)
+    {
+        a_read_test_mux_advance(mux, 2 * 22500ULL);
+        mux->mask = reg;
+        mux->write_count++;
+        if (mux->log_len < 8)
+        {
+            mux->log[mux->log_len] = reg;
+            mux->log_len++;
+        }
+        
+        return 0;
+    }
+    bus = a_read_test_mux_device(mux, len + 2);
+    if (bus == NULL)
+    {
+        return 1;
+    }
+    
+    return a_read_test_iic_write(bus, addr, reg, buf, len);
+}
+
+/**
+ * @brief     simulated mux sample receive
+ * @param[in] *user pointer to a simulated mux
+ * @param[in] index device index
+ * @param[in] *sample pointer to a sample buffer
+ * @param[in] len number of samples
+ * @note      devices are added in channel order so the index is the channel
+ */
+static void a_read_test_mux_receive(void *user, uint8_t index, max30105_sample_t *sample, uint8_t len)
+{
+    uint8_t i;
+    read_test_mux_t *mux = (read_test_mux_t *)user;
+    
+    for (i = 0; i < len; i++)
+    {
+        if ((sample[i].red != (uint32_t)(mux->received[index] & 0x7FFF)) ||
+            ((sample[i].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0))
+        {
+            mux->error_count++;
+        }
+        mux->received[index]++;
+    }
+}
+
+/**
+ * @brief     get the simulated mux time
+ * @param[in] *user pointer to a simulated mux
+ * @return    time in ns
+ * @note      none
+ */
+static uint64_t a_read_test_mux_timestamp(void *user)
+{
+    read_test_mux_t *mux = (read_test_mux_t *)user;
+    
+    return mux->now;
+}
+
+/**
+ * @brief  read test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   runs against a simulated bus and needs no chip
+ */
+uint8_t max30105_read_test(void)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t len;
+    uint8_t level;
+    max30105_config_t config;
+    max30105_config_t check;
+    uint32_t raw_red[32];
+    uint32_t raw_ir[32];
+    uint32_t raw_green[32];
+    uint8_t raw[288];
+    max30105_mode_t mode;
+    max30105_adc_resolution_t resolution;
+    max30105_sample_t sample[32];
+    uint64_t sequence;
+    uint32_t seed;
+    uint8_t m;
+    uint8_t r;
+    
+    /* link simulated bus */
+    a_read_test_link(&gs_handle, &gs_bus);
+    
+    /* start read test */
+    max30105_interface_debug_print("max30105: start read test.\n");
+    
+    /* init the max30105 */
+    res = max30105_init(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: init failed.\n");
+       
+        return 1;
+    }
+    
+    /* set green red ir mode */
+    res = max30105_set_mode(&gs_handle, MAX30105_MODE_GREEN_RED_IR);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set mode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set 18 bits */
+    res = max30105_set_adc_resolution(&gs_handle, MAX30105_ADC_RESOLUTION_18_BIT);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set adc resolution failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* green red ir mode with 18 bits */
+    max30105_interface_debug_print("max30105: green red ir mode with 18 bits.\n");
+    for (i = 0; i < 10; i++)
+    {
+        a_read_test_push(&gs_bus, 0x3FFFF - i, 0x20000 + i, 0x00100 + i, 0);
+    }
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    len = 32;
+    res = max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: read failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: read %d samples with %d read and %d write transactions.\n",
+                                   len, gs_bus.read_count, gs_bus.write_count);
+    if ((len != 10) || (gs_bus.read_count != 2) || (gs_bus.write_count != 0))
+    {
+        max30105_interface_debug_print("max30105: check transactions error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < len; i++)
+    {
+        if ((raw_red[i] != (0x3FFFFU - i)) || (raw_ir[i] != (0x20000U + i)) || (raw_green[i] != (0x00100U + i)))
+        {
+            max30105_interface_debug_print("max30105: check data error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check data ok.\n");
+    
+    /* missing buffer */
+    max30105_interface_debug_print("max30105: missing buffer.\n");
+    for (i = 0; i < 2; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    len = 32;
+    res = max30105_read(&gs_handle, raw_red, raw_ir, NULL, &len);
+    if ((res != 1) || (gs_bus.read_count != 0) || (gs_bus.write_count != 0))
+    {
+        max30105_interface_debug_print("max30105: check missing buffer error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    len = 32;
+    res = max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+    if ((res != 0) || (len != 2))
+    {
+        max30105_interface_debug_print("max30105: check missing buffer error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check missing buffer ok.\n");
+    
+    /* set red mode */
+    res = max30105_set_mode(&gs_handle, MAX30105_MODE_RED);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set mode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set 15 bits */
+    res = max30105_set_adc_resolution(&gs_handle, MAX30105_ADC_RESOLUTION_15_BIT);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set adc resolution failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* red mode with 15 bits */
+    max30105_interface_debug_print("max30105: red mode with 15 bits.\n");
+    for (i = 0; i < 20; i++)
+    {
+        a_read_test_push(&gs_bus, 0x7FFF - i, 0, 0, 3);
+    }
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    len = 32;
+    res = max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: read failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: read %d samples with %d read and %d write transactions.\n",
+                                   len, gs_bus.read_count, gs_bus.write_count);
+    if ((len != 20) || (gs_bus.read_count != 2) || (gs_bus.write_count != 0))
+    {
+        max30105_interface_debug_print("max30105: check transactions error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < len; i++)
+    {
+        if (raw_red[i] != (0x7FFFU - i))
+        {
+            max30105_interface_debug_print("max30105: check data error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check data ok.\n");
+    
+    /* empty fifo */
+    max30105_interface_debug_print("max30105: empty fifo.\n");
+    res = max30105_get_fifo_level(&gs_handle, &level);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: get fifo level failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: fifo level is %d.\n", level);
+    if (level != 0)
+    {
+        max30105_interface_debug_print("max30105: check fifo level error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    len = 32;
+    res = max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: read failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: read %d samples with %d read and %d write transactions.\n",
+                                   len, gs_bus.read_count, gs_bus.write_count);
+    if ((len != 0) || (gs_bus.read_count != 1) || (gs_bus.write_count != 0))
+    {
+        max30105_interface_debug_print("max30105: check transactions error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* full fifo */
+    max30105_interface_debug_print("max30105: full fifo.\n");
+    for (i = 0; i < 32; i++)
+    {
+        a_read_test_push(&gs_bus, i, 0, 0, 3);
+    }
+    gs_bus.reg[0x05] = 3;
+    res = max30105_get_fifo_level(&gs_handle, &level);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: get fifo level failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: fifo level is %d.\n", level);
+    if (level != 32)
+    {
+        max30105_interface_debug_print("max30105: check fifo level error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    len = 32;
+    res = max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+    if ((res != 4) || (len != 32))
+    {
+        max30105_interface_debug_print("max30105: check fifo overrun error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check fifo level ok.\n");
+    
+    /* fifo full and die temperature irq */
+    max30105_interface_debug_print("max30105: fifo full and die temperature irq.\n");
+    res = max30105_set_irq_fifo_drain(&gs_handle, MAX30105_BOOL_TRUE, raw_red, raw_ir, raw_green);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set irq fifo drain failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 24; i++)
+    {
+        a_read_test_push(&gs_bus, 0x1000 + i, 0, 0, 3);
+    }
+    gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL;
+    gs_bus.reg[0x01] = 1 << MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY;
+    gs_bus.reg[0x1F] = 0x19;
+    gs_bus.reg[0x20] = 0x08;
+    gs_bus.irq_type = 0;
+    gs_bus.irq_len = 0;
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    res = max30105_irq_handler(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: irq handler failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: irq drained %d samples with %d read and %d write transactions.\n",
+                                   gs_bus.irq_len, gs_bus.read_count, gs_bus.write_count);
+    if ((gs_bus.irq_len != 24) || (gs_bus.read_count != 4) || (gs_bus.write_count != 0) || (raw_red[23] != 0x1017) ||
+        (gs_bus.irq_type != ((1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL) | (1 << MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY))) ||
+        (gs_handle.raw != 0x198))
+    {
+        max30105_interface_debug_print("max30105: check irq error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check irq ok.\n");
+    
+    /* apply and read back the config */
+    max30105_interface_debug_print("max30105: apply and read back the config.\n");
+    memset(&config, 0, sizeof(max30105_config_t));
+    config.interrupt_fifo_full = MAX30105_BOOL_TRUE;
+    config.interrupt_prox_int = MAX30105_BOOL_TRUE;
+    config.interrupt_die_temp_rdy = MAX30105_BOOL_TRUE;
+    config.sample_averaging = MAX30105_SAMPLE_AVERAGING_8;
+    config.fifo_roll = MAX30105_BOOL_TRUE;
+    config.fifo_almost_full = 0xF;
+    config.shutdown = MAX30105_BOOL_FALSE;
+    config.mode = MAX30105_MODE_GREEN_RED_IR;
+    config.adc_range = MAX30105_PARTICLE_SENSING_ADC_RANGE_4096;
+    config.sample_rate = MAX30105_PARTICLE_SENSING_SAMPLE_RATE_100_HZ;
+    config.adc_resolution = MAX30105_ADC_RESOLUTION_18_BIT;
+    config.led_red_pulse_amplitude = 0x7F;
+    config.led_ir_pulse_amplitude = 0x3F;
+    config.led_green_pulse_amplitude = 0x1F;
+    config.led_proximity_pulse_amplitude = 0x0F;
+    config.slot[0] = MAX30105_LED_RED_LED1_PA;
+    config.slot[1] = MAX30105_LED_IR_LED2_PA;
+    config.slot[2] = MAX30105_LED_GREEN_LED3_PA;
+    config.slot[3] = MAX30105_LED_NONE;
+    config.proximity_threshold = 0x3F;
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    gs_bus.reg[0x0F] = 0xA5;
+    res = max30105_apply_config(&gs_handle, &config);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: apply config failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: apply config with %d read and %d write transactions.\n",
+                                   gs_bus.read_count, gs_bus.write_count);
+    if ((gs_bus.read_count != 0) || (gs_bus.write_count != 5) || (gs_bus.reg[0x0F] != 0xA5))
+    {
+        max30105_interface_debug_print("max30105: check transactions error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    memset(&check, 0, sizeof(max30105_config_t));
+    res = max30105_read_config(&gs_handle, &check);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: read config failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: read config with %d read and %d write transactions.\n",
+                                   gs_bus.read_count, gs_bus.write_count);
+    if ((gs_bus.read_count != 4) || (gs_bus.write_count != 0))
+    {
+        max30105_interface_debug_print("max30105: check transactions error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    if (memcmp(&config, &check, sizeof(max30105_config_t)) != 0)
+    {
+        max30105_interface_debug_print("max30105: check config error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check config ok.\n");
+    
+    /* raw fifo transfer and decode */
+    max30105_interface_debug_print("max30105: raw fifo transfer and decode.\n");
+    for (i = 0; i < 12; i++)
+    {
+        a_read_test_push(&gs_bus, 0x30000 + i, 0x20000 + i, 0x10000 + i, 0);
+    }
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    len = 32;
+    res = max30105_read_fifo_raw(&gs_handle, raw, &len, &mode, &resolution);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: read fifo raw failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: read %d raw samples with %d read and %d write transactions.\n",
+                                   len, gs_bus.read_count, gs_bus.write_count);
+    if ((len != 12) || (gs_bus.read_count != 2) || (gs_bus.write_count != 0) ||
+        (mode != MAX30105_MODE_GREEN_RED_IR) || (resolution != MAX30105_ADC_RESOLUTION_18_BIT))
+    {
+        max30105_interface_debug_print("max30105: check raw transfer error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    gs_bus.read_count = 0;
+    res = max30105_decode(mode, resolution, raw, len, raw_red, raw_ir, raw_green);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: decode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < len; i++)
+    {
+        if ((raw_red[i] != (0x30000U + i)) || (raw_ir[i] != (0x20000U + i)) || (raw_green[i] != (0x10000U + i)))
+        {
+            max30105_interface_debug_print("max30105: check decode error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    if (gs_bus.read_count != 0)
+    {
+        max30105_interface_debug_print("max30105: decode touched the bus.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_decode(MAX30105_MODE_RED, MAX30105_ADC_RESOLUTION_15_BIT, raw, len, raw_red, NULL, NULL);
+    if ((res != 0) || (raw_red[0] != (0x30000U >> 3)))
+    {
+        max30105_interface_debug_print("max30105: check decode error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check decode ok.\n");
+    
+    /* every mode and adc resolution against the reference */
+    seed = 0x12345678;
+    for (i = 0; i < 32; i++)
+    {
+        for (m = 0; m < 9; m++)
+        {
+            seed = seed * 1103515245U + 12345U;
+            raw[i * 9 + m] = (uint8_t)(seed >> 16);
+        }
+    }
+    for (m = 0; m < 3; m++)
+    {
+        const max30105_mode_t modes[3] = {MAX30105_MODE_RED, MAX30105_MODE_RED_IR, MAX30105_MODE_GREEN_RED_IR};
+        
+        for (r = 0; r < 4; r++)
+        {
+            uint8_t k = (uint8_t)(3 * (m + 1));
+            uint8_t bit = (uint8_t)(3 - r);
+            
+            res = max30105_decode(modes[m], (max30105_adc_resolution_t)r, raw, 32, raw_red, raw_ir, raw_green);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: decode failed.\n");
+                (void)max30105_deinit(&gs_handle);
+               
+                return 1;
+            }
+            res = max30105_decode_samples(modes[m], (max30105_adc_resolution_t)r, raw, 32, 100, sample);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: decode samples failed.\n");
+                (void)max30105_deinit(&gs_handle);
+               
+                return 1;
+            }
+            for (i = 0; i < 32; i++)
+            {
+                if ((raw_red[i] != a_read_test_word(raw, i * k + 0, bit)) ||
+                    ((m >= 1) && (raw_ir[i] != a_read_test_word(raw, i * k + 3, bit))) ||
+                    ((m >= 2) && (raw_green[i] != a_read_test_word(raw, i * k + 6, bit))))
+                {
+                    max30105_interface_debug_print("max30105: check decode mode %d resolution %d error.\n", m, r);
+                    (void)max30105_deinit(&gs_handle);
+                   
+                    return 1;
+                }
+                if ((sample[i].sequence != (100U + i)) || (sample[i].red != raw_red[i]) ||
+                    (sample[i].ir != ((m >= 1) ? raw_ir[i] : 0)) || (sample[i].green != ((m >= 2) ? raw_green[i] : 0)))
+                {
+                    max30105_interface_debug_print("max30105: check decode samples mode %d resolution %d error.\n", m, r);
+                    (void)max30105_deinit(&gs_handle);
+                   
+                    return 1;
+                }
+            }
+        }
+    }
+    max30105_interface_debug_print("max30105: check decode against the reference ok.\n");
+    
+    /* decoder follows every mode and adc resolution change */
+    for (m = 0; m < 3; m++)
+    {
+        const max30105_mode_t modes[3] = {MAX30105_MODE_RED, MAX30105_MODE_RED_IR, MAX30105_MODE_GREEN_RED_IR};
+        
+        res = max30105_set_mode(&gs_handle, modes[m]);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: set mode failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        for (r = 0; r < 4; r++)
+        {
+            uint8_t bit = (uint8_t)(3 - r);
+            uint32_t mask = 0x3FFFFU >> bit;
+            
+            if (r == 3)
+            {
+                uint8_t spo2 = (uint8_t)((gs_bus.reg[0x0A] & (~0x3)) | r);
+                
+                /* write behind the shadow */
+                res = max30105_set_reg(&gs_handle, 0x0A, &spo2, 1);
+            }
+            else
+            {
+                res = max30105_set_adc_resolution(&gs_handle, (max30105_adc_resolution_t)r);
+            }
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: set adc resolution failed.\n");
+                (void)max30105_deinit(&gs_handle);
+               
+                return 1;
+            }
+            for (i = 0; i < 4; i++)
+            {
+                a_read_test_push(&gs_bus, (0x2AAAAU + i) & mask, (0x15555U + i) & mask, (0x3C3C3U + i) & mask, bit);
+            }
+            len = 32;
+            res = max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+            if ((res != 0) || (len != 4))
+            {
+                max30105_interface_debug_print("max30105: read failed.\n");
+                (void)max30105_deinit(&gs_handle);
+               
+                return 1;
+            }
+            for (i = 0; i < 4; i++)
+            {
+                if ((raw_red[i] != ((0x2AAAAU + i) & mask)) ||
+                    ((m >= 1) && (raw_ir[i] != ((0x15555U + i) & mask))) ||
+                    ((m >= 2) && (raw_green[i] != ((0x3C3C3U + i) & mask))))
+                {
+                    max30105_interface_debug_print("max30105: check decoder mode %d resolution %d error.\n", m, r);
+                    (void)max30105_deinit(&gs_handle);
+                   
+                    return 1;
+                }
+            }
+        }
+    }
+    max30105_interface_debug_print("max30105: check decoder selection ok.\n");
+    
+    /* samples with sequence numbers */
+    max30105_interface_debug_print("max30105: samples with sequence numbers.\n");
+    res = max30105_get_sample_sequence(&gs_handle, &sequence);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: get sample sequence failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    a_read_test_push(&gs_bus, 0x00001, 0x00002, 0x00003, 0);
+    a_read_test_push(&gs_bus, 0x3FFFF, 0x00005, 0x00006, 0);
+    a_read_test_push(&gs_bus, 0x00007, 0x00008, 0x00009, 0);
+    len = 32;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 0) || (len != 3))
+    {
+        max30105_interface_debug_print("max30105: read samples failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        if ((sample[i].sequence != (sequence + i)) || (sample[i].green != (uint32_t)(3 * i + 3)) ||
+            (sample[i].flags != ((i == 1) ? MAX30105_SAMPLE_FLAG_SATURATED : 0)))
+        {
+            max30105_interface_debug_print("max30105: check samples error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check samples ok.\n");
+    
+    /* overflow without fifo roll loses the newest samples */
+    res = max30105_set_fifo_roll(&gs_handle, MAX30105_BOOL_FALSE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 32; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    gs_bus.reg[0x05] = 5;
+    len = 32;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 4) || (len != 32) || (sample[0].sequence != (sequence + 3)) || (sample[31].sequence != (sequence + 34)) ||
+        ((sample[0].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0))
+    {
+        max30105_interface_debug_print("max30105: check overflow samples error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    a_read_test_push(&gs_bus, 1, 1, 1, 0);
+    len = 32;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 0) || (len != 1) || (sample[0].sequence != (sequence + 40)) || (sample[0].lost != 5) ||
+        ((sample[0].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) == 0))
+    {
+        max30105_interface_debug_print("max30105: check overflow gap error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    
+    /* overflow with fifo roll loses the oldest samples */
+    res = max30105_set_fifo_roll(&gs_handle, MAX30105_BOOL_TRUE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 32; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    gs_bus.reg[0x05] = 2;
+    len = 32;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 4) || (len != 32) || (sample[0].sequence != (sequence + 43)) || (sample[0].lost != 2) || (sample[1].lost != 0) ||
+        ((sample[0].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) == 0) || ((sample[1].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0))
+    {
+        max30105_interface_debug_print("max30105: check fifo roll gap error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_get_sample_sequence(&gs_handle, &sequence);
+    if ((res != 0) || (sequence != (sample[31].sequence + 1)))
+    {
+        max30105_interface_debug_print("max30105: check sample sequence error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    
+    /* a second overrun before the first gap is drained */
+    res = max30105_set_fifo_roll(&gs_handle, MAX30105_BOOL_FALSE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 32; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    gs_bus.reg[0x05] = 3;
+    len = 4;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 4) || (len != 4) || (sample[3].sequence != (sequence + 3)) || ((sample[3].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0))
+    {
+        max30105_interface_debug_print("max30105: check double overrun error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    gs_bus.reg[0x05] = 2;
+    len = 4;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 4) || (len != 4) || (sample[3].sequence != (sequence + 7)) || ((sample[3].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0))
+    {
+        max30105_interface_debug_print("max30105: check double overrun error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    
+    /* both losses are flagged after the samples of the first overrun */
+    len = 32;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 0) || (len != 28) || (sample[23].sequence != (sequence + 31)) || (sample[24].sequence != (sequence + 37)) ||
+        (sample[24].lost != 5) || ((sample[24].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) == 0) ||
+        ((sample[23].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0))
+    {
+        max30105_interface_debug_print("max30105: check double overrun error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_set_fifo_roll(&gs_handle, MAX30105_BOOL_TRUE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check overflow gap ok.\n");
+    {
+        max30105_loss_t loss;
+        
+        res = max30105_get_loss_statistics(&gs_handle, &loss);
+        max30105_interface_debug_print("max30105: lost %d samples in %d overruns.\n", (int)loss.lost, (int)loss.overruns);
+        if ((res != 0) || (loss.lost != 15) || (loss.overruns != 5) || (loss.saturated != 0))
+        {
+            max30105_interface_debug_print("max30105: check loss statistics error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        res = max30105_clear_loss_statistics(&gs_handle);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: clear loss statistics failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check loss statistics ok.\n");
+    
+    /* raw reads keep the sample sequence */
+    max30105_interface_debug_print("max30105: raw and sample reads.\n");
+    res = max30105_get_sample_sequence(&gs_handle, &sequence);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: get sample sequence failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 5; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    len = 32;
+    res = max30105_read_fifo_raw(&gs_handle, raw, &len, &mode, &resolution);
+    if ((res != 0) || (len != 5))
+    {
+        max30105_interface_debug_print("max30105: read fifo raw failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    len = 32;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 0) || (len != 3) || (sample[0].sequence != (sequence + 5)) || (sample[2].sequence != (sequence + 7)))
+    {
+        max30105_interface_debug_print("max30105: check raw sequence error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    
+    /* an overrun seen by a raw read is flagged in the next sample read */
+    res = max30105_set_fifo_roll(&gs_handle, MAX30105_BOOL_FALSE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    gs_bus.reg[0x05] = 3;
+    len = 32;
+    res = max30105_read_fifo_raw(&gs_handle, raw, &len, &mode, &resolution);
+    if ((res != 4) || (len != 4))
+    {
+        max30105_interface_debug_print("max30105: read fifo raw failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 2; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    len = 32;
+    res = max30105_read_samples(&gs_handle, sample, &len);
+    if ((res != 0) || (len != 2) || (sample[0].sequence != (sequence + 15)) || (sample[0].lost != 3) ||
+        ((sample[0].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) == 0) || (sample[1].sequence != (sequence + 16)))
+    {
+        max30105_interface_debug_print("max30105: check raw gap error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_set_fifo_roll(&gs_handle, MAX30105_BOOL_TRUE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    {
+        max30105_loss_t loss;
+        
+        res = max30105_get_loss_statistics(&gs_handle, &loss);
+        if ((res != 0) || (loss.lost != 3) || (loss.overruns != 1))
+        {
+            max30105_interface_debug_print("max30105: check raw loss error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        res = max30105_clear_loss_statistics(&gs_handle);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: clear loss statistics failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check raw sequence ok.\n");
+    
+    /* adaptive watermark */
+    max30105_interface_debug_print("max30105: adaptive watermark.\n");
+    res = max30105_set_watermark_control(&gs_handle, MAX30105_BOOL_TRUE, 2);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set watermark control failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (m = 0; m < 80; m++)
+    {
+        /* 3 samples arrive before the fifo is read */
+        level = (uint8_t)(32 - (gs_bus.reg[0x08] & 0xF));
+        for (i = 0; i < level + 3; i++)
+        {
+            a_read_test_push(&gs_bus, i, i, i, 0);
+        }
+        gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL;
+        res = max30105_irq_handler(&gs_handle);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: irq handler failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: fifo almost full settles at %d.\n", gs_bus.reg[0x08] & 0xF);
+    if ((gs_bus.reg[0x08] & 0xF) != 5)
+    {
+        max30105_interface_debug_print("max30105: check watermark error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    level = (uint8_t)(32 - (gs_bus.reg[0x08] & 0xF));
+    for (i = 0; i < level + 3; i++)
+    {
+        a_read_test_push(&gs_bus, i, i, i, 0);
+    }
+    gs_bus.reg[0x05] = 4;
+    gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL;
+    res = max30105_irq_handler(&gs_handle);
+    if ((res != 0) || ((gs_bus.reg[0x08] & 0xF) != 0xF))
+    {
+        max30105_interface_debug_print("max30105: check watermark overrun error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    
+    /* a zero margin would let the watermark decay to a full fifo */
+    res = max30105_set_watermark_control(&gs_handle, MAX30105_BOOL_TRUE, 0);
+    if (res != 4)
+    {
+        max30105_interface_debug_print("max30105: check watermark margin error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_set_watermark_control(&gs_handle, MAX30105_BOOL_TRUE, 1);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set watermark control failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (m = 0; m < 80; m++)
+    {
+        /* the fifo is read at the edge */
+        level = (uint8_t)(32 - (gs_bus.reg[0x08] & 0xF));
+        for (i = 0; i < level; i++)
+        {
+            a_read_test_push(&gs_bus, i, i, i, 0);
+        }
+        gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL;
+        res = max30105_irq_handler(&gs_handle);
+        if ((res != 0) || ((gs_bus.reg[0x08] & 0xF) == 0))
+        {
+            max30105_interface_debug_print("max30105: check watermark margin error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    if ((gs_bus.reg[0x08] & 0xF) != 1)
+    {
+        max30105_interface_debug_print("max30105: check watermark margin error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_set_watermark_control(&gs_handle, MAX30105_BOOL_FALSE, 2);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set watermark control failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check watermark ok.\n");
+    
+    /* timestamps from edge times */
+    max30105_interface_debug_print("max30105: timestamps from edge times.\n");
+    res = max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_PARTICLE_SENSING_SAMPLE_RATE_100_HZ);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set particle sensing sample rate failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_set_fifo_sample_averaging(&gs_handle, MAX30105_SAMPLE_AVERAGING_1);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo sample averaging failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_get_sample_sequence(&gs_handle, &sequence);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: get sample sequence failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (m = 0; m < 100; m++)
+    {
+        for (i = 0; i < 8; i++)
+        {
+            a_read_test_push(&gs_bus, i, i, i, 0);
+        }
+        
+        /* sensor clock is 100 ppm slow, the edge comes with the newest sample */
+        res = max30105_set_edge_timestamp(&gs_handle, 1000000000ULL + (uint64_t)(m * 8 + 7) * 10001000ULL);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: set edge timestamp failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        len = 32;
+        res = max30105_read_samples(&gs_handle, sample, &len);
+        if ((res != 0) || (len != 8))
+        {
+            max30105_interface_debug_print("max30105: read samples failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    {
+        float ppm;
+        int64_t err;
+        
+        res = max30105_get_clock_drift(&gs_handle, &ppm);
+        err = (int64_t)(sample[0].timestamp - (1000000000ULL + (sample[0].sequence - sequence) * 10001000ULL));
+        max30105_interface_debug_print("max30105: clock drift is %0.1fppm and timestamp error is %dns.\n", ppm, (int)err);
+        if ((res != 0) || (ppm < 90.0f) || (ppm > 110.0f) || (err > 1000) || (err < -1000))
+        {
+            max30105_interface_debug_print("max30105: check timestamps error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check timestamps ok.\n");
+    
+    /* deadline polling */
+    max30105_interface_debug_print("max30105: deadline polling.\n");
+    {
+        uint64_t now;
+        uint64_t deadline;
+        uint64_t produced;
+        uint32_t polls;
+        uint32_t total;
+        
+        /* the sensor keeps sampling every 10.001ms after the timestamp test */
+        produced = sample[0].sequence - sequence + 8;
+        now = 1000000000ULL + (produced - 1) * 10001000ULL;
+        polls = 0;
+        total = 0;
+        for (m = 0; m < 200; m++)
+        {
+            /* every 8th wake up is one sample late */
+            while (1000000000ULL + produced * 10001000ULL <= now + (((m % 8) == 7) ? 10001000ULL : 0))
+            {
+                a_read_test_push(&gs_bus, 0, 0, 0, 0);
+                produced++;
+            }
+            len = 32;
+            res = max30105_poll(&gs_handle, now, sample, &len, &deadline);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: poll failed.\n");
+                (void)max30105_deinit(&gs_handle);
+               
+                return 1;
+            }
+            if (m >= 20)
+            {
+                polls++;
+                total += len;
+            }
+            now = deadline;
+        }
+        max30105_interface_debug_print("max30105: %d samples per poll.\n", total / polls);
+        if ((total / polls) < 26)
+        {
+            max30105_interface_debug_print("max30105: check polling error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check polling ok.\n");
+    
+    /* shadow invalidate */
+    max30105_interface_debug_print("max30105: shadow invalidate.\n");
+    {
+        float ppm;
+        
+        res = max30105_shadow_invalidate(&gs_handle);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: shadow invalidate failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        
+        /* the clock estimation is derived from the forgotten registers */
+        if (max30105_get_clock_drift(&gs_handle, &ppm) != 4)
+        {
+            max30105_interface_debug_print("max30105: check shadow invalidate error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        res = max30105_shadow_resync(&gs_handle);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: shadow resync failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check shadow invalidate ok.\n");
+    
+    /* data ready edge */
+    max30105_interface_debug_print("max30105: data ready edge.\n");
+    {
+        float ppm;
+        
+        len = 32;
+        res = max30105_read_samples(&gs_handle, sample, &len);
+        if ((res != 0) && (res != 4))
+        {
+            max30105_interface_debug_print("max30105: read samples failed.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        
+        /* the edge comes with the third sample, two more arrive before the read */
+        for (i = 0; i < 3; i++)
+        {
+            a_read_test_push(&gs_bus, i, i, i, 0);
+        }
+        res = max30105_set_edge_timestamp(&gs_handle, 5000000000ULL);
+        gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_DATA_RDY;
+        res |= max30105_irq_handler(&gs_handle);
+        for (i = 0; i < 2; i++)
+        {
+            a_read_test_push(&gs_bus, i, i, i, 0);
+        }
+        len = 32;
+        res |= max30105_read_samples(&gs_handle, sample, &len);
+        if ((res != 0) || (len != 5) || (sample[2].timestamp != 5000000000ULL))
+        {
+            max30105_interface_debug_print("max30105: check data ready edge error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        
+        /* a plain read matches the edge too */
+        res = max30105_shadow_invalidate(&gs_handle);
+        res |= max30105_shadow_resync(&gs_handle);
+        a_read_test_push(&gs_bus, 0, 0, 0, 0);
+        res |= max30105_set_edge_timestamp(&gs_handle, 6000000000ULL);
+        gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_DATA_RDY;
+        res |= max30105_irq_handler(&gs_handle);
+        len = 32;
+        res |= max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+        if ((res != 0) || (len != 1) || (max30105_get_clock_drift(&gs_handle, &ppm) != 0))
+        {
+            max30105_interface_debug_print("max30105: check data ready edge error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+        
+        /* a resync drops the clock estimation of the old config */
+        res = max30105_shadow_resync(&gs_handle);
+        if ((res != 0) || (max30105_get_clock_drift(&gs_handle, &ppm) != 4))
+        {
+            max30105_interface_debug_print("max30105: check shadow resync error.\n");
+            (void)max30105_deinit(&gs_handle);
+           
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check data ready edge ok.\n");
+    
+    /* batched transfers */
+    max30105_interface_debug_print("max30105: batched transfers.\n");
+    DRIVER_MAX30105_LINK_IIC_TRANSFER_CTX(&gs_handle, a_read_test_iic_transfer);
+    res = max30105_set_fifo_almost_full(&gs_handle, 0x8);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo almost full failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 26; i++)
+    {
+        a_read_test_push(&gs_bus, 0x2000 + i, 0, 0, 0);
+    }
+    gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL;
+    gs_bus.irq_len = 0;
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    gs_bus.transfer_count = 0;
+    res = max30105_irq_handler(&gs_handle);
+    max30105_interface_debug_print("max30105: irq drained %d samples with %d read, %d write and %d batch transactions.\n",
+                                   gs_bus.irq_len, gs_bus.read_count, gs_bus.write_count, gs_bus.transfer_count);
+    if ((res != 0) || (gs_bus.irq_len != 26) || (gs_bus.read_count != 1) || (gs_bus.write_count != 0) ||
+        (gs_bus.transfer_count != 1) || (raw_red[0] != 0x2000) || (raw_red[25] != 0x2019))
+    {
+        max30105_interface_debug_print("max30105: check batched drain error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    
+    /* the fifo was drained before the fifo full edge was served */
+    for (i = 0; i < 26; i++)
+    {
+        a_read_test_push(&gs_bus, 0x2100 + i, 0, 0, 0);
+    }
+    len = 20;
+    res = max30105_read(&gs_handle, raw_red, raw_ir, raw_green, &len);
+    if ((res != 0) || (len != 20))
+    {
+        max30105_interface_debug_print("max30105: read failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        a_read_test_push(&gs_bus, 0x3000 + i, 0, 0, 0);
+    }
+    gs_bus.reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL;
+    gs_bus.irq_len = 0;
+    gs_bus.write_count = 0;
+    res = max30105_irq_handler(&gs_handle);
+    if ((res != 0) || (gs_bus.irq_len != 10) || (raw_red[5] != 0x2119) || (raw_red[9] != 0x3003) ||
+        (gs_bus.write_count != 0) || (gs_bus.reg[0x04] != gs_bus.reg[0x06]))
+    {
+        max30105_interface_debug_print("max30105: check batched over read error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    gs_bus.read_count = 0;
+    gs_bus.write_count = 0;
+    gs_bus.transfer_count = 0;
+    res = max30105_shadow_resync(&gs_handle);
+    max30105_interface_debug_print("max30105: shadow resync with %d read, %d write and %d batch transactions.\n",
+                                   gs_bus.read_count, gs_bus.write_count, gs_bus.transfer_count);
+    if ((res != 0) || (gs_bus.read_count != 0) || (gs_bus.transfer_count != 1))
+    {
+        max30105_interface_debug_print("max30105: check batched resync error.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    DRIVER_MAX30105_LINK_IIC_TRANSFER_CTX(&gs_handle, NULL);
+    max30105_interface_debug_print("max30105: check batched transfers ok.\n");
+    
+    /* two handles on two buses */
+    max30105_interface_debug_print("max30105: two handles on two buses.\n");
+    a_read_test_link(&gs_handle2, &gs_bus2);
+    res = max30105_init(&gs_handle2);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: init failed.\n");
+        (void)max30105_deinit(&gs_handle);
+       
+        return 1;
+    }
+    res = max30105_set_mode(&gs_handle2, MAX30105_MODE_RED_IR);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set mode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        (void)max30105_deinit(&gs_handle2);
+       
+        return 1;
+    }
+    a_read_test_push(&gs_bus2, 0x1234, 0x5678, 0, 3);
+    len = 32;
+    res = max30105_read(&gs_handle2, raw_red, raw_ir, raw_green, &len);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: read failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        (void)max30105_deinit(&gs_handle2);
+       
+        return 1;
+    }
+    if (((gs_bus.reg[0x09] & 0x7) != MAX30105_MODE_GREEN_RED_IR) || ((gs_bus2.reg[0x09] & 0x7) != MAX30105_MODE_RED_IR) ||
+        (len != 1) || (raw_red[0] != 0x1234) || (raw_ir[0] != 0x5678))
+    {
+        max30105_interface_debug_print("max30105: check user context error.\n");
+        (void)max30105_deinit(&gs_handle);
+        (void)max30105_deinit(&gs_handle2);
+       
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check user context ok.\n");
+    (void)max30105_deinit(&gs_handle2);
+    
+    /* eight devices behind a mux */
+    max30105_interface_debug_print("max30105: eight devices behind a mux.\n");
+    {
+        uint8_t c;
+        uint8_t index;
+        uint32_t services;
+        uint32_t count;
+        uint32_t drained;
+        uint64_t deadline;
+        
+        memset(&gs_mux, 0, sizeof(read_test_mux_t));
+        DRIVER_MAX30105_BUS_LINK_INIT(&gs_mux_bus, max30105_bus_t);
+        DRIVER_MAX30105_BUS_LINK_USER(&gs_mux_bus, &gs_mux);
+        DRIVER_MAX30105_BUS_LINK_IIC_READ_CTX(&gs_mux_bus, a_read_test_mux_read);
+        DRIVER_MAX30105_BUS_LINK_IIC_WRITE_CTX(&gs_mux_bus, a_read_test_mux_write);
+        DRIVER_MAX30105_BUS_LINK_TIMESTAMP_CTX(&gs_mux_bus, a_read_test_mux_timestamp);
+        DRIVER_MAX30105_BUS_LINK_RECEIVE_CTX(&gs_mux_bus, a_read_test_mux_receive);
+        DRIVER_MAX30105_BUS_LINK_DEBUG_PRINT(&gs_mux_bus, max30105_interface_debug_print);
+        res = max30105_bus_init(&gs_mux_bus, MAX30105_BUS_MUX_ADDRESS);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: bus init failed.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        for (c = 0; c < 8; c++)
+        {
+            a_read_test_link(&gs_mux_handle[c], &gs_mux_device[c]);
+            gs_mux.channel[c] = &gs_mux_device[c];
+            res = max30105_bus_add(&gs_mux_bus, &gs_mux_handle[c], c, &index);
+            if ((res != 0) || (index != c))
+            {
+                max30105_interface_debug_print("max30105: bus add failed.\n");
+                (void)max30105_deinit(&gs_handle);
+                
+                return 1;
+            }
+            res = max30105_init(&gs_mux_handle[c]);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: init failed.\n");
+                (void)max30105_deinit(&gs_handle);
+                
+                return 1;
+            }
+            res = max30105_set_mode(&gs_mux_handle[c], MAX30105_MODE_RED);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: set mode failed.\n");
+                (void)max30105_deinit(&gs_handle);
+                
+                return 1;
+            }
+            res = max30105_set_particle_sensing_sample_rate(&gs_mux_handle[c], MAX30105_PARTICLE_SENSING_SAMPLE_RATE_1000_HZ);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: set particle sensing sample rate failed.\n");
+                (void)max30105_deinit(&gs_handle);
+                
+                return 1;
+            }
+        }
+        gs_mux.start = gs_mux.now;
+        for (c = 0; c < 8; c++)
+        {
+            gs_mux.period[c] = 1000000 + c * 150;
+        }
+        res = max30105_bus_add(&gs_mux_bus, &gs_handle2, 3, &index);
+        if (res != 4)
+        {
+            max30105_interface_debug_print("max30105: check used channel error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        
+        /* two seconds of 1000Hz sampling on every channel */
+        drained = 0;
+        for (services = 0; (services < 10000) && (gs_mux.now < gs_mux.start + 2000000000ULL); services++)
+        {
+            res = max30105_bus_service(&gs_mux_bus, gs_mux.now, &deadline);
+            if (res != 0)
+            {
+                max30105_interface_debug_print("max30105: bus service failed.\n");
+                (void)max30105_deinit(&gs_handle);
+                
+                return 1;
+            }
+            if ((int64_t)(deadline - gs_mux.now) > 0)
+            {
+                a_read_test_mux_advance(&gs_mux, deadline - gs_mux.now);
+            }
+        }
+        for (c = 0; c < 8; c++)
+        {
+            drained += (uint32_t)gs_mux.received[c];
+            if ((gs_mux.produced[c] - gs_mux.received[c]) >= 32)
+            {
+                gs_mux.error_count++;
+            }
+        }
+        (void)max30105_bus_get_switch_count(&gs_mux_bus, &count);
+        max30105_interface_debug_print("max30105: %d samples in %d services with %d switches, %d overflows and %d errors.\n",
+                                       drained, services, count, gs_mux.overflow_count, gs_mux.error_count);
+        if ((gs_mux.overflow_count != 0) || (gs_mux.error_count != 0) || (gs_mux.collision_count != 0) ||
+            (drained < 8 * 1900) || (gs_mux.write_count != count + 1))
+        {
+            max30105_interface_debug_print("max30105: check bus scheduler error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        
+        /* the selected channel is cached */
+        count = gs_mux.write_count + ((gs_mux_bus.channel == 3) ? 0 : 1);
+        res = max30105_get_reg(&gs_mux_handle[3], 0xFF, &level, 1);
+        res |= max30105_get_reg(&gs_mux_handle[3], 0xFF, &level, 1);
+        if ((res != 0) || (gs_mux.write_count != count) || (level != 0x15))
+        {
+            max30105_interface_debug_print("max30105: check channel cache error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        
+        /* the fifo closest to its watermark is drained first */
+        for (services = 0; services < 100; services++)
+        {
+            res = max30105_bus_service(&gs_mux_bus, gs_mux.now, &deadline);
+            if ((res != 0) || ((int64_t)(deadline - gs_mux.now) > 3000000))
+            {
+                break;
+            }
+            a_read_test_mux_advance(&gs_mux, 1000);
+        }
+        res |= max30105_bus_mark(&gs_mux_bus, 6, gs_mux.now - 3000);
+        res |= max30105_bus_mark(&gs_mux_bus, 1, gs_mux.now - 2000);
+        res |= max30105_bus_mark(&gs_mux_bus, 4, gs_mux.now - 1000);
+        gs_mux.log_len = 0;
+        c = (gs_mux_bus.channel == 6) ? 1 : 0;
+        res |= max30105_bus_service(&gs_mux_bus, gs_mux.now, &deadline);
+        if ((res != 0) || (gs_mux.log_len < 3 - c) || ((c == 0) && (gs_mux.log[0] != (1 << 6))) ||
+            (gs_mux.log[1 - c] != (1 << 1)) || (gs_mux.log[2 - c] != (1 << 4)))
+        {
+            max30105_interface_debug_print("max30105: check urgency order error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        for (c = 0; c < 8; c++)
+        {
+            (void)max30105_deinit(&gs_mux_handle[c]);
+        }
+        (void)max30105_bus_deinit(&gs_mux_bus);
+    }
+    max30105_interface_debug_print("max30105: check bus scheduler ok.\n");
+    
+    /* finish read test */
+    max30105_interface_debug_print("max30105: finish read test.\n");
+    (void)max30105_deinit(&gs_handle);
+    
+    return 0;
+}
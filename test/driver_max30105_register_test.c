@@ -1853,6 +1853,61 @@ uint8_t max30105_register_test(void)
     }
     max30105_interface_debug_print("max30105: interrupt status die temp ready is %d.\n", enable);
     
+    /* max30105_shadow_resync/max30105_shadow_invalidate test */
+    max30105_interface_debug_print("max30105: max30105_shadow_resync/max30105_shadow_invalidate test.\n");
+    
+    /* set red ir mode */
+    res = max30105_set_mode(&gs_handle, MAX30105_MODE_RED_IR);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set mode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* invalidate the shadow */
+    res = max30105_shadow_invalidate(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: shadow invalidate failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* get mode from the chip */
+    res = max30105_get_mode(&gs_handle, &mode);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: get mode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check shadow invalidate %s.\n", mode == MAX30105_MODE_RED_IR ? "ok" : "error");
+    
+    /* resync the shadow */
+    res = max30105_shadow_resync(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: shadow resync failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* get mode from the shadow */
+    res = max30105_get_mode(&gs_handle, &mode);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: get mode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check shadow resync %s.\n", mode == MAX30105_MODE_RED_IR ? "ok" : "error");
+    
     /* max30105_reset test */
     max30105_interface_debug_print("max30105: max30105_reset test.\n");
     
@@ -0,0 +1,724 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_sim.c
+ * @brief     driver max30105 simulator source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_sim.h"
+
+/**
+ * @brief sample rate table in Hz
+ */
+static const uint32_t gs_sim_rate[8] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+
+/**
+ * @brief     get the conversion period
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @return    period in ns
+ * @note      none
+ */
+static uint64_t a_max30105_sim_period(max30105_sim_t *sim)
+{
+    uint64_t period;
+    
+    period = 1000000000ULL / gs_sim_rate[(sim->reg[0x0A] >> 2) & 0x7];
+    
+    return (uint64_t)((int64_t)period + ((int64_t)period * sim->ppm) / 1000000);
+}
+
+/**
+ * @brief      get the leds of the active slots
+ * @param[in]  *sim pointer to a max30105 simulator structure
+ * @param[out] *led pointer to a 4 length led buffer
+ * @return     number of active slots
+ * @note       in multi led mode the slots run in order up to the first disabled one
+ */
+static uint8_t a_max30105_sim_slots(max30105_sim_t *sim, uint8_t *led)
+{
+    uint8_t i;
+    uint8_t mode;
+    
+    mode = sim->reg[0x09] & 0x7;
+    if (mode == MAX30105_MODE_RED)
+    {
+        led[0] = MAX30105_LED_RED_LED1_PA;
+        
+        return 1;
+    }
+    else if (mode == MAX30105_MODE_RED_IR)
+    {
+        led[0] = MAX30105_LED_RED_LED1_PA;
+        led[1] = MAX30105_LED_IR_LED2_PA;
+        
+        return 2;
+    }
+    else if (mode == MAX30105_MODE_GREEN_RED_IR)
+    {
+        led[0] = sim->reg[0x11] & 0x7;
+        led[1] = (sim->reg[0x11] >> 4) & 0x7;
+        led[2] = sim->reg[0x12] & 0x7;
+        led[3] = (sim->reg[0x12] >> 4) & 0x7;
+        for (i = 0; i < 4; i++)
+        {
+            if (led[i] == MAX30105_LED_NONE)
+            {
+                break;
+            }
+        }
+        
+        return i;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+/**
+ * @brief     restart the conversions
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      the running average is dropped and the next conversion is one period away
+ */
+static void a_max30105_sim_restart(max30105_sim_t *sim)
+{
+    sim->average_count = 0;
+    memset(sim->average, 0, sizeof(uint32_t) * 4);
+    sim->next = sim->now + a_max30105_sim_period(sim);
+}
+
+/**
+ * @brief     restore the power on registers
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      none
+ */
+static void a_max30105_sim_reset(max30105_sim_t *sim)
+{
+    memset(sim->reg, 0, sizeof(uint8_t) * 256);
+    memset(sim->fifo, 0, sizeof(uint8_t) * 32 * 12);
+    sim->reg[0xFF] = MAX30105_SIM_PART_ID;
+    sim->fifo_full = 0;
+    sim->fifo_byte = 0;
+    sim->prox_armed = 0;
+    sim->temp_done = 0;
+    a_max30105_sim_restart(sim);
+}
+
+/**
+ * @brief     get the optical signal of one led
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @param[in] led led of the slot
+ * @return    18 bits adc counts
+ * @note      without a signal each led reads a ramp of the conversion counter
+ *            in units of the adc resolution, offset by the led number
+ */
+static uint32_t a_max30105_sim_signal(max30105_sim_t *sim, uint8_t led)
+{
+    uint8_t shift;
+    uint32_t value;
+    
+    led &= 0x3;
+    if (sim->signal != NULL)
+    {
+        value = sim->signal(sim->signal_user, led, sim->now);
+        
+        return (value > 0x3FFFF) ? 0x3FFFF : value;
+    }
+    shift = 3 - (sim->reg[0x0A] & 0x3);
+    value = (uint32_t)(sim->conversion + led - 1);
+    
+    return (value << shift) & 0x3FFFF;
+}
+
+/**
+ * @brief     push one sample into the fifo
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @param[in] *value pointer to the 18 bits value of each slot
+ * @param[in] slots number of active slots
+ * @note      a full fifo drops the sample, or the oldest one with roll over enabled
+ */
+static void a_max30105_sim_push(max30105_sim_t *sim, uint32_t *value, uint8_t slots)
+{
+    uint8_t i;
+    uint8_t write_point;
+    uint8_t level;
+    
+    level = max30105_sim_get_fifo_level(sim);
+    if (level == 32)
+    {
+        sim->lost++;
+        if ((sim->reg[0x05] & 0x1F) < 0x1F)
+        {
+            sim->reg[0x05]++;
+        }
+        if ((sim->reg[0x08] & (1 << 4)) == 0)
+        {
+            return;
+        }
+        
+        /* roll over drops the oldest sample */
+        sim->reg[0x06] = (sim->reg[0x06] + 1) & 0x1F;
+        sim->fifo_byte = 0;
+        level = 31;
+    }
+    
+    /* store the sample left justified in 18 bits */
+    write_point = sim->reg[0x04] & 0x1F;
+    for (i = 0; i < slots; i++)
+    {
+        sim->fifo[write_point][i * 3 + 0] = (value[i] >> 16) & 0x03;
+        sim->fifo[write_point][i * 3 + 1] = (value[i] >> 8) & 0xFF;
+        sim->fifo[write_point][i * 3 + 2] = (value[i] >> 0) & 0xFF;
+    }
+    sim->reg[0x04] = (write_point + 1) & 0x1F;
+    if (level == 31)
+    {
+        sim->fifo_full = 1;
+    }
+    sim->pushed++;
+    
+    /* set the data ready and almost full flags */
+    sim->reg[0x00] |= 1 << MAX30105_INTERRUPT_STATUS_DATA_RDY;
+    if ((level + 1) == (32 - (sim->reg[0x08] & 0xF)))
+    {
+        sim->reg[0x00] |= 1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL;
+    }
+}
+
+/**
+ * @brief     run one conversion
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      none
+ */
+static void a_max30105_sim_convert(max30105_sim_t *sim)
+{
+    uint8_t i;
+    uint8_t slots;
+    uint8_t average;
+    uint8_t shift;
+    uint8_t led[4];
+    uint32_t value[4];
+    
+    /* shutdown stops the conversions */
+    slots = a_max30105_sim_slots(sim, led);
+    if (((sim->reg[0x09] & (1 << 7)) != 0) || (slots == 0))
+    {
+        return;
+    }
+    sim->conversion++;
+    
+    /* the proximity mode waits for the ir threshold */
+    if (sim->prox_armed != 0)
+    {
+        if ((a_max30105_sim_signal(sim, MAX30105_LED_IR_LED2_PA) >> 10) <= sim->reg[0x30])
+        {
+            return;
+        }
+        sim->prox_armed = 0;
+        sim->reg[0x00] |= 1 << MAX30105_INTERRUPT_STATUS_PROX_INT;
+    }
+    if (sim->alc_overflow != 0)
+    {
+        sim->reg[0x00] |= 1 << MAX30105_INTERRUPT_STATUS_ALC_OVF;
+    }
+    
+    /* average the conversions */
+    for (i = 0; i < slots; i++)
+    {
+        sim->average[i] += a_max30105_sim_signal(sim, led[i]);
+    }
+    sim->average_count++;
+    average = (sim->reg[0x08] >> 5) & 0x7;
+    average = (average > 5) ? 5 : average;
+    if (sim->average_count < (1 << average))
+    {
+        return;
+    }
+    shift = 3 - (sim->reg[0x0A] & 0x3);
+    for (i = 0; i < slots; i++)
+    {
+        value[i] = ((sim->average[i] >> average) >> shift) << shift;
+    }
+    sim->average_count = 0;
+    memset(sim->average, 0, sizeof(uint32_t) * 4);
+    a_max30105_sim_push(sim, value, slots);
+}
+
+/**
+ * @brief     read one fifo data byte
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @return    data byte
+ * @note      the read pointer advances after the last byte of a sample even on an empty fifo,
+ *            like the chip that only compares the pointers
+ */
+static uint8_t a_max30105_sim_fifo_byte(max30105_sim_t *sim)
+{
+    uint8_t data;
+    uint8_t slots;
+    uint8_t led[4];
+    
+    slots = a_max30105_sim_slots(sim, led);
+    if (slots == 0)
+    {
+        return 0;
+    }
+    data = sim->fifo[sim->reg[0x06] & 0x1F][sim->fifo_byte];
+    sim->fifo_byte++;
+    if (sim->fifo_byte >= slots * 3)
+    {
+        sim->fifo_byte = 0;
+        sim->reg[0x06] = (sim->reg[0x06] + 1) & 0x1F;
+        sim->reg[0x05] = 0;
+        sim->fifo_full = 0;
+    }
+    sim->reg[0x00] &= ~((1 << MAX30105_INTERRUPT_STATUS_FIFO_FULL) | (1 << MAX30105_INTERRUPT_STATUS_DATA_RDY));
+    
+    return data;
+}
+
+/**
+ * @brief     write one register
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @param[in] reg register address
+ * @param[in] data written data
+ * @note      read only registers ignore the write
+ */
+static void a_max30105_sim_write_reg(max30105_sim_t *sim, uint8_t reg, uint8_t data)
+{
+    uint8_t prev;
+    
+    switch (reg)
+    {
+        case 0x00 :
+        case 0x01 :
+        case 0x07 :
+        case 0x1F :
+        case 0x20 :
+        case 0xFE :
+        case 0xFF :
+        {
+            break;
+        }
+        case 0x02 :
+        {
+            sim->reg[reg] = data & 0xF0;
+            sim->prox_armed = ((data & (1 << MAX30105_INTERRUPT_PROX_INT_EN)) != 0) ? 1 : 0;
+            
+            break;
+        }
+        case 0x03 :
+        {
+            sim->reg[reg] = data & 0x02;
+            
+            break;
+        }
+        case 0x04 :
+        case 0x05 :
+        case 0x06 :
+        {
+            sim->reg[reg] = data & 0x1F;
+            sim->fifo_full = 0;
+            sim->fifo_byte = 0;
+            
+            break;
+        }
+        case 0x08 :
+        {
+            sim->reg[reg] = data;
+            sim->average_count = 0;
+            memset(sim->average, 0, sizeof(uint32_t) * 4);
+            
+            break;
+        }
+        case 0x09 :
+        {
+            if ((data & (1 << 6)) != 0)
+            {
+                a_max30105_sim_reset(sim);
+            }
+            else
+            {
+                prev = sim->reg[reg];
+                sim->reg[reg] = data & 0x87;
+                if (prev != sim->reg[reg])
+                {
+                    a_max30105_sim_restart(sim);
+                }
+            }
+            
+            break;
+        }
+        case 0x0A :
+        {
+            prev = sim->reg[reg];
+            sim->reg[reg] = data & 0x7F;
+            if (prev != sim->reg[reg])
+            {
+                a_max30105_sim_restart(sim);
+            }
+            
+            break;
+        }
+        case 0x21 :
+        {
+            sim->reg[reg] = data & 0x01;
+            if (((data & 0x01) != 0) && (sim->temp_done == 0))
+            {
+                sim->temp_done = sim->now + MAX30105_SIM_TEMP_CONVERSION;
+            }
+            
+            break;
+        }
+        default :
+        {
+            sim->reg[reg] = data;
+            
+            break;
+        }
+    }
+}
+
+/**
+ * @brief     read one register
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @param[in] reg register address
+ * @return    register data
+ * @note      the interrupt status registers clear on read
+ */
+static uint8_t a_max30105_sim_read_reg(max30105_sim_t *sim, uint8_t reg)
+{
+    uint8_t data;
+    
+    if (reg == 0x07)
+    {
+        return a_max30105_sim_fifo_byte(sim);
+    }
+    data = sim->reg[reg];
+    if (reg <= 0x01)
+    {
+        sim->reg[reg] = 0;
+    }
+    
+    return data;
+}
+
+/**
+ * @brief     power on the simulator
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      the virtual time starts at 0, all registers hold their power on values
+ *            and the power ready flag is set
+ */
+void max30105_sim_init(max30105_sim_t *sim)
+{
+    memset(sim, 0, sizeof(max30105_sim_t));
+    sim->temperature = 25 * 16;
+    a_max30105_sim_reset(sim);
+    sim->reg[0x00] = 1 << MAX30105_INTERRUPT_STATUS_PWR_RDY;
+}
+
+/**
+ * @brief     link a handle to the simulator
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      links the bus, delay, debug print and receive callback functions,
+ *            delays advance the virtual time and run the irq handler while INT is asserted
+ */
+void max30105_sim_link(max30105_handle_t *handle, max30105_sim_t *sim)
+{
+    DRIVER_MAX30105_LINK_INIT(handle, max30105_handle_t);
+    DRIVER_MAX30105_LINK_USER(handle, sim);
+    DRIVER_MAX30105_LINK_IIC_INIT_CTX(handle, max30105_sim_iic_init);
+    DRIVER_MAX30105_LINK_IIC_DEINIT_CTX(handle, max30105_sim_iic_deinit);
+    DRIVER_MAX30105_LINK_IIC_READ_CTX(handle, max30105_sim_iic_read);
+    DRIVER_MAX30105_LINK_IIC_WRITE_CTX(handle, max30105_sim_iic_write);
+    DRIVER_MAX30105_LINK_IIC_TRANSFER_CTX(handle, max30105_sim_iic_transfer);
+    DRIVER_MAX30105_LINK_DELAY_MS_CTX(handle, max30105_sim_delay_ms);
+    DRIVER_MAX30105_LINK_DEBUG_PRINT(handle, max30105_interface_debug_print);
+    DRIVER_MAX30105_LINK_RECEIVE_CALLBACK_CTX(handle, max30105_sim_receive_callback);
+    sim->irq_handle = handle;
+}
+
+/**
+ * @brief     advance the virtual time
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @param[in] ns elapsed time in ns
+ * @note      runs every conversion and die temperature measurement that ends meanwhile
+ */
+void max30105_sim_advance(max30105_sim_t *sim, uint64_t ns)
+{
+    uint64_t end;
+    
+    end = sim->now + ns;
+    while (1)
+    {
+        /* the die temperature is ready */
+        if ((sim->temp_done != 0) && (sim->temp_done <= sim->next) && (sim->temp_done <= end))
+        {
+            sim->now = sim->temp_done;
+            sim->temp_done = 0;
+            sim->reg[0x1F] = (uint8_t)(sim->temperature >> 4);
+            sim->reg[0x20] = (uint8_t)(sim->temperature & 0xF);
+            sim->reg[0x21] &= ~0x01;
+            sim->reg[0x01] |= 1 << MAX30105_INTERRUPT_STATUS_DIE_TEMP_RDY;
+            
+            continue;
+        }
+        
+        /* the next conversion ends */
+        if (sim->next > end)
+        {
+            break;
+        }
+        sim->now = sim->next;
+        sim->next += a_max30105_sim_period(sim);
+        a_max30105_sim_convert(sim);
+    }
+    sim->now = end;
+}
+
+/**
+ * @brief     get the INT line
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @return    1 when asserted, 0 when released
+ * @note      none
+ */
+uint8_t max30105_sim_get_interrupt(max30105_sim_t *sim)
+{
+    if (((sim->reg[0x00] & (sim->reg[0x02] | (1 << MAX30105_INTERRUPT_STATUS_PWR_RDY))) != 0) ||
+        ((sim->reg[0x01] & sim->reg[0x03]) != 0))
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     get the fifo level
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @return    number of unread samples
+ * @note      none
+ */
+uint8_t max30105_sim_get_fifo_level(max30105_sim_t *sim)
+{
+    uint8_t write_point;
+    uint8_t read_point;
+    
+    write_point = sim->reg[0x04] & 0x1F;
+    read_point = sim->reg[0x06] & 0x1F;
+    if (write_point != read_point)
+    {
+        return (write_point - read_point) & 0x1F;
+    }
+    
+    return (sim->fifo_full != 0) ? 32 : 0;
+}
+
+/**
+ * @brief     simulated iic bus init
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t max30105_sim_iic_init(void *user)
+{
+    (void)user;
+    
+    return 0;
+}
+
+/**
+ * @brief     simulated iic bus deinit
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t max30105_sim_iic_deinit(void *user)
+{
+    (void)user;
+    
+    return 0;
+}
+
+/**
+ * @brief      simulated iic bus read
+ * @param[in]  *user pointer to a max30105 simulator structure
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no device answered
+ * @note       none
+ */
+uint8_t max30105_sim_iic_read(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    max30105_sim_t *sim = (max30105_sim_t *)user;
+    
+    if (addr != MAX30105_SIM_ADDRESS)
+    {
+        return 1;
+    }
+    
+    /* address, register and address bytes */
+    max30105_sim_advance(sim, 3 * (uint64_t)sim->byte_time);
+    sim->read_count++;
+    sim->byte_count += len + 3;
+    for (i = 0; i < len; i++)
+    {
+        /* the chip keeps converting while the bytes are clocked out */
+        max30105_sim_advance(sim, sim->byte_time);
+        buf[i] = a_max30105_sim_read_reg(sim, reg);
+        
+        /* the fifo data register doesn't auto increment */
+        if (reg != 0x07)
+        {
+            reg++;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     simulated iic bus write
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 no device answered
+ * @note      none
+ */
+uint8_t max30105_sim_iic_write(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    max30105_sim_t *sim = (max30105_sim_t *)user;
+    
+    if (addr != MAX30105_SIM_ADDRESS)
+    {
+        return 1;
+    }
+    
+    /* address and register bytes */
+    max30105_sim_advance(sim, 2 * (uint64_t)sim->byte_time);
+    sim->write_count++;
+    sim->byte_count += len + 2;
+    for (i = 0; i < len; i++)
+    {
+        max30105_sim_advance(sim, sim->byte_time);
+        a_max30105_sim_write_reg(sim, (uint8_t)(reg + i), buf[i]);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief         simulated iic bus batch transfer
+ * @param[in]     *user pointer to a max30105 simulator structure
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 no device answered
+ * @note          counts as one bus transaction
+ */
+uint8_t max30105_sim_iic_transfer(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    uint8_t i;
+    uint8_t res;
+    uint32_t read_count;
+    uint32_t write_count;
+    max30105_sim_t *sim = (max30105_sim_t *)user;
+    
+    read_count = sim->read_count;
+    write_count = sim->write_count;
+    res = 0;
+    for (i = 0; i < num; i++)
+    {
+        if (transfer[i].read != 0)
+        {
+            res |= max30105_sim_iic_read(user, addr, transfer[i].reg, transfer[i].buf, transfer[i].len);
+        }
+        else
+        {
+            res |= max30105_sim_iic_write(user, addr, transfer[i].reg, transfer[i].buf, transfer[i].len);
+        }
+    }
+    sim->read_count = read_count;
+    sim->write_count = write_count;
+    sim->transfer_count++;
+    
+    return (res != 0) ? 1 : 0;
+}
+
+/**
+ * @brief     simulated delay ms
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @param[in] ms time
+ * @note      advances the virtual time
+ */
+void max30105_sim_delay_ms(void *user, uint32_t ms)
+{
+    max30105_sim_t *sim = (max30105_sim_t *)user;
+    
+    max30105_sim_advance(sim, (uint64_t)ms * 1000000ULL);
+    
+    /* the INT line runs the irq handler */
+    if ((sim->irq_handle != NULL) && (max30105_sim_get_interrupt(sim) != 0))
+    {
+        (void)max30105_irq_handler(sim->irq_handle);
+    }
+}
+
+/**
+ * @brief     simulated receive callback
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @param[in] type irq type
+ * @note      counts the irq types
+ */
+void max30105_sim_receive_callback(void *user, uint8_t type)
+{
+    max30105_sim_t *sim = (max30105_sim_t *)user;
+    
+    if (type < 8)
+    {
+        sim->irq_count[type]++;
+    }
+}
@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_sim.h
+ * @brief     driver max30105 simulator header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_MAX30105_SIM_H
+#define DRIVER_MAX30105_SIM_H
+
+#include "driver_max30105_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup max30105_test_driver
+ * @{
+ */
+
+/**
+ * @brief max30105 simulator definition
+ */
+#define MAX30105_SIM_ADDRESS             0xAE              /**< iic device write address */
+#define MAX30105_SIM_PART_ID             0x15              /**< part id */
+#define MAX30105_SIM_TEMP_CONVERSION     29000000ULL       /**< die temperature conversion time in ns */
+
+/**
+ * @brief max30105 simulator structure definition
+ */
+typedef struct max30105_sim_s
+{
+    uint8_t reg[256];                                                       /**< register map */
+    uint8_t fifo[32][12];                                                   /**< fifo samples of up to four slots */
+    uint8_t fifo_full;                                                      /**< fifo holds 32 samples and the pointers are equal */
+    uint8_t fifo_byte;                                                      /**< byte index in the sample being read */
+    uint8_t prox_armed;                                                     /**< waiting for the proximity threshold */
+    uint8_t average_count;                                                  /**< conversions in the running average */
+    uint32_t average[4];                                                    /**< conversion sums of each slot */
+    uint64_t now;                                                           /**< virtual time in ns */
+    uint64_t next;                                                          /**< time of the next conversion in ns */
+    uint64_t temp_done;                                                     /**< end of the die temperature conversion, 0 when idle */
+    uint64_t conversion;                                                    /**< conversion counter */
+    uint64_t pushed;                                                        /**< samples pushed into the fifo */
+    uint64_t lost;                                                          /**< samples dropped or overwritten by a full fifo */
+    int32_t ppm;                                                            /**< sample clock error in ppm */
+    int16_t temperature;                                                    /**< die temperature in 1/16 degree */
+    uint8_t alc_overflow;                                                   /**< ambient light cancellation saturated */
+    uint32_t byte_time;                                                     /**< bus time of one byte in ns, 0 for an ideal bus */
+    uint32_t (*signal)(void *user, uint8_t led, uint64_t time);             /**< optional optical signal returning 18 bits adc counts */
+    void *signal_user;                                                      /**< user context passed to signal */
+    max30105_handle_t *irq_handle;                                          /**< handle whose irq handler the INT line runs during delays */
+    uint32_t read_count;                                                    /**< bus read transaction counter */
+    uint32_t write_count;                                                   /**< bus write transaction counter */
+    uint32_t transfer_count;                                                /**< bus batch transfer counter */
+    uint64_t byte_count;                                                    /**< bus byte counter */
+    uint32_t irq_count[8];                                                  /**< receive callback counter of each irq type */
+} max30105_sim_t;
+
+/**
+ * @brief     power on the simulator
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      the virtual time starts at 0, all registers hold their power on values
+ *            and the power ready flag is set
+ */
+void max30105_sim_init(max30105_sim_t *sim);
+
+/**
+ * @brief     link a handle to the simulator
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      links the bus, delay, debug print and receive callback functions,
+ *            delays advance the virtual time and run the irq handler while INT is asserted
+ */
+void max30105_sim_link(max30105_handle_t *handle, max30105_sim_t *sim);
+
+/**
+ * @brief     advance the virtual time
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @param[in] ns elapsed time in ns
+ * @note      runs every conversion and die temperature measurement that ends meanwhile
+ */
+void max30105_sim_advance(max30105_sim_t *sim, uint64_t ns);
+
+/**
+ * @brief     get the INT line
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @return    1 when asserted, 0 when released
+ * @note      none
+ */
+uint8_t max30105_sim_get_interrupt(max30105_sim_t *sim);
+
+/**
+ * @brief     get the fifo level
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @return    number of unread samples
+ * @note      none
+ */
+uint8_t max30105_sim_get_fifo_level(max30105_sim_t *sim);
+
+/**
+ * @brief     simulated iic bus init
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t max30105_sim_iic_init(void *user);
+
+/**
+ * @brief     simulated iic bus deinit
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t max30105_sim_iic_deinit(void *user);
+
+/**
+ * @brief      simulated iic bus read
+ * @param[in]  *user pointer to a max30105 simulator structure
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no device answered
+ * @note       none
+ */
+uint8_t max30105_sim_iic_read(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     simulated iic bus write
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 no device answered
+ * @note      none
+ */
+uint8_t max30105_sim_iic_write(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief         simulated iic bus batch transfer
+ * @param[in]     *user pointer to a max30105 simulator structure
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 no device answered
+ * @note          counts as one bus transaction
+ */
+uint8_t max30105_sim_iic_transfer(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num);
+
+/**
+ * @brief     simulated delay ms
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @param[in] ms time
+ * @note      advances the virtual time
+ */
+void max30105_sim_delay_ms(void *user, uint32_t ms);
+
+/**
+ * @brief     simulated receive callback
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @param[in] type irq type
+ * @note      counts the irq types
+ */
+void max30105_sim_receive_callback(void *user, uint8_t type);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,554 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_sim_test.c
+ * @brief     driver max30105 simulator test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_sim_test.h"
+#include "driver_max30105_sim.h"
+
+static max30105_handle_t gs_handle;        /**< max30105 handle */
+static max30105_sim_t gs_sim;              /**< max30105 simulator */
+static max30105_sample_t gs_sample[32];    /**< sample buffer */
+
+#if (MAX30105_STATS != 0)
+/**
+ * @brief     simulated timestamp
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @return    virtual time in ns
+ * @note      none
+ */
+static uint64_t a_sim_test_timestamp(void *user)
+{
+    return ((max30105_sim_t *)user)->now;
+}
+#endif
+
+/**
+ * @brief      stream the fifo with deadline polling
+ * @param[in]  ns streaming time in ns
+ * @param[in]  step red step between two samples
+ * @param[in]  rate fifo sample rate in Hz
+ * @param[out] *count pointer to a sample counter
+ * @return     status code
+ *             - 0 success
+ *             - 1 stream failed
+ * @note       the default signal makes the red channel a ramp, every sample must continue it
+ *             and every sample pushed at the rate must reach the host or still be in the fifo,
+ *             samples converted while draining count from the start
+ */
+static uint8_t a_sim_test_stream(uint64_t ns, uint32_t step, uint32_t rate, uint32_t *count)
+{
+    uint8_t res;
+    uint8_t len;
+    uint8_t i;
+    uint8_t valid;
+    uint32_t red;
+    uint64_t start;
+    uint64_t end;
+    uint64_t expect;
+    uint64_t pushed;
+    uint64_t lost;
+    uint64_t deadline;
+    
+    /* drain the fifo */
+    len = 32;
+    res = max30105_read_samples(&gs_handle, gs_sample, &len);
+    if ((res != 0) && (res != 4))
+    {
+        max30105_interface_debug_print("max30105: read samples failed.\n");
+        
+        return 1;
+    }
+    
+    /* poll at the deadlines */
+    valid = 0;
+    red = 0;
+    *count = 0;
+    pushed = gs_sim.pushed - max30105_sim_get_fifo_level(&gs_sim);
+    lost = gs_sim.lost;
+    start = gs_sim.now;
+    end = start + ns;
+    while (1)
+    {
+        len = 32;
+        res = max30105_poll(&gs_handle, gs_sim.now, gs_sample, &len, &deadline);
+        if ((res != 0) && (res != 4))
+        {
+            max30105_interface_debug_print("max30105: poll failed.\n");
+            
+            return 1;
+        }
+        for (i = 0; i < len; i++)
+        {
+            if (((gs_sample[i].flags & MAX30105_SAMPLE_FLAG_OVERFLOW_GAP) != 0) ||
+                ((valid != 0) && (gs_sample[i].red != ((red + step) & 0x7FFF))))
+            {
+                max30105_interface_debug_print("max30105: check ramp error.\n");
+                
+                return 1;
+            }
+            red = gs_sample[i].red;
+            valid = 1;
+        }
+        *count += len;
+        if (gs_sim.now >= end)
+        {
+            break;
+        }
+        if (deadline > end)
+        {
+            deadline = end;
+        }
+        if (deadline > gs_sim.now)
+        {
+            max30105_sim_advance(&gs_sim, deadline - gs_sim.now);
+        }
+    }
+    
+    /* nothing may be lost */
+    pushed = gs_sim.pushed - pushed;
+    expect = ((gs_sim.now - start) * rate) / 1000000000ULL;
+    if ((gs_sim.lost != lost) || (*count + max30105_sim_get_fifo_level(&gs_sim) != pushed) ||
+        (pushed + 1 < expect) || (pushed > expect + 2))
+    {
+        max30105_interface_debug_print("max30105: check streamed samples error.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      read the newest sample
+ * @param[out] *red pointer to a red buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the fifo is drained
+ */
+static uint8_t a_sim_test_newest(uint32_t *red)
+{
+    uint8_t res;
+    uint8_t len;
+    
+    len = 32;
+    res = max30105_read_samples(&gs_handle, gs_sample, &len);
+    if (((res != 0) && (res != 4)) || (len == 0))
+    {
+        max30105_interface_debug_print("max30105: read samples failed.\n");
+        
+        return 1;
+    }
+    *red = gs_sample[len - 1].red;
+    
+    return 0;
+}
+
+/**
+ * @brief     overflow the fifo by 8 samples
+ * @param[in] roll bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the fifo keeps the oldest 32 samples, or the newest 32 with roll over,
+ *            and the driver reports the 8 lost samples
+ */
+static uint8_t a_sim_test_overflow(max30105_bool_t roll)
+{
+    uint8_t res;
+    uint8_t len;
+    uint8_t i;
+    uint8_t counter;
+    uint32_t red;
+    uint32_t first;
+    uint32_t lost;
+    
+    res = max30105_set_fifo_roll(&gs_handle, roll);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        
+        return 1;
+    }
+    
+    /* one sample 1ms after the restart */
+    res = max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_PARTICLE_SENSING_SAMPLE_RATE_50_HZ);
+    res |= max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_PARTICLE_SENSING_SAMPLE_RATE_1000_HZ);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set particle sensing sample rate failed.\n");
+        
+        return 1;
+    }
+    len = 32;
+    (void)max30105_read_samples(&gs_handle, gs_sample, &len);
+    max30105_sim_advance(&gs_sim, 1500000ULL);
+    if (a_sim_test_newest(&red) != 0)
+    {
+        return 1;
+    }
+    
+    /* 40 samples into a 32 samples fifo */
+    max30105_sim_advance(&gs_sim, 40000000ULL);
+    res = max30105_get_fifo_overflow_counter(&gs_handle, &counter);
+    if ((res != 0) || (counter != 8))
+    {
+        max30105_interface_debug_print("max30105: check overflow counter error.\n");
+        
+        return 1;
+    }
+    len = 32;
+    res = max30105_read_samples(&gs_handle, gs_sample, &len);
+    first = (roll == MAX30105_BOOL_TRUE) ? (red + 9) : (red + 1);
+    if (((res != 0) && (res != 4)) || (len != 32) || (gs_sample[0].red != first) || (gs_sample[31].red != first + 31))
+    {
+        max30105_interface_debug_print("max30105: check kept samples error.\n");
+        
+        return 1;
+    }
+    lost = 0;
+    for (i = 0; i < len; i++)
+    {
+        lost += gs_sample[i].lost;
+    }
+    
+    /* the next sample follows the lost ones */
+    max30105_sim_advance(&gs_sim, 1000000ULL);
+    len = 32;
+    res = max30105_read_samples(&gs_handle, gs_sample, &len);
+    if (((res != 0) && (res != 4)) || (len != 1) || (gs_sample[0].red != red + 41))
+    {
+        max30105_interface_debug_print("max30105: check next sample error.\n");
+        
+        return 1;
+    }
+    lost += gs_sample[0].lost;
+    if (lost != 8)
+    {
+        max30105_interface_debug_print("max30105: check lost samples error.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  sim test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   runs against the register level simulator on a virtual clock and needs no chip
+ */
+uint8_t max30105_sim_test(void)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t id;
+    uint16_t raw;
+    uint32_t count;
+    uint32_t expect;
+    uint32_t ms;
+    uint32_t transactions;
+    uint64_t bytes;
+    uint64_t start;
+    float temp;
+    const uint32_t rate[8] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+    
+    /* power on the simulator behind a 400khz bus */
+    max30105_sim_init(&gs_sim);
+    gs_sim.byte_time = 22500;
+    max30105_sim_link(&gs_handle, &gs_sim);
+    
+    /* start sim test */
+    max30105_interface_debug_print("max30105: start sim test.\n");
+    
+    /* init the max30105 */
+    res = max30105_init(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: init failed.\n");
+       
+        return 1;
+    }
+    
+    /* set red mode */
+    res = max30105_set_mode(&gs_handle, MAX30105_MODE_RED);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set mode failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set 15 bits */
+    res = max30105_set_adc_resolution(&gs_handle, MAX30105_ADC_RESOLUTION_15_BIT);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set adc resolution failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* every sample rate */
+    max30105_interface_debug_print("max30105: stream every sample rate for 1s.\n");
+    for (i = 0; i < 8; i++)
+    {
+        res = max30105_set_particle_sensing_sample_rate(&gs_handle, (max30105_particle_sensing_sample_rate_t)i);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: set particle sensing sample rate failed.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        transactions = gs_sim.read_count + gs_sim.write_count + gs_sim.transfer_count;
+        bytes = gs_sim.byte_count;
+        if (a_sim_test_stream(1000000000ULL, 1, rate[i], &count) != 0)
+        {
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        max30105_interface_debug_print("max30105: %dHz streamed %d samples in %d transactions and %d bus bytes.\n",
+                                       rate[i], count, gs_sim.read_count + gs_sim.write_count + gs_sim.transfer_count - transactions,
+                                       (int)(gs_sim.byte_count - bytes));
+    }
+    max30105_interface_debug_print("max30105: check sample rates ok.\n");
+    
+    /* averaging 4 */
+    max30105_interface_debug_print("max30105: averaging 4 at 400Hz.\n");
+    res = max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_PARTICLE_SENSING_SAMPLE_RATE_400_HZ);
+    res |= max30105_set_fifo_sample_averaging(&gs_handle, MAX30105_SAMPLE_AVERAGING_4);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo sample averaging failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((a_sim_test_stream(1000000000ULL, 4, 100, &count) != 0))
+    {
+        max30105_interface_debug_print("max30105: check averaging error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = max30105_set_fifo_sample_averaging(&gs_handle, MAX30105_SAMPLE_AVERAGING_1);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo sample averaging failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check averaging ok.\n");
+    
+    /* fifo overflow on an ideal bus */
+    gs_sim.byte_time = 0;
+    max30105_interface_debug_print("max30105: fifo overflow without roll over.\n");
+    if (a_sim_test_overflow(MAX30105_BOOL_FALSE) != 0)
+    {
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: fifo overflow with roll over.\n");
+    if (a_sim_test_overflow(MAX30105_BOOL_TRUE) != 0)
+    {
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = max30105_set_fifo_roll(&gs_handle, MAX30105_BOOL_FALSE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set fifo roll failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check fifo overflow ok.\n");
+    
+    /* die temperature */
+    max30105_interface_debug_print("max30105: die temperature.\n");
+    gs_sim.temperature = 30 * 16 + 4;
+    start = gs_sim.now;
+    res = max30105_read_temperature(&gs_handle, &raw, &temp);
+    if ((res != 0) || (temp != 30.25f) || (gs_sim.now - start < MAX30105_SIM_TEMP_CONVERSION))
+    {
+        max30105_interface_debug_print("max30105: check die temperature error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: die temperature is %0.2fC after %dms.\n", temp,
+                                   (int)((gs_sim.now - start) / 1000000ULL));
+    max30105_interface_debug_print("max30105: check die temperature ok.\n");
+    
+    /* almost full interrupt */
+    max30105_interface_debug_print("max30105: almost full interrupt at 1000Hz.\n");
+    res = max30105_set_fifo_almost_full(&gs_handle, 0xF);
+    res |= max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_FIFO_FULL_EN, MAX30105_BOOL_TRUE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set interrupt failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_sim_test_newest(&count) != 0)
+    {
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    memset(gs_sim.irq_count, 0, sizeof(uint32_t) * 8);
+    for (ms = 0; ms < 100; ms++)
+    {
+        max30105_sim_delay_ms(&gs_sim, 1);
+        if (gs_sim.irq_count[MAX30105_INTERRUPT_STATUS_FIFO_FULL] != 0)
+        {
+            break;
+        }
+    }
+    expect = 32 - 0xF;
+    if ((ms + 1 < expect) || (ms > expect + 1) || (max30105_sim_get_interrupt(&gs_sim) != 0))
+    {
+        max30105_interface_debug_print("max30105: check interrupt error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_FIFO_FULL_EN, MAX30105_BOOL_FALSE);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set interrupt failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: interrupt after %dms.\n", ms + 1);
+    max30105_interface_debug_print("max30105: check interrupt ok.\n");
+    
+#if (MAX30105_STATS != 0)
+    /* statistics */
+    max30105_interface_debug_print("max30105: statistics at 1000Hz.\n");
+    {
+        max30105_stats_t stats;
+        uint32_t bus;
+        
+        gs_sim.byte_time = 22500;
+        DRIVER_MAX30105_LINK_TIMESTAMP_CTX(&gs_handle, a_sim_test_timestamp);
+        if (a_sim_test_newest(&count) != 0)
+        {
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        res = max30105_clear_stats(&gs_handle);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: clear stats failed.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        bus = gs_sim.read_count + gs_sim.write_count + gs_sim.transfer_count;
+        if (a_sim_test_stream(1000000000ULL, 1, 1000, &count) != 0)
+        {
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        bus = gs_sim.read_count + gs_sim.write_count + gs_sim.transfer_count - bus;
+        res = max30105_get_stats(&gs_handle, &stats);
+        if (res != 0)
+        {
+            max30105_interface_debug_print("max30105: get stats failed.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        
+        /* only the first drain is a read samples call of its own, the reads in the polls are nested */
+        max30105_interface_debug_print("max30105: %d polls took %dus on the bus, %dus at most.\n", stats.api[MAX30105_API_POLL].calls,
+                                       (int)(stats.api[MAX30105_API_POLL].ns / 1000), (int)(stats.api[MAX30105_API_POLL].max_ns / 1000));
+        if ((stats.samples < count) || (stats.samples > count + 1) || (stats.iic_read + stats.iic_write + stats.iic_transfer != bus) ||
+            (stats.iic_failed != 0) || (stats.overflows != 0) || (stats.read_bytes < count * 3) ||
+            (stats.api[MAX30105_API_POLL].calls == 0) || (stats.api[MAX30105_API_POLL].ns == 0) ||
+            (stats.api[MAX30105_API_READ_SAMPLES].calls != 1) || (stats.api[MAX30105_API_READ_FIFO_RAW].calls != 0))
+        {
+            max30105_interface_debug_print("max30105: check stats error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        
+        /* the data ready flag of the last sample */
+        memset(gs_sim.irq_count, 0, sizeof(uint32_t) * 8);
+        max30105_sim_advance(&gs_sim, 1000000ULL);
+        res = max30105_irq_handler(&gs_handle);
+        res |= max30105_get_stats(&gs_handle, &stats);
+        if ((res != 0) || (stats.api[MAX30105_API_IRQ_HANDLER].calls != 1) ||
+            (stats.irq[MAX30105_INTERRUPT_STATUS_DATA_RDY] != 1) ||
+            (memcmp(stats.irq, gs_sim.irq_count, sizeof(uint32_t) * 8) != 0))
+        {
+            max30105_interface_debug_print("max30105: check irq stats error.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    max30105_interface_debug_print("max30105: check stats ok.\n");
+#endif
+    
+    /* other addresses don't answer */
+    if (max30105_sim_iic_read(&gs_sim, 0xB0, 0xFF, &id, 1) == 0)
+    {
+        max30105_interface_debug_print("max30105: check address error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish sim test */
+    max30105_interface_debug_print("max30105: finish sim test.\n");
+    (void)max30105_deinit(&gs_handle);
+    
+    return 0;
+}
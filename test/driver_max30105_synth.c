@@ -0,0 +1,397 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_synth.c
+ * @brief     driver max30105 optical signal synthesis source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_synth.h"
+#include <math.h>
+
+/**
+ * @brief synth definition
+ */
+#define MAX30105_SYNTH_PI            3.14159265f        /**< pi */
+#define MAX30105_SYNTH_LED_STEP      0.2f               /**< led current of one amplitude step in mA */
+
+/**
+ * @brief synth sample state structure definition
+ */
+typedef struct max30105_synth_state_s
+{
+    float pulse;              /**< pulse shape from 0 to 1 */
+    float gain;               /**< motion coupling gain */
+    float ambient;            /**< ambient light left after the cancellation in nA */
+    float smoke;              /**< particle scatter in nA per mA */
+    uint8_t saturated;        /**< every channel reads full scale */
+} max30105_synth_state_t;
+
+/**
+ * @brief     get a gaussian noise value
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @return    noise with unit variance
+ * @note      sum of four xorshift uniforms
+ */
+static float a_max30105_synth_noise(max30105_synth_t *synth)
+{
+    uint8_t i;
+    uint32_t x;
+    uint32_t sum;
+    
+    x = synth->seed;
+    sum = 0;
+    for (i = 0; i < 4; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        sum += x >> 16;
+    }
+    synth->seed = x;
+    
+    return ((float)sum / 65536.0f - 2.0f) * 1.7320508f;
+}
+
+/**
+ * @brief      get the state shared by the channels
+ * @param[in]  *synth pointer to a max30105 synth structure
+ * @param[in]  time time in ns
+ * @param[out] *state pointer to a sample state structure
+ * @note       the pulse phase comes straight from the time, so any time can be asked in any order
+ */
+static void a_max30105_synth_state(max30105_synth_t *synth, uint64_t time, max30105_synth_state_t *state)
+{
+    uint8_t i;
+    uint32_t phase;
+    uint32_t index;
+    uint64_t step;
+    uint64_t elapsed;
+    float frac;
+    float ambient;
+    float transient;
+    max30105_synth_event_t *event;
+    
+    /* beats per ns in 2^64 units, the wrapped product is the phase */
+    step = (uint64_t)((double)synth->heart_rate * (18446744073709551616.0 / 60e9));
+    phase = (uint32_t)((time * step) >> 32);
+    index = phase >> 24;
+    frac = (float)((phase >> 8) & 0xFFFF) / 65536.0f;
+    state->pulse = synth->pulse[index] + (synth->pulse[index + 1] - synth->pulse[index]) * frac;
+    state->gain = 1.0f;
+    state->smoke = 0.0f;
+    state->saturated = 0;
+    ambient = 0.0f;
+    transient = 0.0f;
+    
+    /* events */
+    for (i = 0; i < synth->event_count; i++)
+    {
+        event = &synth->event[i];
+        if (time < event->start)
+        {
+            continue;
+        }
+        elapsed = time - event->start;
+        if (event->type == MAX30105_SYNTH_EVENT_AMBIENT)
+        {
+            ambient += event->level;
+            
+            /* the cancellation settles after the step */
+            if (elapsed < 8 * MAX30105_SYNTH_ALC_TAU)
+            {
+                transient += event->level * expf(-(float)elapsed / (float)MAX30105_SYNTH_ALC_TAU);
+            }
+            
+            continue;
+        }
+        if (elapsed >= event->duration)
+        {
+            continue;
+        }
+        if (event->type == MAX30105_SYNTH_EVENT_MOTION)
+        {
+            state->gain += event->level * sinf(2.0f * MAX30105_SYNTH_PI * event->rate * (float)elapsed / 1e9f);
+        }
+        else if (event->type == MAX30105_SYNTH_EVENT_SMOKE)
+        {
+            state->smoke += event->level * 0.5f * (1.0f - cosf(2.0f * MAX30105_SYNTH_PI * (float)elapsed / (float)event->duration));
+        }
+        else
+        {
+            state->saturated = 1;
+        }
+    }
+    
+    /* the cancellation removes the ambient light up to its limit */
+    state->ambient = transient;
+    if (ambient > synth->alc_limit)
+    {
+        state->ambient += ambient - synth->alc_limit;
+    }
+    synth->alc_overflow = ((ambient > synth->alc_limit) || (state->saturated != 0)) ? 1 : 0;
+    if (synth->sim != NULL)
+    {
+        synth->sim->alc_overflow = synth->alc_overflow;
+    }
+}
+
+/**
+ * @brief     get the adc code of one channel
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @param[in] *state pointer to a sample state structure
+ * @param[in] channel 0 red, 1 ir, 2 green
+ * @param[in] amplitude led pulse amplitude
+ * @param[in] scale adc counts per nA
+ * @return    18 bits adc counts
+ * @note      the light absorbed by the arterial blood grows with the pulse,
+ *            red swings by the perfusion times the ratio
+ */
+static uint32_t a_max30105_synth_code(max30105_synth_t *synth, max30105_synth_state_t *state, uint8_t channel,
+                                      uint8_t amplitude, float scale)
+{
+    float current;
+    float perfusion;
+    float value;
+    
+    if (state->saturated != 0)
+    {
+        return 0x3FFFF;
+    }
+    current = (float)amplitude * MAX30105_SYNTH_LED_STEP;
+    perfusion = synth->perfusion / 100.0f;
+    if (channel == 0)
+    {
+        perfusion *= synth->ratio;
+    }
+    value = synth->coupling[channel] * current * (1.0f - perfusion * state->pulse) * state->gain;
+    value += state->smoke * current + state->ambient;
+    if (synth->noise != 0.0f)
+    {
+        value += synth->noise * a_max30105_synth_noise(synth);
+    }
+    value *= scale;
+    if (value <= 0.0f)
+    {
+        return 0;
+    }
+    if (value >= 262143.0f)
+    {
+        return 0x3FFFF;
+    }
+    
+    return (uint32_t)value;
+}
+
+/**
+ * @brief      get the adc settings
+ * @param[in]  *synth pointer to a max30105 synth structure
+ * @param[out] *amplitude pointer to a 3 length amplitude buffer
+ * @param[out] *scale pointer to an adc counts per nA buffer
+ * @param[out] *mask pointer to a resolution mask buffer
+ * @note       a linked simulator gives its registers
+ */
+static void a_max30105_synth_adc(max30105_synth_t *synth, uint8_t *amplitude, float *scale, uint32_t *mask)
+{
+    uint8_t range;
+    uint8_t resolution;
+    
+    if (synth->sim != NULL)
+    {
+        range = (synth->sim->reg[0x0A] >> 5) & 0x3;
+        resolution = synth->sim->reg[0x0A] & 0x3;
+        amplitude[0] = synth->sim->reg[0x0C];
+        amplitude[1] = synth->sim->reg[0x0D];
+        amplitude[2] = synth->sim->reg[0x0E];
+    }
+    else
+    {
+        range = synth->range & 0x3;
+        resolution = synth->resolution & 0x3;
+        amplitude[0] = synth->amplitude[0];
+        amplitude[1] = synth->amplitude[1];
+        amplitude[2] = synth->amplitude[2];
+    }
+    
+    /* 2048nA full scale doubles with each range step */
+    *scale = 262144.0f / (float)(2048 << range);
+    *mask = (0x3FFFFU >> (3 - resolution)) << (3 - resolution);
+}
+
+/**
+ * @brief     init the signal generator
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @note      72bpm, 2% perfusion, ratio 0.5, no noise and no events,
+ *            range 4096nA, 18 bits and 6.4mA on every led
+ */
+void max30105_synth_init(max30105_synth_t *synth)
+{
+    uint32_t i;
+    float x;
+    float min;
+    float max;
+    
+    memset(synth, 0, sizeof(max30105_synth_t));
+    synth->heart_rate = 72.0f;
+    synth->perfusion = 2.0f;
+    synth->ratio = 0.5f;
+    synth->coupling[0] = 150.0f;
+    synth->coupling[1] = 240.0f;
+    synth->coupling[2] = 60.0f;
+    synth->alc_limit = 100000.0f;
+    synth->range = MAX30105_PARTICLE_SENSING_ADC_RANGE_4096;
+    synth->resolution = MAX30105_ADC_RESOLUTION_18_BIT;
+    synth->amplitude[0] = 0x20;
+    synth->amplitude[1] = 0x20;
+    synth->amplitude[2] = 0x20;
+    synth->seed = 0x2545F491;
+    
+    /* systolic peak and dicrotic wave, scaled from 0 to 1 */
+    min = 1.0f;
+    max = 0.0f;
+    for (i = 0; i < MAX30105_SYNTH_PULSE_SIZE; i++)
+    {
+        x = (float)i / (float)MAX30105_SYNTH_PULSE_SIZE;
+        synth->pulse[i] = expf(-((x - 0.18f) / 0.07f) * ((x - 0.18f) / 0.07f)) +
+                          0.45f * expf(-((x - 0.42f) / 0.09f) * ((x - 0.42f) / 0.09f));
+        min = (synth->pulse[i] < min) ? synth->pulse[i] : min;
+        max = (synth->pulse[i] > max) ? synth->pulse[i] : max;
+    }
+    for (i = 0; i < MAX30105_SYNTH_PULSE_SIZE; i++)
+    {
+        synth->pulse[i] = (synth->pulse[i] - min) / (max - min);
+    }
+    synth->pulse[MAX30105_SYNTH_PULSE_SIZE] = synth->pulse[0];
+}
+
+/**
+ * @brief     schedule an event
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @param[in] type event type
+ * @param[in] start start time in ns
+ * @param[in] duration duration in ns
+ * @param[in] level event level
+ * @param[in] rate motion rate in Hz
+ * @return    status code
+ *            - 0 success
+ *            - 1 event table is full
+ * @note      none
+ */
+uint8_t max30105_synth_add_event(max30105_synth_t *synth, max30105_synth_event_type_t type,
+                                 uint64_t start, uint64_t duration, float level, float rate)
+{
+    max30105_synth_event_t *event;
+    
+    if (synth->event_count >= MAX30105_SYNTH_MAX_EVENT)
+    {
+        return 1;
+    }
+    event = &synth->event[synth->event_count++];
+    event->type = (uint8_t)type;
+    event->start = start;
+    event->duration = duration;
+    event->level = level;
+    event->rate = rate;
+    
+    return 0;
+}
+
+/**
+ * @brief     link the signal generator to a simulator
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      the simulator converts the signal, the adc range and the led amplitudes
+ *            come from its registers and the ambient light sets its alc overflow
+ */
+void max30105_synth_link(max30105_synth_t *synth, max30105_sim_t *sim)
+{
+    synth->sim = sim;
+    sim->signal = max30105_synth_signal;
+    sim->signal_user = synth;
+}
+
+/**
+ * @brief     get the signal of one led
+ * @param[in] *user pointer to a max30105 synth structure
+ * @param[in] led led of the slot
+ * @param[in] time time in ns
+ * @return    18 bits adc counts
+ * @note      the simulator signal function
+ */
+uint32_t max30105_synth_signal(void *user, uint8_t led, uint64_t time)
+{
+    uint8_t amplitude[3];
+    uint32_t mask;
+    float scale;
+    max30105_synth_t *synth = (max30105_synth_t *)user;
+    max30105_synth_state_t state;
+    
+    if ((led < MAX30105_LED_RED_LED1_PA) || (led > MAX30105_LED_GREEN_LED3_PA))
+    {
+        return 0;
+    }
+    a_max30105_synth_adc(synth, amplitude, &scale, &mask);
+    a_max30105_synth_state(synth, time, &state);
+    
+    return a_max30105_synth_code(synth, &state, led - 1, amplitude[led - 1], scale);
+}
+
+/**
+ * @brief      generate samples
+ * @param[in]  *synth pointer to a max30105 synth structure
+ * @param[in]  time time of the first sample in ns
+ * @param[in]  period sample period in ns
+ * @param[out] *raw_red pointer to a red raw data buffer
+ * @param[out] *raw_ir pointer to an ir raw data buffer
+ * @param[out] *raw_green pointer to a green raw data buffer
+ * @param[in]  len number of samples
+ * @note       the codes are cut to the adc resolution like the fifo stores them,
+ *             there is no averaging
+ */
+void max30105_synth_generate(max30105_synth_t *synth, uint64_t time, uint64_t period,
+                             uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green, uint32_t len)
+{
+    uint8_t amplitude[3];
+    uint32_t i;
+    uint32_t mask;
+    float scale;
+    max30105_synth_state_t state;
+    
+    a_max30105_synth_adc(synth, amplitude, &scale, &mask);
+    for (i = 0; i < len; i++)
+    {
+        a_max30105_synth_state(synth, time, &state);
+        raw_red[i] = a_max30105_synth_code(synth, &state, 0, amplitude[0], scale) & mask;
+        raw_ir[i] = a_max30105_synth_code(synth, &state, 1, amplitude[1], scale) & mask;
+        raw_green[i] = a_max30105_synth_code(synth, &state, 2, amplitude[2], scale) & mask;
+        time += period;
+    }
+}
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_synth.h
+ * @brief     driver max30105 optical signal synthesis header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_MAX30105_SYNTH_H
+#define DRIVER_MAX30105_SYNTH_H
+
+#include "driver_max30105_sim.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup max30105_test_driver
+ * @{
+ */
+
+/**
+ * @brief max30105 synth definition
+ */
+#define MAX30105_SYNTH_MAX_EVENT       8              /**< max number of scheduled events */
+#define MAX30105_SYNTH_PULSE_SIZE      256            /**< pulse shape table size */
+#define MAX30105_SYNTH_ALC_TAU         100000ULL      /**< ambient light cancellation settling time constant in ns */
+
+/**
+ * @brief max30105 synth event enumeration definition
+ */
+typedef enum
+{
+    MAX30105_SYNTH_EVENT_MOTION     = 0x00,        /**< coupling swings by level at rate Hz */
+    MAX30105_SYNTH_EVENT_AMBIENT    = 0x01,        /**< ambient light steps by level nA and stays */
+    MAX30105_SYNTH_EVENT_SMOKE      = 0x02,        /**< particles scatter up to level nA per mA of led current */
+    MAX30105_SYNTH_EVENT_SATURATION = 0x03,        /**< every channel reads full scale */
+} max30105_synth_event_type_t;
+
+/**
+ * @brief max30105 synth event structure definition
+ */
+typedef struct max30105_synth_event_s
+{
+    uint8_t type;             /**< event type */
+    uint64_t start;           /**< start time in ns */
+    uint64_t duration;        /**< duration in ns, not used by ambient steps */
+    float level;              /**< event level */
+    float rate;               /**< motion rate in Hz */
+} max30105_synth_event_t;
+
+/**
+ * @brief max30105 synth structure definition
+ */
+typedef struct max30105_synth_s
+{
+    float heart_rate;                                              /**< heart rate in bpm */
+    float perfusion;                                               /**< ir and green perfusion index in %, peak to peak ac over dc */
+    float ratio;                                                   /**< spo2 ratio of ratios, red perfusion over ir perfusion */
+    float coupling[3];                                             /**< red, ir and green dc photocurrent in nA per mA of led current */
+    float noise;                                                   /**< white noise in nA rms */
+    float alc_limit;                                               /**< ambient light the cancellation removes in nA */
+    uint8_t range;                                                 /**< adc range without a linked simulator */
+    uint8_t resolution;                                            /**< adc resolution without a linked simulator */
+    uint8_t amplitude[3];                                          /**< red, ir and green led pulse amplitude without a linked simulator */
+    uint8_t alc_overflow;                                          /**< the ambient light exceeded the cancellation at the last sample */
+    uint8_t event_count;                                           /**< number of scheduled events */
+    max30105_synth_event_t event[MAX30105_SYNTH_MAX_EVENT];        /**< scheduled events */
+    uint32_t seed;                                                 /**< noise generator state */
+    float pulse[MAX30105_SYNTH_PULSE_SIZE + 1];                    /**< pulse shape over one beat from 0 to 1 */
+    max30105_sim_t *sim;                                           /**< linked simulator */
+} max30105_synth_t;
+
+/**
+ * @brief     init the signal generator
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @note      72bpm, 2% perfusion, ratio 0.5, no noise and no events,
+ *            range 4096nA, 18 bits and 6.4mA on every led
+ */
+void max30105_synth_init(max30105_synth_t *synth);
+
+/**
+ * @brief     schedule an event
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @param[in] type event type
+ * @param[in] start start time in ns
+ * @param[in] duration duration in ns
+ * @param[in] level event level
+ * @param[in] rate motion rate in Hz
+ * @return    status code
+ *            - 0 success
+ *            - 1 event table is full
+ * @note      none
+ */
+uint8_t max30105_synth_add_event(max30105_synth_t *synth, max30105_synth_event_type_t type,
+                                 uint64_t start, uint64_t duration, float level, float rate);
+
+/**
+ * @brief     link the signal generator to a simulator
+ * @param[in] *synth pointer to a max30105 synth structure
+ * @param[in] *sim pointer to a max30105 simulator structure
+ * @note      the simulator converts the signal, the adc range and the led amplitudes
+ *            come from its registers and the ambient light sets its alc overflow
+ */
+void max30105_synth_link(max30105_synth_t *synth, max30105_sim_t *sim);
+
+/**
+ * @brief     get the signal of one led
+ * @param[in] *user pointer to a max30105 synth structure
+ * @param[in] led led of the slot
+ * @param[in] time time in ns
+ * @return    18 bits adc counts
+ * @note      the simulator signal function
+ */
+uint32_t max30105_synth_signal(void *user, uint8_t led, uint64_t time);
+
+/**
+ * @brief      generate samples
+ * @param[in]  *synth pointer to a max30105 synth structure
+ * @param[in]  time time of the first sample in ns
+ * @param[in]  period sample period in ns
+ * @param[out] *raw_red pointer to a red raw data buffer
+ * @param[out] *raw_ir pointer to an ir raw data buffer
+ * @param[out] *raw_green pointer to a green raw data buffer
+ * @param[in]  len number of samples
+ * @note       the codes are cut to the adc resolution like the fifo stores them,
+ *             there is no averaging
+ */
+void max30105_synth_generate(max30105_synth_t *synth, uint64_t time, uint64_t period,
+                             uint32_t *raw_red, uint32_t *raw_ir, uint32_t *raw_green, uint32_t len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,409 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_synth_test.c
+ * @brief     driver max30105 synth test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_synth_test.h"
+#include "driver_max30105_synth.h"
+#include <math.h>
+
+static max30105_handle_t gs_handle;        /**< max30105 handle */
+static max30105_sim_t gs_sim;              /**< max30105 simulator */
+static max30105_synth_t gs_synth;          /**< max30105 signal generator */
+static max30105_sample_t gs_sample[32];    /**< sample buffer */
+static uint32_t gs_red[32000];             /**< red buffer */
+static uint32_t gs_ir[32000];              /**< ir buffer */
+static uint32_t gs_green[32000];           /**< green buffer */
+
+/**
+ * @brief      get the range of a buffer
+ * @param[in]  *buf pointer to a data buffer
+ * @param[in]  start first index
+ * @param[in]  end index after the last one
+ * @param[out] *min pointer to a min buffer
+ * @param[out] *max pointer to a max buffer
+ * @return     mean value
+ * @note       none
+ */
+static float a_synth_test_range(const uint32_t *buf, uint32_t start, uint32_t end, uint32_t *min, uint32_t *max)
+{
+    uint32_t i;
+    double sum;
+    
+    *min = 0xFFFFFFFFU;
+    *max = 0;
+    sum = 0.0;
+    for (i = start; i < end; i++)
+    {
+        *min = (buf[i] < *min) ? buf[i] : *min;
+        *max = (buf[i] > *max) ? buf[i] : *max;
+        sum += buf[i];
+    }
+    
+    return (float)(sum / (end - start));
+}
+
+/**
+ * @brief     estimate the heart rate
+ * @param[in] *buf pointer to an ir buffer
+ * @param[in] len buffer length
+ * @param[in] rate sample rate in Hz
+ * @return    heart rate in bpm, 0 with less than two beats
+ * @note      counts the falls through the middle of the swing
+ */
+static float a_synth_test_heart_rate(const uint32_t *buf, uint32_t len, uint32_t rate)
+{
+    uint32_t i;
+    uint32_t min;
+    uint32_t max;
+    uint32_t mid;
+    uint32_t beats;
+    uint32_t first;
+    uint32_t last;
+    
+    (void)a_synth_test_range(buf, 0, len, &min, &max);
+    mid = (min + max) / 2;
+    beats = 0;
+    first = 0;
+    last = 0;
+    for (i = 1; i < len; i++)
+    {
+        if ((buf[i - 1] >= mid) && (buf[i] < mid))
+        {
+            if (beats == 0)
+            {
+                first = i;
+            }
+            last = i;
+            beats++;
+        }
+    }
+    if (beats < 2)
+    {
+        return 0.0f;
+    }
+    
+    return (float)(beats - 1) * 60.0f * (float)rate / (float)(last - first);
+}
+
+/**
+ * @brief     check the pulse
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_synth_test_pulse(void)
+{
+    uint32_t i;
+    uint32_t red_min;
+    uint32_t red_max;
+    uint32_t ir_min;
+    uint32_t ir_max;
+    uint32_t min;
+    uint32_t max;
+    float hr;
+    float red_pi;
+    float ir_pi;
+    float mean;
+    float var;
+    
+    /* 10s at 3200Hz, the ir dc is 240nA per mA at 6.4mA and 64 counts per nA */
+    max30105_synth_init(&gs_synth);
+    gs_synth.heart_rate = 75.0f;
+    max30105_synth_generate(&gs_synth, 0, 312500, gs_red, gs_ir, gs_green, 32000);
+    hr = a_synth_test_heart_rate(gs_ir, 32000, 3200);
+    (void)a_synth_test_range(gs_red, 0, 32000, &red_min, &red_max);
+    (void)a_synth_test_range(gs_ir, 0, 32000, &ir_min, &ir_max);
+    red_pi = (float)(red_max - red_min) * 100.0f / (float)red_max;
+    ir_pi = (float)(ir_max - ir_min) * 100.0f / (float)ir_max;
+    max30105_interface_debug_print("max30105: %0.1fbpm, perfusion index %0.2f, ratio %0.3f, ir dc %d.\n",
+                                   hr, ir_pi, red_pi / ir_pi, ir_max);
+    if ((hr < 74.5f) || (hr > 75.5f) || (ir_pi < 1.95f) || (ir_pi > 2.05f) ||
+        (red_pi / ir_pi < 0.48f) || (red_pi / ir_pi > 0.52f) || (ir_max < 98304 - 2) || (ir_max > 98304 + 2))
+    {
+        max30105_interface_debug_print("max30105: check pulse error.\n");
+        
+        return 1;
+    }
+    
+    /* 15 bits codes */
+    gs_synth.resolution = MAX30105_ADC_RESOLUTION_15_BIT;
+    max30105_synth_generate(&gs_synth, 0, 312500, gs_red, gs_ir, gs_green, 3200);
+    for (i = 0; i < 3200; i++)
+    {
+        if (((gs_red[i] | gs_ir[i] | gs_green[i]) & 0x7) != 0)
+        {
+            max30105_interface_debug_print("max30105: check resolution error.\n");
+            
+            return 1;
+        }
+    }
+    
+    /* 50nA rms noise without a pulse */
+    max30105_synth_init(&gs_synth);
+    gs_synth.perfusion = 0.0f;
+    gs_synth.noise = 50.0f;
+    max30105_synth_generate(&gs_synth, 0, 312500, gs_red, gs_ir, gs_green, 32000);
+    mean = a_synth_test_range(gs_ir, 0, 32000, &min, &max);
+    var = 0.0f;
+    for (i = 0; i < 32000; i++)
+    {
+        var += ((float)gs_ir[i] - mean) * ((float)gs_ir[i] - mean);
+    }
+    var = sqrtf(var / 32000.0f) / 64.0f;
+    max30105_interface_debug_print("max30105: noise %0.1fnA rms.\n", var);
+    if ((var < 47.5f) || (var > 52.5f))
+    {
+        max30105_interface_debug_print("max30105: check noise error.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     check the events
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_synth_test_event(void)
+{
+    uint8_t res;
+    uint32_t min;
+    uint32_t max;
+    uint32_t before;
+    uint32_t after;
+    
+    /* motion from 1s, smoke from 2s, saturation at 3s and an ambient step at 3.5s, 400Hz */
+    max30105_synth_init(&gs_synth);
+    res = max30105_synth_add_event(&gs_synth, MAX30105_SYNTH_EVENT_MOTION, 1000000000ULL, 1000000000ULL, 0.1f, 3.0f);
+    res |= max30105_synth_add_event(&gs_synth, MAX30105_SYNTH_EVENT_SMOKE, 2000000000ULL, 1000000000ULL, 50.0f, 0.0f);
+    res |= max30105_synth_add_event(&gs_synth, MAX30105_SYNTH_EVENT_SATURATION, 3000000000ULL, 100000000ULL, 0.0f, 0.0f);
+    res |= max30105_synth_add_event(&gs_synth, MAX30105_SYNTH_EVENT_AMBIENT, 3500000000ULL, 0, 150000.0f, 0.0f);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: add event failed.\n");
+        
+        return 1;
+    }
+    max30105_synth_generate(&gs_synth, 0, 2500000, gs_red, gs_ir, gs_green, 1600);
+    
+    /* motion swings more than the pulse */
+    (void)a_synth_test_range(gs_ir, 0, 400, &min, &max);
+    before = max - min;
+    (void)a_synth_test_range(gs_ir, 400, 800, &min, &max);
+    after = max - min;
+    max30105_interface_debug_print("max30105: swing %d before motion, %d with motion.\n", before, after);
+    if (after < before * 5)
+    {
+        max30105_interface_debug_print("max30105: check motion error.\n");
+        
+        return 1;
+    }
+    
+    /* smoke scatters 320nA into the ir channel at the peak */
+    (void)a_synth_test_range(gs_ir, 0, 400, &min, &before);
+    (void)a_synth_test_range(gs_ir, 800, 1200, &min, &after);
+    max30105_interface_debug_print("max30105: smoke raised the ir peak by %d.\n", after - before);
+    if ((after < before + 19000) || (after > before + 21000))
+    {
+        max30105_interface_debug_print("max30105: check smoke error.\n");
+        
+        return 1;
+    }
+    
+    /* saturation and the ambient light beyond the cancellation read full scale */
+    if ((gs_ir[1220] != 0x3FFFF) || (gs_red[1220] != 0x3FFFF) || (gs_ir[1260] == 0x3FFFF) ||
+        (gs_ir[1500] != 0x3FFFF) || (gs_synth.alc_overflow == 0))
+    {
+        max30105_interface_debug_print("max30105: check saturation error.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  stream the signal through the simulator at 3200Hz
+ * @return status code
+ *         - 0 success
+ *         - 1 stream failed
+ * @note   none
+ */
+static uint8_t a_synth_test_stream(void)
+{
+    uint8_t res;
+    uint8_t len;
+    uint8_t i;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t red_min;
+    uint32_t red_max;
+    float ratio;
+    
+    /* red and ir at 3200Hz and 16 bits behind a 400khz bus */
+    max30105_sim_init(&gs_sim);
+    gs_sim.byte_time = 22500;
+    max30105_sim_link(&gs_handle, &gs_sim);
+    max30105_synth_init(&gs_synth);
+    max30105_synth_link(&gs_synth, &gs_sim);
+    res = max30105_init(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: init failed.\n");
+        
+        return 1;
+    }
+    res = max30105_set_mode(&gs_handle, MAX30105_MODE_RED_IR);
+    res |= max30105_set_particle_sensing_adc_range(&gs_handle, MAX30105_PARTICLE_SENSING_ADC_RANGE_4096);
+    res |= max30105_set_adc_resolution(&gs_handle, MAX30105_ADC_RESOLUTION_16_BIT);
+    res |= max30105_set_led_red_pulse_amplitude(&gs_handle, 0x20);
+    res |= max30105_set_led_ir_pulse_amplitude(&gs_handle, 0x20);
+    res |= max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_PARTICLE_SENSING_SAMPLE_RATE_3200_HZ);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: set config failed.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* read every 4ms for 10s */
+    count = 0;
+    while (gs_sim.now < 10000000000ULL)
+    {
+        max30105_sim_advance(&gs_sim, 4000000ULL);
+        len = 32;
+        res = max30105_read_samples(&gs_handle, gs_sample, &len);
+        if ((res != 0) && (res != 4))
+        {
+            max30105_interface_debug_print("max30105: read samples failed.\n");
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        for (i = 0; (i < len) && (count < 32000); i++)
+        {
+            gs_red[count] = gs_sample[i].red;
+            gs_ir[count] = gs_sample[i].ir;
+            count++;
+        }
+    }
+    (void)max30105_deinit(&gs_handle);
+    (void)a_synth_test_range(gs_red, 0, count, &red_min, &red_max);
+    (void)a_synth_test_range(gs_ir, 0, count, &min, &max);
+    ratio = ((float)(red_max - red_min) / (float)red_max) / ((float)(max - min) / (float)max);
+    max30105_interface_debug_print("max30105: streamed %d samples, %0.1fbpm, ratio %0.3f, ir dc %d.\n", count,
+                                   a_synth_test_heart_rate(gs_ir, count, 3200), ratio, max);
+    if ((count < 31900) || (gs_sim.lost != 0) || (max < 24576 - 1) || (max > 24576 + 1) ||
+        (ratio < 0.47f) || (ratio > 0.53f))
+    {
+        max30105_interface_debug_print("max30105: check stream error.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     synth test
+ * @param[in] *now pointer to an optional monotonic clock function in ns
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      checks the synthesized heart rate, perfusion, ratio and events,
+ *            streams them through the simulator at 3200Hz and prints the generator throughput with a clock
+ */
+uint8_t max30105_synth_test(uint64_t (*now)(void))
+{
+    uint32_t i;
+    uint64_t start;
+    uint64_t elapsed;
+    
+    /* start synth test */
+    max30105_interface_debug_print("max30105: start synth test.\n");
+    
+    /* pulse */
+    max30105_interface_debug_print("max30105: 75bpm, perfusion index 2 and ratio 0.5 at 3200Hz.\n");
+    if (a_synth_test_pulse() != 0)
+    {
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check pulse ok.\n");
+    
+    /* events */
+    max30105_interface_debug_print("max30105: motion, smoke, saturation and ambient light.\n");
+    if (a_synth_test_event() != 0)
+    {
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check events ok.\n");
+    
+    /* simulator */
+    max30105_interface_debug_print("max30105: stream through the simulator at 3200Hz.\n");
+    if (a_synth_test_stream() != 0)
+    {
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check stream ok.\n");
+    
+    /* throughput */
+    if (now != NULL)
+    {
+        max30105_synth_init(&gs_synth);
+        gs_synth.noise = 20.0f;
+        (void)max30105_synth_add_event(&gs_synth, MAX30105_SYNTH_EVENT_MOTION, 0, 1000000000000ULL, 0.05f, 1.5f);
+        start = now();
+        for (i = 0; i < 100; i++)
+        {
+            max30105_synth_generate(&gs_synth, (uint64_t)i * 10000000000ULL, 312500, gs_red, gs_ir, gs_green, 32000);
+        }
+        elapsed = now() - start;
+        max30105_interface_debug_print("max30105: generated 3200000 samples in %dms, %d samples per second.\n",
+                                       (int)(elapsed / 1000000ULL),
+                                       (int)((elapsed != 0) ? (3200000ULL * 1000000000ULL / elapsed) : 0));
+    }
+    
+    /* finish synth test */
+    max30105_interface_debug_print("max30105: finish synth test.\n");
+    
+    return 0;
+}
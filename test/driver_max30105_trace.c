@@ -0,0 +1,957 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_trace.c
+ * @brief     driver max30105 bus trace source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_trace.h"
+
+/**
+ * @brief trace format definition
+ */
+#define MAX30105_TRACE_TYPE_MASK        0x07        /**< record type bits */
+#define MAX30105_TRACE_HAS_TRANSFER     0x01        /**< the traced handle had a batch transfer function */
+
+/**
+ * @brief trace magic
+ */
+static const uint8_t gs_trace_magic[4] = {'M', 'X', 'T', 'R'};
+
+/**
+ * @brief     set the first error
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] error trace error
+ * @param[in] pos trace position
+ * @return    status code
+ *            - 1 always
+ * @note      later errors are ignored
+ */
+static uint8_t a_max30105_trace_fail(max30105_trace_t *trace, max30105_trace_error_t error, uint32_t pos)
+{
+    if (trace->error == MAX30105_TRACE_ERROR_NONE)
+    {
+        trace->error = (uint8_t)error;
+        trace->error_pos = pos;
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief      encode a varint
+ * @param[out] *out pointer to a 10 length output buffer
+ * @param[in]  value encoded value
+ * @return     encoded length
+ * @note       7 bits per byte, least significant group first
+ */
+static uint8_t a_max30105_trace_varint(uint8_t *out, uint64_t value)
+{
+    uint8_t len;
+    
+    len = 0;
+    while (value >= 0x80)
+    {
+        out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    
+    return len;
+}
+
+/**
+ * @brief     get the size of a recorded access
+ * @param[in] len payload length
+ * @return    size in bytes
+ * @note      reg, length and payload
+ */
+static uint32_t a_max30105_trace_access_size(uint16_t len)
+{
+    uint8_t tmp[10];
+    
+    return 1 + a_max30105_trace_varint(tmp, len) + len;
+}
+
+/**
+ * @brief     read the clock
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @return    time in ns
+ * @note      0 without a clock
+ */
+static uint64_t a_max30105_trace_now(max30105_trace_t *trace)
+{
+    if (trace->now == NULL)
+    {
+        return 0;
+    }
+    
+    return trace->now(trace->user);
+}
+
+/**
+ * @brief     append bytes to the record buffer
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] *data pointer to the appended bytes
+ * @param[in] len number of bytes
+ * @note      a full buffer goes to output
+ */
+static void a_max30105_trace_put(max30105_trace_t *trace, const uint8_t *data, uint32_t len)
+{
+    uint32_t n;
+    
+    while ((len > 0) && (trace->error == MAX30105_TRACE_ERROR_NONE))
+    {
+        if (trace->pos == trace->size)
+        {
+            if ((trace->output == NULL) || (trace->output(trace->output_user, trace->buf, trace->pos) != 0))
+            {
+                (void)a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_OVERFLOW, trace->pos);
+                
+                return;
+            }
+            trace->pos = 0;
+        }
+        n = trace->size - trace->pos;
+        n = (n < len) ? n : len;
+        memcpy(&trace->buf[trace->pos], data, n);
+        trace->pos += n;
+        data += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief     begin a record
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] type record type and flags
+ * @param[in] time record time in ns
+ * @param[in] rest size of the record body
+ * @return    status code
+ *            - 0 success
+ *            - 1 record dropped
+ * @note      without output a record that doesn't fit stops the recording,
+ *            so the buffer always holds whole records
+ */
+static uint8_t a_max30105_trace_begin(max30105_trace_t *trace, uint8_t type, uint64_t time, uint32_t rest)
+{
+    uint8_t head[11];
+    uint8_t len;
+    
+    if (trace->error != MAX30105_TRACE_ERROR_NONE)
+    {
+        return 1;
+    }
+    
+    /* the time goes as a delta to the last record */
+    head[0] = type;
+    len = 1 + a_max30105_trace_varint(&head[1], (time > trace->time) ? (time - trace->time) : 0);
+    if ((trace->output == NULL) && (trace->size - trace->pos < len + rest))
+    {
+        return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_OVERFLOW, trace->pos);
+    }
+    trace->time = (time > trace->time) ? time : trace->time;
+    trace->records++;
+    a_max30105_trace_put(trace, head, len);
+    
+    return 0;
+}
+
+/**
+ * @brief     append a varint
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] value appended value
+ * @note      none
+ */
+static void a_max30105_trace_put_varint(max30105_trace_t *trace, uint64_t value)
+{
+    uint8_t tmp[10];
+    
+    a_max30105_trace_put(trace, tmp, a_max30105_trace_varint(tmp, value));
+}
+
+/**
+ * @brief     append an access
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to the payload
+ * @param[in] len payload length
+ * @note      none
+ */
+static void a_max30105_trace_put_access(max30105_trace_t *trace, uint8_t reg, const uint8_t *buf, uint16_t len)
+{
+    a_max30105_trace_put(trace, &reg, 1);
+    a_max30105_trace_put_varint(trace, len);
+    a_max30105_trace_put(trace, buf, len);
+}
+
+/**
+ * @brief      get one trace byte
+ * @param[in]  *trace pointer to a max30105 trace structure
+ * @param[out] *data pointer to a data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 trace is truncated
+ * @note       none
+ */
+static uint8_t a_max30105_trace_get(max30105_trace_t *trace, uint8_t *data)
+{
+    if (trace->pos >= trace->size)
+    {
+        return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_CORRUPT, trace->pos);
+    }
+    *data = trace->buf[trace->pos++];
+    
+    return 0;
+}
+
+/**
+ * @brief      get one trace varint
+ * @param[in]  *trace pointer to a max30105 trace structure
+ * @param[out] *value pointer to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 trace is truncated or malformed
+ * @note       none
+ */
+static uint8_t a_max30105_trace_get_varint(max30105_trace_t *trace, uint64_t *value)
+{
+    uint8_t i;
+    uint8_t data;
+    
+    *value = 0;
+    for (i = 0; i < 10; i++)
+    {
+        if (a_max30105_trace_get(trace, &data) != 0)
+        {
+            return 1;
+        }
+        *value |= (uint64_t)(data & 0x7F) << (7 * i);
+        if ((data & 0x80) == 0)
+        {
+            return 0;
+        }
+    }
+    
+    return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_CORRUPT, trace->pos);
+}
+
+/**
+ * @brief     run the recorded irqs
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] flags flags the irq records must have
+ * @note      runs the irq records at the read position, except inside the irq handler
+ */
+static void a_max30105_trace_run_irq(max30105_trace_t *trace, uint8_t flags)
+{
+    uint8_t type;
+    uint64_t delta;
+    uint64_t edge;
+    
+    while ((trace->in_irq == 0) && (trace->error == MAX30105_TRACE_ERROR_NONE) && (trace->pos < trace->size) &&
+           ((trace->buf[trace->pos] & MAX30105_TRACE_TYPE_MASK) == MAX30105_TRACE_RECORD_IRQ) &&
+           ((trace->buf[trace->pos] & flags) == flags))
+    {
+        type = trace->buf[trace->pos++];
+        if (a_max30105_trace_get_varint(trace, &delta) != 0)
+        {
+            return;
+        }
+        trace->time += delta;
+        trace->records++;
+        trace->in_irq = 1;
+        if ((type & MAX30105_TRACE_FLAG_EDGE) != 0)
+        {
+            if (a_max30105_trace_get_varint(trace, &edge) != 0)
+            {
+                trace->in_irq = 0;
+                
+                return;
+            }
+            (void)max30105_set_edge_timestamp(trace->handle, edge);
+        }
+        (void)max30105_irq_handler(trace->handle);
+        trace->in_irq = 0;
+    }
+}
+
+/**
+ * @brief      get the next record
+ * @param[in]  *trace pointer to a max30105 trace structure
+ * @param[in]  type expected record type
+ * @param[out] *flags pointer to a flags buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 trace error
+ * @note       the irqs recorded before run first
+ */
+static uint8_t a_max30105_trace_next(max30105_trace_t *trace, uint8_t type, uint8_t *flags)
+{
+    uint8_t data;
+    uint64_t delta;
+    
+    a_max30105_trace_run_irq(trace, 0);
+    if (trace->error != MAX30105_TRACE_ERROR_NONE)
+    {
+        return 1;
+    }
+    if (trace->pos >= trace->size)
+    {
+        return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_END, trace->pos);
+    }
+    data = trace->buf[trace->pos];
+    if ((data & MAX30105_TRACE_TYPE_MASK) != type)
+    {
+        return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_MISMATCH, trace->pos);
+    }
+    trace->pos++;
+    if (a_max30105_trace_get_varint(trace, &delta) != 0)
+    {
+        return 1;
+    }
+    trace->time += delta;
+    trace->records++;
+    *flags = data & (uint8_t)(~MAX30105_TRACE_TYPE_MASK);
+    
+    return 0;
+}
+
+/**
+ * @brief      replay an access
+ * @param[in]  *trace pointer to a max30105 trace structure
+ * @param[in]  read 1 to read, 0 to write
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 trace error
+ * @note       reads return the recorded payload, writes must match it
+ */
+static uint8_t a_max30105_trace_get_access(max30105_trace_t *trace, uint8_t read, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint8_t data;
+    uint32_t start;
+    uint64_t length;
+    
+    start = trace->pos;
+    if ((a_max30105_trace_get(trace, &data) != 0) || (a_max30105_trace_get_varint(trace, &length) != 0))
+    {
+        return 1;
+    }
+    if ((data != reg) || (length != len))
+    {
+        return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_MISMATCH, start);
+    }
+    if (trace->size - trace->pos < len)
+    {
+        return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_CORRUPT, trace->pos);
+    }
+    if (read != 0)
+    {
+        memcpy(buf, &trace->buf[trace->pos], len);
+    }
+    else if (memcmp(buf, &trace->buf[trace->pos], len) != 0)
+    {
+        return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_MISMATCH, start);
+    }
+    trace->pos += len;
+    
+    return 0;
+}
+
+/**
+ * @brief     link a handle to the trace functions
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] transfer bool value
+ * @note      keeps the old links to forward the calls
+ */
+static void a_max30105_trace_link(max30105_trace_t *trace, max30105_handle_t *handle, uint8_t transfer)
+{
+    trace->handle = handle;
+    trace->user = handle->user;
+    trace->iic_init = handle->iic_init;
+    trace->iic_deinit = handle->iic_deinit;
+    trace->iic_read = handle->iic_read;
+    trace->iic_write = handle->iic_write;
+    trace->delay_ms = handle->delay_ms;
+    trace->receive_callback = handle->receive_callback;
+    trace->iic_transfer = handle->iic_transfer;
+    trace->iic_init_ctx = handle->iic_init_ctx;
+    trace->iic_deinit_ctx = handle->iic_deinit_ctx;
+    trace->iic_read_ctx = handle->iic_read_ctx;
+    trace->iic_write_ctx = handle->iic_write_ctx;
+    trace->delay_ms_ctx = handle->delay_ms_ctx;
+    trace->receive_callback_ctx = handle->receive_callback_ctx;
+    trace->iic_transfer_ctx = handle->iic_transfer_ctx;
+    DRIVER_MAX30105_LINK_USER(handle, trace);
+    DRIVER_MAX30105_LINK_IIC_INIT_CTX(handle, max30105_trace_iic_init);
+    DRIVER_MAX30105_LINK_IIC_DEINIT_CTX(handle, max30105_trace_iic_deinit);
+    DRIVER_MAX30105_LINK_IIC_READ_CTX(handle, max30105_trace_iic_read);
+    DRIVER_MAX30105_LINK_IIC_WRITE_CTX(handle, max30105_trace_iic_write);
+    DRIVER_MAX30105_LINK_DELAY_MS_CTX(handle, max30105_trace_delay_ms);
+    DRIVER_MAX30105_LINK_RECEIVE_CALLBACK_CTX(handle, max30105_trace_receive_callback);
+    DRIVER_MAX30105_LINK_IIC_TRANSFER(handle, NULL);
+    DRIVER_MAX30105_LINK_IIC_TRANSFER_CTX(handle, (transfer != 0) ? max30105_trace_iic_transfer : NULL);
+    DRIVER_MAX30105_LINK_TIMESTAMP_CTX(handle, max30105_trace_timestamp);
+}
+
+/**
+ * @brief     start recording the bus traffic of a handle
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] *handle pointer to a linked max30105 handle structure
+ * @param[in] *buf pointer to a record buffer
+ * @param[in] size record buffer size
+ * @param[in] *now pointer to an optional monotonic clock in ns, called with the handle user
+ * @return    status code
+ *            - 0 success
+ *            - 1 record buffer is too small
+ * @note      links the handle to the trace functions, which forward every call to the old links,
+ *            set output before to flush full buffers instead of stopping the recording,
+ *            the INT line must run max30105_trace_irq_handler instead of max30105_irq_handler
+ */
+uint8_t max30105_trace_record(max30105_trace_t *trace, max30105_handle_t *handle, uint8_t *buf, uint32_t size,
+                              uint64_t (*now)(void *user))
+{
+    uint8_t i;
+    uint8_t transfer;
+    
+    if (size < MAX30105_TRACE_HEADER_SIZE)
+    {
+        return 1;
+    }
+    trace->replay = 0;
+    trace->in_irq = 0;
+    trace->in_delay = 0;
+    trace->error = MAX30105_TRACE_ERROR_NONE;
+    trace->buf = buf;
+    trace->size = size;
+    trace->records = 0;
+    trace->error_pos = 0;
+    trace->now = now;
+    transfer = ((handle->iic_transfer_ctx != NULL) || (handle->iic_transfer != NULL)) ? 1 : 0;
+    a_max30105_trace_link(trace, handle, transfer);
+    
+    /* magic, version, flags and the start time */
+    trace->time = a_max30105_trace_now(trace);
+    memcpy(buf, gs_trace_magic, 4);
+    buf[4] = MAX30105_TRACE_VERSION;
+    buf[5] = (transfer != 0) ? MAX30105_TRACE_HAS_TRANSFER : 0;
+    for (i = 0; i < 8; i++)
+    {
+        buf[6 + i] = (uint8_t)(trace->time >> (8 * i));
+    }
+    trace->pos = MAX30105_TRACE_HEADER_SIZE;
+    
+    return 0;
+}
+
+/**
+ * @brief     start replaying a trace into a handle
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *buf pointer to a recorded trace
+ * @param[in] len trace length
+ * @return    status code
+ *            - 0 success
+ *            - 1 trace header is invalid
+ * @note      links the handle to the trace functions, bus reads return the recorded payloads,
+ *            delays return at once and the recorded irqs run at the recorded points
+ */
+uint8_t max30105_trace_replay(max30105_trace_t *trace, max30105_handle_t *handle, const uint8_t *buf, uint32_t len)
+{
+    uint8_t i;
+    
+    if ((len < MAX30105_TRACE_HEADER_SIZE) || (memcmp(buf, gs_trace_magic, 4) != 0) ||
+        (buf[4] != MAX30105_TRACE_VERSION))
+    {
+        return 1;
+    }
+    trace->replay = 1;
+    trace->in_irq = 0;
+    trace->in_delay = 0;
+    trace->error = MAX30105_TRACE_ERROR_NONE;
+    trace->buf = (uint8_t *)buf;
+    trace->size = len;
+    trace->pos = MAX30105_TRACE_HEADER_SIZE;
+    trace->records = 0;
+    trace->error_pos = 0;
+    trace->now = NULL;
+    trace->output = NULL;
+    trace->time = 0;
+    for (i = 0; i < 8; i++)
+    {
+        trace->time |= (uint64_t)buf[6 + i] << (8 * i);
+    }
+    
+    /* the driver takes the same transfer path as the recorded one */
+    a_max30105_trace_link(trace, handle, ((buf[5] & MAX30105_TRACE_HAS_TRANSFER) != 0) ? 1 : 0);
+    
+    return 0;
+}
+
+/**
+ * @brief     run the irq handler of a traced handle
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] edge interrupt edge timestamp in ns, 0 when unknown
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      recording logs the irq and runs max30105_irq_handler,
+ *            replaying runs the irqs recorded next, so call it where the INT line got served,
+ *            irqs left over run before the next bus call
+ */
+uint8_t max30105_trace_irq_handler(max30105_trace_t *trace, uint64_t edge)
+{
+    uint8_t res;
+    uint8_t type;
+    uint8_t tmp[10];
+    
+    if (trace->replay != 0)
+    {
+        a_max30105_trace_run_irq(trace, 0);
+        
+        return (trace->error != MAX30105_TRACE_ERROR_NONE) ? 1 : 0;
+    }
+    
+    /* the edge goes in full, it may be older than the last record */
+    type = MAX30105_TRACE_RECORD_IRQ | ((trace->in_delay != 0) ? MAX30105_TRACE_FLAG_DELAY : 0);
+    if (edge != 0)
+    {
+        if (a_max30105_trace_begin(trace, type | MAX30105_TRACE_FLAG_EDGE,
+                                   a_max30105_trace_now(trace), a_max30105_trace_varint(tmp, edge)) == 0)
+        {
+            a_max30105_trace_put(trace, tmp, a_max30105_trace_varint(tmp, edge));
+        }
+        if (max30105_set_edge_timestamp(trace->handle, edge) != 0)
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        (void)a_max30105_trace_begin(trace, type, a_max30105_trace_now(trace), 0);
+    }
+    trace->in_irq = 1;
+    res = max30105_irq_handler(trace->handle);
+    trace->in_irq = 0;
+    
+    return (res != 0) ? 1 : 0;
+}
+
+/**
+ * @brief     finish a trace
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 trace error
+ *            - 2 records left to replay
+ * @note      recording flushes the buffer to output,
+ *            replaying runs the remaining irqs and checks the whole trace was used
+ */
+uint8_t max30105_trace_finish(max30105_trace_t *trace)
+{
+    if (trace->replay != 0)
+    {
+        a_max30105_trace_run_irq(trace, 0);
+        if (trace->error != MAX30105_TRACE_ERROR_NONE)
+        {
+            return 1;
+        }
+        
+        return (trace->pos < trace->size) ? 2 : 0;
+    }
+    if (trace->error != MAX30105_TRACE_ERROR_NONE)
+    {
+        return 1;
+    }
+    if ((trace->output != NULL) && (trace->pos > 0))
+    {
+        if (trace->output(trace->output_user, trace->buf, trace->pos) != 0)
+        {
+            return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_OVERFLOW, trace->pos);
+        }
+        trace->pos = 0;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     trace iic init
+ * @param[in] *user pointer to a max30105 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+uint8_t max30105_trace_iic_init(void *user)
+{
+    uint8_t res;
+    uint8_t flags;
+    uint64_t time;
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->replay != 0)
+    {
+        if (a_max30105_trace_next(trace, MAX30105_TRACE_RECORD_INIT, &flags) != 0)
+        {
+            return 1;
+        }
+        
+        return ((flags & MAX30105_TRACE_FLAG_FAILED) != 0) ? 1 : 0;
+    }
+    time = a_max30105_trace_now(trace);
+    if (trace->iic_init_ctx != NULL)
+    {
+        res = trace->iic_init_ctx(trace->user);
+    }
+    else
+    {
+        res = trace->iic_init();
+    }
+    (void)a_max30105_trace_begin(trace, MAX30105_TRACE_RECORD_INIT | ((res != 0) ? MAX30105_TRACE_FLAG_FAILED : 0), time, 0);
+    
+    return res;
+}
+
+/**
+ * @brief     trace iic deinit
+ * @param[in] *user pointer to a max30105 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      none
+ */
+uint8_t max30105_trace_iic_deinit(void *user)
+{
+    uint8_t res;
+    uint8_t flags;
+    uint64_t time;
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->replay != 0)
+    {
+        if (a_max30105_trace_next(trace, MAX30105_TRACE_RECORD_DEINIT, &flags) != 0)
+        {
+            return 1;
+        }
+        
+        return ((flags & MAX30105_TRACE_FLAG_FAILED) != 0) ? 1 : 0;
+    }
+    time = a_max30105_trace_now(trace);
+    if (trace->iic_deinit_ctx != NULL)
+    {
+        res = trace->iic_deinit_ctx(trace->user);
+    }
+    else
+    {
+        res = trace->iic_deinit();
+    }
+    (void)a_max30105_trace_begin(trace, MAX30105_TRACE_RECORD_DEINIT | ((res != 0) ? MAX30105_TRACE_FLAG_FAILED : 0), time, 0);
+    
+    return res;
+}
+
+/**
+ * @brief      trace iic read
+ * @param[in]  *user pointer to a max30105 trace structure
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t max30105_trace_iic_read(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint8_t res;
+    uint8_t flags;
+    uint64_t time;
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->replay != 0)
+    {
+        if ((a_max30105_trace_next(trace, MAX30105_TRACE_RECORD_READ, &flags) != 0) ||
+            (a_max30105_trace_get_access(trace, 1, reg, buf, len) != 0))
+        {
+            return 1;
+        }
+        
+        return ((flags & MAX30105_TRACE_FLAG_FAILED) != 0) ? 1 : 0;
+    }
+    time = a_max30105_trace_now(trace);
+    if (trace->iic_read_ctx != NULL)
+    {
+        res = trace->iic_read_ctx(trace->user, addr, reg, buf, len);
+    }
+    else
+    {
+        res = trace->iic_read(addr, reg, buf, len);
+    }
+    if (a_max30105_trace_begin(trace, MAX30105_TRACE_RECORD_READ | ((res != 0) ? MAX30105_TRACE_FLAG_FAILED : 0),
+                               time, a_max30105_trace_access_size(len)) == 0)
+    {
+        a_max30105_trace_put_access(trace, reg, buf, len);
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     trace iic write
+ * @param[in] *user pointer to a max30105 trace structure
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t max30105_trace_iic_write(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint8_t res;
+    uint8_t flags;
+    uint64_t time;
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->replay != 0)
+    {
+        if ((a_max30105_trace_next(trace, MAX30105_TRACE_RECORD_WRITE, &flags) != 0) ||
+            (a_max30105_trace_get_access(trace, 0, reg, buf, len) != 0))
+        {
+            return 1;
+        }
+        
+        return ((flags & MAX30105_TRACE_FLAG_FAILED) != 0) ? 1 : 0;
+    }
+    time = a_max30105_trace_now(trace);
+    if (trace->iic_write_ctx != NULL)
+    {
+        res = trace->iic_write_ctx(trace->user, addr, reg, buf, len);
+    }
+    else
+    {
+        res = trace->iic_write(addr, reg, buf, len);
+    }
+    if (a_max30105_trace_begin(trace, MAX30105_TRACE_RECORD_WRITE | ((res != 0) ? MAX30105_TRACE_FLAG_FAILED : 0),
+                               time, a_max30105_trace_access_size(len)) == 0)
+    {
+        a_max30105_trace_put_access(trace, reg, buf, len);
+    }
+    
+    return res;
+}
+
+/**
+ * @brief         trace iic batch transfer
+ * @param[in]     *user pointer to a max30105 trace structure
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          only linked when the traced handle has a transfer function
+ */
+uint8_t max30105_trace_iic_transfer(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num)
+{
+    uint8_t i;
+    uint8_t res;
+    uint8_t flags;
+    uint8_t data;
+    uint32_t start;
+    uint32_t rest;
+    uint64_t time;
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->replay != 0)
+    {
+        if (a_max30105_trace_next(trace, MAX30105_TRACE_RECORD_TRANSFER, &flags) != 0)
+        {
+            return 1;
+        }
+        start = trace->pos;
+        if (a_max30105_trace_get(trace, &data) != 0)
+        {
+            return 1;
+        }
+        if (data != num)
+        {
+            return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_MISMATCH, start);
+        }
+        for (i = 0; i < num; i++)
+        {
+            start = trace->pos;
+            if (a_max30105_trace_get(trace, &data) != 0)
+            {
+                return 1;
+            }
+            if (data != ((transfer[i].read != 0) ? 1 : 0))
+            {
+                return a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_MISMATCH, start);
+            }
+            if (a_max30105_trace_get_access(trace, data, transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)
+            {
+                return 1;
+            }
+        }
+        
+        return ((flags & MAX30105_TRACE_FLAG_FAILED) != 0) ? 1 : 0;
+    }
+    time = a_max30105_trace_now(trace);
+    if (trace->iic_transfer_ctx != NULL)
+    {
+        res = trace->iic_transfer_ctx(trace->user, addr, transfer, num);
+    }
+    else
+    {
+        res = trace->iic_transfer(addr, transfer, num);
+    }
+    
+    /* number of accesses, then direction, reg, length and payload of each */
+    rest = 1;
+    for (i = 0; i < num; i++)
+    {
+        rest += 1 + a_max30105_trace_access_size(transfer[i].len);
+    }
+    if (a_max30105_trace_begin(trace, MAX30105_TRACE_RECORD_TRANSFER | ((res != 0) ? MAX30105_TRACE_FLAG_FAILED : 0),
+                               time, rest) == 0)
+    {
+        a_max30105_trace_put(trace, &num, 1);
+        for (i = 0; i < num; i++)
+        {
+            data = (transfer[i].read != 0) ? 1 : 0;
+            a_max30105_trace_put(trace, &data, 1);
+            a_max30105_trace_put_access(trace, transfer[i].reg, transfer[i].buf, transfer[i].len);
+        }
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     trace delay ms
+ * @param[in] *user pointer to a max30105 trace structure
+ * @param[in] ms time
+ * @note      none
+ */
+void max30105_trace_delay_ms(void *user, uint32_t ms)
+{
+    uint8_t flags;
+    uint8_t tmp[10];
+    uint32_t start;
+    uint64_t value;
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->replay != 0)
+    {
+        if (a_max30105_trace_next(trace, MAX30105_TRACE_RECORD_DELAY, &flags) != 0)
+        {
+            return;
+        }
+        start = trace->pos;
+        if (a_max30105_trace_get_varint(trace, &value) != 0)
+        {
+            return;
+        }
+        if (value != ms)
+        {
+            (void)a_max30105_trace_fail(trace, MAX30105_TRACE_ERROR_MISMATCH, start);
+            
+            return;
+        }
+        
+        /* the irqs that came during the delay */
+        a_max30105_trace_run_irq(trace, MAX30105_TRACE_FLAG_DELAY);
+        
+        return;
+    }
+    if (a_max30105_trace_begin(trace, MAX30105_TRACE_RECORD_DELAY, a_max30105_trace_now(trace),
+                               a_max30105_trace_varint(tmp, ms)) == 0)
+    {
+        a_max30105_trace_put_varint(trace, ms);
+    }
+    trace->in_delay = 1;
+    if (trace->delay_ms_ctx != NULL)
+    {
+        trace->delay_ms_ctx(trace->user, ms);
+    }
+    else
+    {
+        trace->delay_ms(ms);
+    }
+    trace->in_delay = 0;
+}
+
+/**
+ * @brief     trace receive callback
+ * @param[in] *user pointer to a max30105 trace structure
+ * @param[in] type irq type
+ * @note      forwards to the traced callback, not recorded
+ */
+void max30105_trace_receive_callback(void *user, uint8_t type)
+{
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->receive_callback_ctx != NULL)
+    {
+        trace->receive_callback_ctx(trace->user, type);
+    }
+    else if (trace->receive_callback != NULL)
+    {
+        trace->receive_callback(type);
+    }
+}
+
+/**
+ * @brief     trace timestamp
+ * @param[in] *user pointer to a max30105 trace structure
+ * @return    time in ns
+ * @note      recording reads the clock, replaying returns the time of the last record
+ */
+uint64_t max30105_trace_timestamp(void *user)
+{
+    max30105_trace_t *trace = (max30105_trace_t *)user;
+    
+    if (trace->replay != 0)
+    {
+        return trace->time;
+    }
+    
+    return a_max30105_trace_now(trace);
+}
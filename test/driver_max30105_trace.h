@@ -0,0 +1,282 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_trace.h
+ * @brief     driver max30105 bus trace header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_MAX30105_TRACE_H
+#define DRIVER_MAX30105_TRACE_H
+
+#include "driver_max30105_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup max30105_test_driver
+ * @{
+ */
+
+/**
+ * @brief max30105 trace definition
+ */
+#define MAX30105_TRACE_VERSION         1        /**< trace format version */
+#define MAX30105_TRACE_HEADER_SIZE     14       /**< magic, version, flags and start time */
+
+/**
+ * @brief max30105 trace record type enumeration definition
+ */
+typedef enum
+{
+    MAX30105_TRACE_RECORD_READ     = 0x00,        /**< reg, length and read payload */
+    MAX30105_TRACE_RECORD_WRITE    = 0x01,        /**< reg, length and written payload */
+    MAX30105_TRACE_RECORD_TRANSFER = 0x02,        /**< number of accesses, then direction, reg, length and payload of each */
+    MAX30105_TRACE_RECORD_DELAY    = 0x03,        /**< delay in ms */
+    MAX30105_TRACE_RECORD_IRQ      = 0x04,        /**< irq handler entry */
+    MAX30105_TRACE_RECORD_INIT     = 0x05,        /**< iic init */
+    MAX30105_TRACE_RECORD_DEINIT   = 0x06,        /**< iic deinit */
+} max30105_trace_record_t;
+
+/**
+ * @brief max30105 trace record flag enumeration definition
+ */
+typedef enum
+{
+    MAX30105_TRACE_FLAG_DELAY  = 0x20,        /**< the irq ran during a driver delay */
+    MAX30105_TRACE_FLAG_EDGE   = 0x40,        /**< the irq record carries the interrupt edge timestamp */
+    MAX30105_TRACE_FLAG_FAILED = 0x80,        /**< the call returned an error */
+} max30105_trace_flag_t;
+
+/**
+ * @brief max30105 trace error enumeration definition
+ */
+typedef enum
+{
+    MAX30105_TRACE_ERROR_NONE     = 0x00,        /**< no error */
+    MAX30105_TRACE_ERROR_MISMATCH = 0x01,        /**< the driver diverged from the trace */
+    MAX30105_TRACE_ERROR_END      = 0x02,        /**< the driver ran past the end of the trace */
+    MAX30105_TRACE_ERROR_CORRUPT  = 0x03,        /**< the trace is truncated or malformed */
+    MAX30105_TRACE_ERROR_OVERFLOW = 0x04,        /**< the record buffer is full or the output failed */
+} max30105_trace_error_t;
+
+/**
+ * @brief max30105 trace structure definition
+ */
+typedef struct max30105_trace_s
+{
+    max30105_handle_t *handle;                                                              /**< traced handle */
+    uint8_t replay;                                                                         /**< 1 when replaying, 0 when recording */
+    uint8_t in_irq;                                                                         /**< the irq handler is running */
+    uint8_t in_delay;                                                                       /**< a driver delay is running */
+    uint8_t error;                                                                          /**< first error */
+    uint8_t *buf;                                                                           /**< record buffer, or the replayed trace */
+    uint32_t size;                                                                          /**< record buffer size, or the replayed trace length */
+    uint32_t pos;                                                                           /**< write position, or the read position */
+    uint32_t records;                                                                       /**< records written or replayed */
+    uint32_t error_pos;                                                                     /**< trace position of the record that failed */
+    uint64_t time;                                                                          /**< time of the last record in ns */
+    uint64_t (*now)(void *user);                                                            /**< optional monotonic clock in ns, called with the traced user */
+    uint8_t (*output)(void *user, const uint8_t *buf, uint32_t len);                        /**< optional sink for full record buffers */
+    void *output_user;                                                                      /**< user context passed to output */
+    void *user;                                                                             /**< traced user context */
+    uint8_t (*iic_init)(void);                                                              /**< traced iic_init function */
+    uint8_t (*iic_deinit)(void);                                                            /**< traced iic_deinit function */
+    uint8_t (*iic_read)(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);             /**< traced iic_read function */
+    uint8_t (*iic_write)(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);            /**< traced iic_write function */
+    void (*delay_ms)(uint32_t ms);                                                          /**< traced delay_ms function */
+    void (*receive_callback)(uint8_t type);                                                 /**< traced receive_callback function */
+    uint8_t (*iic_transfer)(uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num);  /**< traced iic_transfer function */
+    uint8_t (*iic_init_ctx)(void *user);                                                    /**< traced iic_init_ctx function */
+    uint8_t (*iic_deinit_ctx)(void *user);                                                  /**< traced iic_deinit_ctx function */
+    uint8_t (*iic_read_ctx)(void *user, uint8_t addr, uint8_t reg,
+                            uint8_t *buf, uint16_t len);                                    /**< traced iic_read_ctx function */
+    uint8_t (*iic_write_ctx)(void *user, uint8_t addr, uint8_t reg,
+                             uint8_t *buf, uint16_t len);                                   /**< traced iic_write_ctx function */
+    void (*delay_ms_ctx)(void *user, uint32_t ms);                                          /**< traced delay_ms_ctx function */
+    void (*receive_callback_ctx)(void *user, uint8_t type);                                 /**< traced receive_callback_ctx function */
+    uint8_t (*iic_transfer_ctx)(void *user, uint8_t addr,
+                                max30105_iic_transfer_t *transfer, uint8_t num);            /**< traced iic_transfer_ctx function */
+} max30105_trace_t;
+
+/**
+ * @brief     start recording the bus traffic of a handle
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] *handle pointer to a linked max30105 handle structure
+ * @param[in] *buf pointer to a record buffer
+ * @param[in] size record buffer size
+ * @param[in] *now pointer to an optional monotonic clock in ns, called with the handle user
+ * @return    status code
+ *            - 0 success
+ *            - 1 record buffer is too small
+ * @note      links the handle to the trace functions, which forward every call to the old links,
+ *            clear the structure and set output before to flush full buffers instead of stopping the recording,
+ *            the INT line must run max30105_trace_irq_handler instead of max30105_irq_handler
+ */
+uint8_t max30105_trace_record(max30105_trace_t *trace, max30105_handle_t *handle, uint8_t *buf, uint32_t size,
+                              uint64_t (*now)(void *user));
+
+/**
+ * @brief     start replaying a trace into a handle
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] *handle pointer to a max30105 handle structure
+ * @param[in] *buf pointer to a recorded trace
+ * @param[in] len trace length
+ * @return    status code
+ *            - 0 success
+ *            - 1 trace header is invalid
+ * @note      links the handle to the trace functions, bus reads return the recorded payloads,
+ *            delays return at once and the recorded irqs run before the next bus call,
+ *            or at the end of the delay they interrupted
+ */
+uint8_t max30105_trace_replay(max30105_trace_t *trace, max30105_handle_t *handle, const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief     run the irq handler of a traced handle
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @param[in] edge interrupt edge timestamp in ns, 0 when unknown
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      recording logs the irq and runs max30105_irq_handler,
+ *            replaying runs the irqs recorded next, so call it where the INT line got served,
+ *            irqs left over run before the next bus call
+ */
+uint8_t max30105_trace_irq_handler(max30105_trace_t *trace, uint64_t edge);
+
+/**
+ * @brief     finish a trace
+ * @param[in] *trace pointer to a max30105 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 trace error
+ *            - 2 records left to replay
+ * @note      recording flushes the buffer to output,
+ *            replaying runs the remaining irqs and checks the whole trace was used
+ */
+uint8_t max30105_trace_finish(max30105_trace_t *trace);
+
+/**
+ * @brief     trace iic init
+ * @param[in] *user pointer to a max30105 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+uint8_t max30105_trace_iic_init(void *user);
+
+/**
+ * @brief     trace iic deinit
+ * @param[in] *user pointer to a max30105 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      none
+ */
+uint8_t max30105_trace_iic_deinit(void *user);
+
+/**
+ * @brief      trace iic read
+ * @param[in]  *user pointer to a max30105 trace structure
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t max30105_trace_iic_read(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     trace iic write
+ * @param[in] *user pointer to a max30105 trace structure
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t max30105_trace_iic_write(void *user, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief         trace iic batch transfer
+ * @param[in]     *user pointer to a max30105 trace structure
+ * @param[in]     addr iic device write address
+ * @param[in,out] *transfer pointer to an iic transfer array
+ * @param[in]     num number of transfers
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          only linked when the traced handle has a transfer function
+ */
+uint8_t max30105_trace_iic_transfer(void *user, uint8_t addr, max30105_iic_transfer_t *transfer, uint8_t num);
+
+/**
+ * @brief     trace delay ms
+ * @param[in] *user pointer to a max30105 trace structure
+ * @param[in] ms time
+ * @note      none
+ */
+void max30105_trace_delay_ms(void *user, uint32_t ms);
+
+/**
+ * @brief     trace receive callback
+ * @param[in] *user pointer to a max30105 trace structure
+ * @param[in] type irq type
+ * @note      forwards to the traced callback, not recorded
+ */
+void max30105_trace_receive_callback(void *user, uint8_t type);
+
+/**
+ * @brief     trace timestamp
+ * @param[in] *user pointer to a max30105 trace structure
+ * @return    time in ns
+ * @note      recording reads the clock, replaying returns the time of the last record
+ */
+uint64_t max30105_trace_timestamp(void *user);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
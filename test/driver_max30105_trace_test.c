@@ -0,0 +1,396 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_max30105_trace_test.c
+ * @brief     driver max30105 trace test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-16
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/16  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_max30105_trace_test.h"
+#include "driver_max30105_trace.h"
+#include "driver_max30105_sim.h"
+
+static max30105_handle_t gs_handle;              /**< max30105 handle */
+static max30105_sim_t gs_sim;                    /**< max30105 simulator */
+static max30105_trace_t gs_trace;                /**< max30105 trace */
+static uint8_t gs_record[65536];                 /**< recorded trace */
+static uint8_t gs_copy[65536];                   /**< trace flushed in pieces */
+static uint32_t gs_copy_len;                     /**< flushed length */
+static uint8_t gs_piece[61];                     /**< small record buffer */
+static max30105_sample_t gs_sample[32];          /**< sample buffer */
+static max30105_sample_t gs_session[1024];       /**< recorded session samples */
+static max30105_sample_t gs_replay[1024];        /**< replayed session samples */
+static uint32_t gs_irq[8];                       /**< replayed irq counter */
+
+/**
+ * @brief     simulated timestamp
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @return    virtual time in ns
+ * @note      none
+ */
+static uint64_t a_trace_test_now(void *user)
+{
+    return ((max30105_sim_t *)user)->now;
+}
+
+/**
+ * @brief     replay receive callback
+ * @param[in] type irq type
+ * @note      counts the irq types
+ */
+static void a_trace_test_receive_callback(uint8_t type)
+{
+    if (type < 8)
+    {
+        gs_irq[type]++;
+    }
+}
+
+/**
+ * @brief     collect the flushed trace
+ * @param[in] *user unused
+ * @param[in] *buf pointer to the flushed bytes
+ * @param[in] len number of bytes
+ * @return    status code
+ *            - 0 success
+ *            - 1 no room
+ * @note      none
+ */
+static uint8_t a_trace_test_output(void *user, const uint8_t *buf, uint32_t len)
+{
+    (void)user;
+    if (sizeof(gs_copy) - gs_copy_len < len)
+    {
+        return 1;
+    }
+    memcpy(&gs_copy[gs_copy_len], buf, len);
+    gs_copy_len += len;
+    
+    return 0;
+}
+
+/**
+ * @brief     let the simulator run
+ * @param[in] ms time
+ * @return    status code
+ *            - 0 success
+ *            - 1 irq failed
+ * @note      the INT line runs the traced irq handler with the edge time
+ */
+static uint8_t a_trace_test_run(uint32_t ms)
+{
+    uint32_t i;
+    
+    for (i = 0; i < ms; i++)
+    {
+        max30105_sim_advance(&gs_sim, 1000000ULL);
+        if (max30105_sim_get_interrupt(&gs_sim) != 0)
+        {
+            if (max30105_trace_irq_handler(&gs_trace, gs_sim.now) != 0)
+            {
+                return 1;
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     board delay
+ * @param[in] *user pointer to a max30105 simulator structure
+ * @param[in] ms time
+ * @note      the INT line stays wired to the traced irq handler
+ */
+static void a_trace_test_delay_ms(void *user, uint32_t ms)
+{
+    (void)user;
+    (void)a_trace_test_run(ms);
+}
+
+/**
+ * @brief      run the traced session
+ * @param[in]  record bool value
+ * @param[out] *sample pointer to a sample buffer
+ * @param[out] *count pointer to a sample counter
+ * @param[out] *temp pointer to a temperature buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 session failed
+ * @note       the same driver calls run when recording and replaying,
+ *             the recording lets the simulator run between them and the replay runs the recorded irqs
+ */
+static uint8_t a_trace_test_session(uint8_t record, max30105_sample_t *sample, uint32_t *count, float *temp)
+{
+    uint8_t res;
+    uint8_t len;
+    uint8_t i;
+    uint16_t raw;
+    uint32_t loop;
+    
+    /* init and configure */
+    res = max30105_init(&gs_handle);
+    if (res != 0)
+    {
+        return 1;
+    }
+    res = max30105_set_mode(&gs_handle, MAX30105_MODE_RED_IR);
+    res |= max30105_set_adc_resolution(&gs_handle, MAX30105_ADC_RESOLUTION_18_BIT);
+    res |= max30105_set_particle_sensing_sample_rate(&gs_handle, MAX30105_PARTICLE_SENSING_SAMPLE_RATE_400_HZ);
+    res |= max30105_set_fifo_almost_full(&gs_handle, 0xF);
+    res |= max30105_set_interrupt(&gs_handle, MAX30105_INTERRUPT_FIFO_FULL_EN, MAX30105_BOOL_TRUE);
+    res |= max30105_read_temperature(&gs_handle, &raw, temp);
+    if (res != 0)
+    {
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* read after irregular pauses */
+    *count = 0;
+    for (loop = 0; loop < 40; loop++)
+    {
+        if (record != 0)
+        {
+            res = a_trace_test_run((loop % 7 + 1) * 9);
+        }
+        else
+        {
+            /* the irqs of the pause */
+            res = max30105_trace_irq_handler(&gs_trace, 0);
+        }
+        if (res != 0)
+        {
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        len = 32;
+        res = max30105_read_samples(&gs_handle, gs_sample, &len);
+        if ((res != 0) && (res != 4))
+        {
+            (void)max30105_deinit(&gs_handle);
+            
+            return 1;
+        }
+        for (i = 0; (i < len) && (*count < 1024); i++)
+        {
+            sample[(*count)++] = gs_sample[i];
+        }
+    }
+    
+    return max30105_deinit(&gs_handle);
+}
+
+/**
+ * @brief     compare two sample arrays
+ * @param[in] *a pointer to a sample array
+ * @param[in] *b pointer to a sample array
+ * @param[in] count number of samples
+ * @return    1 if equal, 0 otherwise
+ * @note      none
+ */
+static uint8_t a_trace_test_equal(const max30105_sample_t *a, const max30105_sample_t *b, uint32_t count)
+{
+    uint32_t i;
+    
+    for (i = 0; i < count; i++)
+    {
+        if ((a[i].sequence != b[i].sequence) || (a[i].timestamp != b[i].timestamp) || (a[i].red != b[i].red) ||
+            (a[i].ir != b[i].ir) || (a[i].green != b[i].green) || (a[i].lost != b[i].lost) || (a[i].flags != b[i].flags))
+        {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief     record the session on a fresh simulator
+ * @param[in] *buf pointer to a record buffer
+ * @param[in] size record buffer size
+ * @param[out] *count pointer to a sample counter
+ * @param[out] *temp pointer to a temperature buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 record failed
+ * @note      none
+ */
+static uint8_t a_trace_test_record(uint8_t *buf, uint32_t size, uint32_t *count, float *temp)
+{
+    max30105_sim_init(&gs_sim);
+    gs_sim.byte_time = 22500;
+    max30105_sim_link(&gs_handle, &gs_sim);
+    
+    /* the INT line runs the traced irq handler */
+    gs_sim.irq_handle = NULL;
+    DRIVER_MAX30105_LINK_DELAY_MS_CTX(&gs_handle, a_trace_test_delay_ms);
+    if (max30105_trace_record(&gs_trace, &gs_handle, buf, size, a_trace_test_now) != 0)
+    {
+        max30105_interface_debug_print("max30105: trace record failed.\n");
+        
+        return 1;
+    }
+    if (a_trace_test_session(1, gs_session, count, temp) != 0)
+    {
+        max30105_interface_debug_print("max30105: record session failed.\n");
+        
+        return 1;
+    }
+    if (max30105_trace_finish(&gs_trace) != 0)
+    {
+        max30105_interface_debug_print("max30105: trace finish failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  trace test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   records a session on the simulator and replays it into a fresh handle
+ */
+uint8_t max30105_trace_test(void)
+{
+    uint8_t res;
+    uint32_t count;
+    uint32_t replay_count;
+    uint32_t len;
+    uint32_t records;
+    float temp;
+    float replay_temp;
+    
+    /* start trace test */
+    max30105_interface_debug_print("max30105: start trace test.\n");
+    
+    /* record */
+    max30105_interface_debug_print("max30105: record a session at 400Hz.\n");
+    memset(&gs_trace, 0, sizeof(max30105_trace_t));
+    if (a_trace_test_record(gs_record, sizeof(gs_record), &count, &temp) != 0)
+    {
+        return 1;
+    }
+    len = gs_trace.pos;
+    records = gs_trace.records;
+    if ((count < 400) || (gs_sim.irq_count[MAX30105_INTERRUPT_STATUS_FIFO_FULL] == 0))
+    {
+        max30105_interface_debug_print("max30105: check session error.\n");
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: %d samples and %d irqs in %d records of %d bytes.\n", count,
+                                   gs_sim.irq_count[MAX30105_INTERRUPT_STATUS_FIFO_FULL], records, len);
+    
+    /* replay */
+    max30105_interface_debug_print("max30105: replay the session.\n");
+    DRIVER_MAX30105_LINK_INIT(&gs_handle, max30105_handle_t);
+    DRIVER_MAX30105_LINK_DEBUG_PRINT(&gs_handle, max30105_interface_debug_print);
+    DRIVER_MAX30105_LINK_RECEIVE_CALLBACK(&gs_handle, a_trace_test_receive_callback);
+    memset(gs_irq, 0, sizeof(uint32_t) * 8);
+    if (max30105_trace_replay(&gs_trace, &gs_handle, gs_record, len) != 0)
+    {
+        max30105_interface_debug_print("max30105: trace replay failed.\n");
+        
+        return 1;
+    }
+    res = a_trace_test_session(0, gs_replay, &replay_count, &replay_temp);
+    if ((res != 0) || (max30105_trace_finish(&gs_trace) != 0))
+    {
+        max30105_interface_debug_print("max30105: replay session failed at %d with error %d.\n",
+                                       gs_trace.error_pos, gs_trace.error);
+        
+        return 1;
+    }
+    if ((replay_count != count) || (a_trace_test_equal(gs_session, gs_replay, count) == 0) ||
+        (replay_temp != temp) || (gs_trace.records != records) ||
+        (memcmp(gs_irq, gs_sim.irq_count, sizeof(uint32_t) * 8) != 0))
+    {
+        max30105_interface_debug_print("max30105: check replay error.\n");
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check replay ok.\n");
+    
+    /* a diverging driver */
+    max30105_interface_debug_print("max30105: replay into a diverging session.\n");
+    if (max30105_trace_replay(&gs_trace, &gs_handle, gs_record, len) != 0)
+    {
+        max30105_interface_debug_print("max30105: trace replay failed.\n");
+        
+        return 1;
+    }
+    res = max30105_init(&gs_handle);
+    if (res != 0)
+    {
+        max30105_interface_debug_print("max30105: init failed.\n");
+        
+        return 1;
+    }
+    res = max30105_set_mode(&gs_handle, MAX30105_MODE_RED);
+    if ((res == 0) || (gs_trace.error != MAX30105_TRACE_ERROR_MISMATCH))
+    {
+        max30105_interface_debug_print("max30105: check mismatch error.\n");
+        (void)max30105_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)max30105_deinit(&gs_handle);
+    max30105_interface_debug_print("max30105: mismatch found at byte %d.\n", gs_trace.error_pos);
+    max30105_interface_debug_print("max30105: check mismatch ok.\n");
+    
+    /* the same session flushed in small pieces */
+    max30105_interface_debug_print("max30105: record in %d bytes pieces.\n", (int)sizeof(gs_piece));
+    memset(&gs_trace, 0, sizeof(max30105_trace_t));
+    gs_trace.output = a_trace_test_output;
+    gs_copy_len = 0;
+    if (a_trace_test_record(gs_piece, sizeof(gs_piece), &count, &temp) != 0)
+    {
+        return 1;
+    }
+    if ((gs_copy_len != len) || (memcmp(gs_copy, gs_record, len) != 0))
+    {
+        max30105_interface_debug_print("max30105: check pieces error.\n");
+        
+        return 1;
+    }
+    max30105_interface_debug_print("max30105: check pieces ok.\n");
+    
+    /* finish trace test */
+    max30105_interface_debug_print("max30105: finish trace test.\n");
+    
+    return 0;
+}